@@ -4400,42 +4400,55 @@ static XmitRule	*getXmitRule(AmsSAP *sap, Lyst rules)
 	return NULL;
 }	
 
-static int	receivedMsgAlready(Lyst recipients, int moduleNbr)
+/*	The set of modules that have already been sent a copy of a
+ *	message, so that a module that has subscribed both to the
+ *	message's subject and to ALL_SUBJECTS gets only one copy.
+ *	A module is identified by the number of its unit together
+ *	with its number within that unit's cell.			*/
+
+#define	RECIPIENT_SET_BITS	((MAX_UNIT_NBR + 1) * (MAX_MODULE_NBR + 1))
+
+typedef struct
 {
-	LystElt	elt;
-	long	longModuleNbr = moduleNbr;
-	saddr	temp;
+	unsigned char	bits[(RECIPIENT_SET_BITS + 7) >> 3];
+} RecipientSet;
 
-	for (elt = lyst_first(recipients); elt; elt = lyst_next(elt))
-	{
-		temp = (saddr) lyst_data(elt);
-		if (longModuleNbr == temp)
-		{
-			return 1;
-		}
-	}
+static int	recipientBit(Module *module)
+{
+	return (module->unitNbr * (MAX_MODULE_NBR + 1)) + module->nbr;
+}
 
-	return 0;
+static void	noteRecipient(RecipientSet *recipients, Module *module)
+{
+	int	bit = recipientBit(module);
+
+	recipients->bits[bit >> 3] |= (1 << (bit & 7));
+}
+
+static int	receivedMsgAlready(RecipientSet *recipients, Module *module)
+{
+	int	bit = recipientBit(module);
+
+	return ((recipients->bits[bit >> 3] & (1 << (bit & 7))) != 0);
 }
 
 static int	sendToSubscribers(AmsSAP *sap, Subject *subject,
 			int priority, unsigned char flowLabel, 
 			unsigned char protectedBits, char *amsHeader,
 			int headerLength, char *content, int contentLength,
-	       		Lyst recipients)
+	       		RecipientSet *recipients)
 {
 	LystElt		elt;
 	FanModule	*fan;
 	XmitRule	*rule;
 	int		result;
-	saddr		temp;
 
 	for (elt = lyst_first(subject->modules); elt; elt = lyst_next(elt))
 	{
 		fan = (FanModule *) lyst_data(elt);
 		if (subject->nbr == ALL_SUBJECTS)
 		{
-			if (receivedMsgAlready(recipients, fan->module->nbr))
+			if (receivedMsgAlready(recipients, fan->module))
 			{
 				continue;/*	Don't send 2nd copy.	*/
 			}
@@ -4475,8 +4488,7 @@ static int	sendToSubscribers(AmsSAP *sap, Subject *subject,
 
 		if (subject->nbr != ALL_SUBJECTS)
 		{
-			temp = fan->module->nbr;
-			lyst_insert_last(recipients, (void *) temp);
+			noteRecipient(recipients, fan->module);
 		}
 	}
 
@@ -4491,7 +4503,7 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 	char		amsHeader[16];
 	int		headerLength = sizeof amsHeader;
 	unsigned char	protectedBits;
-	Lyst		recipients;
+	RecipientSet	recipients;
 	int		result;
 
 	CHKERR(sap);
@@ -4511,8 +4523,7 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 	}
 
 	protectedBits = amsHeader[0] & 0xf0;
-	recipients = lyst_create_using(getIonMemoryMgr());
-	CHKERR(recipients);
+	memset((char *) &recipients, 0, sizeof recipients);
 
 	/*	Now send a copy of the message to every subscriber
 	 *	that has posted at least one subscription whose domain
@@ -4520,9 +4531,8 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 
 	if (sendToSubscribers(sap, subject, priority, flowLabel, protectedBits,
 			amsHeader, headerLength, content, contentLength,
-			recipients) < 0)
+			&recipients) < 0)
 	{
-		lyst_destroy(recipients);
 		MRELEASE(content);
 		return -1;
 	}
@@ -4534,8 +4544,7 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 	subject = sap->venture->subjects[ALL_SUBJECTS];
 	result = sendToSubscribers(sap, subject, priority, flowLabel,
 			protectedBits, amsHeader, headerLength, content,
-			contentLength, recipients);
-	lyst_destroy(recipients);
+			contentLength, &recipients);
 	MRELEASE(content);
 	return result;
 }
@@ -5788,10 +5797,9 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	int		headerLength = sizeof amsHeader;
 	int		result;
 	unsigned char	protectedBits;
-	Lyst		recipients;
+	RecipientSet	recipients;
 	LystElt		elt;
 	FanModule	*fan;
-	saddr		temp;
 	XmitRule	*rule;
 
 	if (continuumNbr == THIS_CONTINUUM)
@@ -5851,8 +5859,7 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	 *	message space now.					*/
 
 	protectedBits = amsHeader[0] & 0xf0;
-	recipients = lyst_create_using(getIonMemoryMgr());
-	CHKERR(recipients);
+	memset((char *) &recipients, 0, sizeof recipients);
 
 	/*	First send a copy of the message to every module in the
 	 *	domain of this request that has posted at least one
@@ -5908,13 +5915,11 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 				content, contentLength);
 		if (result < 0)
 		{
-			lyst_destroy(recipients);
 			MRELEASE(content);
 			return result;
 		}
 
-		temp = fan->module->nbr;
-		lyst_insert_last(recipients, (void *) temp);
+		noteRecipient(&recipients, fan->module);
 	}
 
 	/*	Now send a copy of the message to every module in the
@@ -5930,7 +5935,7 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	for (elt = lyst_first(subject->modules); elt; elt = lyst_next(elt))
 	{
 		fan = (FanModule *) lyst_data(elt);
-		if (receivedMsgAlready(recipients, fan->module->nbr))
+		if (receivedMsgAlready(&recipients, fan->module))
 		{
 			continue;	/*	Don't send 2nd copy.	*/
 		}
@@ -5977,13 +5982,11 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 				content, contentLength);
 		if (result < 0)
 		{
-			lyst_destroy(recipients);
 			MRELEASE(content);
 			return result;
 		}
 	}
 
-	lyst_destroy(recipients);
 	MRELEASE(content);
 	return 0;
 }
@@ -1712,7 +1712,6 @@ static int	tryRoute(CgrRoute *route, time_t currentTime, Bundle *bundle,
 {
 	Sdr		sdr = getIonsdr();
 	PsmPartition	wm = getIonwm();
-	char		eid[SDRSTRING_BUFSZ];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 	Object		planObj;
@@ -1721,9 +1720,7 @@ static int	tryRoute(CgrRoute *route, time_t currentTime, Bundle *bundle,
 	LystElt		candidateElt;
 	CgrRoute	*candidateRoute;
 
-	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0",
-			route->toNodeNbr);
-	findPlan(eid, &vplan, &vplanElt);
+	findIpnPlan(route->toNodeNbr, &vplan, &vplanElt);
 	if (vplanElt == 0)
 	{
 		TRACE(CgrExcludeRoute, CgrNoPlan);
@@ -446,7 +446,7 @@ int	main(int argc, char *argv[])
 			continue;	/*	Get the next one.	*/
 		}
 
-		CHKZERO(sdr_begin_xn(sdr));
+		CHKZERO(sdr_begin_read_xn(sdr));
 		bundleLength = zco_length(sdr, bundleZco);
 		sdr_exit_xn(sdr);
 
@@ -111,7 +111,6 @@ static int	applyRoutingOverride(Bundle *bundle, Object bundleObj,
 	Sdr		sdr = getIonsdr();
 	Object		addr;
 			OBJ_POINTER(IpnOverride, ovrd);
-	char		eid[MAX_EID_LEN + 1];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 	BpPlan		plan;
@@ -139,8 +138,7 @@ static int	applyRoutingOverride(Bundle *bundle, Object bundleObj,
 
 	/*	Must forward to override neighbor.			*/
 
-	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0", ovrd->neighbor);
-	findPlan(eid, &vplan, &vplanElt);
+	findIpnPlan(ovrd->neighbor, &vplan, &vplanElt);
 	if (vplanElt == 0)	/*	Not a usable override.		*/
 	{
 		return 0;
@@ -419,7 +417,6 @@ static int	enqueueToEntryNode(CgrRoute *route, Bundle *bundle,
 	PsmAddress	embElt;
 	Embargo		*embargo;
 	BpEvent		event;
-	char		neighborEid[MAX_EID_LEN + 1];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 	int		priority;
@@ -531,9 +528,7 @@ static int	enqueueToEntryNode(CgrRoute *route, Bundle *bundle,
 	 *	be in the list of best routes), the bundle can't go
 	 *	into limbo at this point.				*/
 
-	isprintf(neighborEid, sizeof neighborEid, "ipn:" UVAST_FIELDSPEC ".0",
-			route->toNodeNbr);
-	findPlan(neighborEid, &vplan, &vplanElt);
+	findIpnPlan(route->toNodeNbr, &vplan, &vplanElt);
 	CHKERR(vplanElt);
 	if (bpEnqueue(vplan, bundle, bundleObj) < 0)
 	{
@@ -1138,13 +1133,11 @@ static int	enqueueToNeighbor(Bundle *bundle, Object bundleObj,
 			uvast nodeNbr)
 {
 	Sdr		sdr = getIonsdr();
-	char		eid[MAX_EID_LEN + 1];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 	BpPlan		plan;
 
-	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0", nodeNbr);
-	findPlan(eid, &vplan, &vplanElt);
+	findIpnPlan(nodeNbr, &vplan, &vplanElt);
 	if (vplanElt == 0)
 	{
 		return 0;
@@ -1376,7 +1369,7 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
-	CHKZERO(sdr_begin_xn(sdr));
+	CHKZERO(sdr_begin_read_xn(sdr));
 	sdr_read(sdr, (char *) &scheme, sdr_list_data(sdr,
 			vscheme->schemeElt), sizeof(Scheme));
 	sdr_exit_xn(sdr);
@@ -871,6 +871,8 @@ typedef struct
 
 	PsmAddress	schemes;	/*	SM list: VScheme.	*/
 	PsmAddress	plans;		/*	SM list: VPlan.		*/
+	PsmAddress	planIndex;	/*	SM RB tree: plan elts.	*/
+	PsmAddress	ipnPlanIndex;	/*	SM RB tree: plan elts.	*/
 	PsmAddress	inducts;	/*	SM list: VInduct.	*/
 	PsmAddress	outducts;	/*	SM list: VOutduct.	*/
 	PsmAddress	discoveries;	/*	SM list: Discovery.	*/
@@ -1437,6 +1439,8 @@ extern void		lookUpEndpoint(EndpointId eid, char *dictionary,
 				VScheme *vscheme, VEndpoint **vpoint);
 
 extern void		findPlan(char *eid, VPlan **vplan, PsmAddress *elt);
+extern void		findIpnPlan(uvast nodeNbr, VPlan **vplan,
+				PsmAddress *elt);
 
 extern int		addPlan(char *eid, unsigned int nominalRate);
 extern int		updatePlan(char *eid, unsigned int nominalRate);
@@ -223,6 +223,7 @@ static int	noteContactAcquired(uvast discoveryNodeNbr,
 		neighbor->xmitRate = xmitRate;
 		toggleScheduledContacts(ownNodeNbr, discoveryNodeNbr,
 				CtScheduled, CtSuppressed);
+		rfx_contacts_revised();
 		CHKERR(sdr_end_xn(sdr) == 0);
 	}
 
@@ -276,6 +277,7 @@ static int	noteContactAcquired(uvast discoveryNodeNbr,
 		neighbor->recvRate = recvRate;
 		toggleScheduledContacts(discoveryNodeNbr, ownNodeNbr,
 				CtScheduled, CtSuppressed);
+		rfx_contacts_revised();
 		CHKERR(sdr_end_xn(sdr) == 0);
 	}
 
@@ -576,6 +578,7 @@ static int	noteContactLost(uvast discoveryNodeNbr, time_t startTime)
 			neighbor->xmitRate = 0;
 			toggleScheduledContacts(ownNodeNbr, discoveryNodeNbr,
 					CtSuppressed, CtScheduled);
+			rfx_contacts_revised();
 			CHKERR(sdr_end_xn(sdr) == 0);
 		}
 	}
@@ -631,6 +634,7 @@ static int	noteContactLost(uvast discoveryNodeNbr, time_t startTime)
 			neighbor->recvRate = 0;
 			toggleScheduledContacts(discoveryNodeNbr, ownNodeNbr,
 					CtSuppressed, CtScheduled);
+			rfx_contacts_revised();
 			CHKERR(sdr_end_xn(sdr) == 0);
 		}
 	}
@@ -988,34 +988,75 @@ static void	resetPlan(VPlan *vplan)
 	vplan->clmPid = ERROR;
 }
 
+/*	The VPlans in the volatile database are indexed by two
+ *	red-black trees.  The nodes of both trees have as their data
+ *	the addresses of the elements of the bpvdb->plans list that
+ *	reference the VPlans.  planIndex is ordered by neighbor EID
+ *	and contains all plans; ipnPlanIndex is ordered by neighbor
+ *	node number and contains only the plans whose neighbor EIDs
+ *	are of the form "ipn:<node number>.0".				*/
+
+static int	orderPlansByEid(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	VPlan	*vplan;
+
+	vplan = (VPlan *) psp(partition, sm_list_data(partition, nodeData));
+	return strcmp(vplan->neighborEid, (char *) dataBuffer);
+}
+
+static int	orderPlansByNodeNbr(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	VPlan	*vplan;
+	uvast	nodeNbr = *((uvast *) dataBuffer);
+
+	vplan = (VPlan *) psp(partition, sm_list_data(partition, nodeData));
+	if (vplan->neighborNodeNbr < nodeNbr)
+	{
+		return -1;
+	}
+
+	if (vplan->neighborNodeNbr > nodeNbr)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static int	isIpnNodePlan(VPlan *vplan)
+{
+	char	eid[MAX_EID_LEN + 1];
+
+	if (vplan->neighborNodeNbr == 0)
+	{
+		return 0;
+	}
+
+	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0",
+			vplan->neighborNodeNbr);
+	return (strcmp(vplan->neighborEid, eid) == 0);
+}
+
 static int	raisePlan(Object planElt, BpVdb *bpvdb)
 {
 	Sdr		bpSdr = getIonsdr();
 	PsmPartition	bpwm = getIonwm();
 	Object		planObj;
 	BpPlan		plan;
+	PsmAddress	node;
+	PsmAddress	successor;
 	PsmAddress	elt;
 	VPlan		*vplan;
-	int		result;
 	PsmAddress	addr;
 
 	planObj = sdr_list_data(bpSdr, planElt);
 	sdr_read(bpSdr, (char *) &plan, planObj, sizeof(BpPlan));
-	for (elt = sm_list_first(bpwm, bpvdb->plans); elt;
-			elt = sm_list_next(bpwm, elt))
+	node = sm_rbt_search(bpwm, bpvdb->planIndex, orderPlansByEid,
+			plan.neighborEid, &successor);
+	if (node)
 	{
-		vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, elt));
-		result = strcmp(vplan->neighborEid, plan.neighborEid);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)		/*	Insert before this one.	*/
-		{
-			break;		/*	Same as end of list.	*/
-		}
-
 		return 0;		/*	Already raised.		*/
 	}
 
@@ -1025,9 +1066,14 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 		return -1;
 	}
 
-	if (elt)
+	/*	The plans list is kept in EID order, so insert the
+	 *	new plan before the plan whose EID is its successor
+	 *	in the index, if any.					*/
+
+	if (successor)
 	{
-		elt = sm_list_insert_before(bpwm, elt, addr);
+		elt = sm_list_insert_before(bpwm, sm_rbt_data(bpwm, successor),
+				addr);
 	}
 	else
 	{
@@ -1047,6 +1093,28 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 	vplan->updateStats = plan.updateStats;
 	istrcpy(vplan->neighborEid, plan.neighborEid, sizeof plan.neighborEid);
 	vplan->neighborNodeNbr = plan.neighborNodeNbr;
+	if (sm_rbt_insert(bpwm, bpvdb->planIndex, elt, orderPlansByEid,
+			vplan->neighborEid) == 0)
+	{
+		oK(sm_list_delete(bpwm, elt, NULL, NULL));
+		psm_free(bpwm, addr);
+		return -1;
+	}
+
+	if (isIpnNodePlan(vplan))
+	{
+		if (sm_rbt_insert(bpwm, bpvdb->ipnPlanIndex, elt,
+				orderPlansByNodeNbr,
+				&(vplan->neighborNodeNbr)) == 0)
+		{
+			sm_rbt_delete(bpwm, bpvdb->planIndex, orderPlansByEid,
+					vplan->neighborEid, NULL, NULL);
+			oK(sm_list_delete(bpwm, elt, NULL, NULL));
+			psm_free(bpwm, addr);
+			return -1;
+		}
+	}
+
 	vplan->semaphore = SM_SEM_NONE;
 	vplan->xmitThrottle.nominalRate = plan.nominalRate;
 	vplan->xmitThrottle.capacity = plan.nominalRate;
@@ -1057,9 +1125,18 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 static void	dropPlan(VPlan *vplan, PsmAddress vplanElt)
 {
 	PsmPartition	bpwm = getIonwm();
+	BpVdb		*bpvdb = _bpvdb(NULL);
 	PsmAddress	vplanAddr;
 
 	vplanAddr = sm_list_data(bpwm, vplanElt);
+	if (isIpnNodePlan(vplan))
+	{
+		sm_rbt_delete(bpwm, bpvdb->ipnPlanIndex, orderPlansByNodeNbr,
+				&(vplan->neighborNodeNbr), NULL, NULL);
+	}
+
+	sm_rbt_delete(bpwm, bpvdb->planIndex, orderPlansByEid,
+			vplan->neighborEid, NULL, NULL);
 	if (vplan->semaphore != SM_SEM_NONE)
 	{
 		sm_SemEnd(vplan->semaphore);
@@ -1513,6 +1590,8 @@ static BpVdb	*_bpvdb(char **name)
 		vdb->watching = db->watching;
 		if ((vdb->schemes = sm_list_create(wm)) == 0
 		|| (vdb->plans = sm_list_create(wm)) == 0
+		|| (vdb->planIndex = sm_rbt_create(wm)) == 0
+		|| (vdb->ipnPlanIndex = sm_rbt_create(wm)) == 0
 		|| (vdb->inducts = sm_list_create(wm)) == 0
 		|| (vdb->outducts = sm_list_create(wm)) == 0
 		|| (vdb->discoveries = sm_list_create(wm)) == 0
@@ -1768,6 +1847,8 @@ static void	dropVdb(PsmPartition wm, PsmAddress vdbAddress)
 	}
 
 	sm_list_destroy(wm, vdb->plans, NULL, NULL);
+	sm_rbt_destroy(wm, vdb->planIndex, NULL, NULL);
+	sm_rbt_destroy(wm, vdb->ipnPlanIndex, NULL, NULL);
 	while ((elt = sm_list_first(wm, vdb->inducts)) != 0)
 	{
 		vinduct = (VInduct *) psp(wm, sm_list_data(wm, elt));
@@ -3873,8 +3954,7 @@ void	findPlan(char *eidIn, VPlan **vplan, PsmAddress *vplanElt)
 {
 	PsmPartition	bpwm = getIonwm();
 	char		eid[SDRSTRING_BUFSZ];
-	PsmAddress	elt;
-	int		result;
+	PsmAddress	node;
 
 	CHKVOID(vplanElt);
 	*vplanElt = 0;			/*	Default.		*/
@@ -3887,29 +3967,41 @@ void	findPlan(char *eidIn, VPlan **vplan, PsmAddress *vplanElt)
 
 	/*	This function locates the volatile egress plan
 	 *	object identified by the specified endpoint ID,
-	 *	if any; must be an exact match.  (Note that BpPlans
-	 *	are *not* ordered alphabetically by EID; only the
-	 *	VPlans in the volatile database are.)			*/
+	 *	if any; must be an exact match.				*/
 
-	for (elt = sm_list_first(bpwm, (_bpvdb(NULL))->plans); elt;
-			elt = sm_list_next(bpwm, elt))
+	node = sm_rbt_search(bpwm, (_bpvdb(NULL))->planIndex,
+			orderPlansByEid, eid, NULL);
+	if (node)
 	{
-		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, elt));
-		result = strcmp((*vplan)->neighborEid, eid);
-		if (result < 0)
-		{
-			continue;
-		}
+		*vplanElt = sm_rbt_data(bpwm, node);
+		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, *vplanElt));
+	}
+}
 
-		if (result == 0)	/*	Found matching plan.	*/
-		{
-			*vplanElt = elt;
-		}
+void	findIpnPlan(uvast nodeNbr, VPlan **vplan, PsmAddress *vplanElt)
+{
+	PsmPartition	bpwm = getIonwm();
+	PsmAddress	node;
 
-		/*	One way or another, the search is now done.	*/
+	/*	This function locates the volatile egress plan
+	 *	object whose neighbor EID is "ipn:<nodeNbr>.0", if
+	 *	any, without formatting that EID string.		*/
 
+	CHKVOID(vplanElt);
+	*vplanElt = 0;			/*	Default.		*/
+	CHKVOID(vplan);
+	if (nodeNbr == 0)
+	{
 		return;
 	}
+
+	node = sm_rbt_search(bpwm, (_bpvdb(NULL))->ipnPlanIndex,
+			orderPlansByNodeNbr, &nodeNbr, NULL);
+	if (node)
+	{
+		*vplanElt = sm_rbt_data(bpwm, node);
+		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, *vplanElt));
+	}
 }
 
 int	addPlan(char *eidIn, unsigned int nominalRate)
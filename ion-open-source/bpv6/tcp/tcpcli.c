@@ -846,12 +846,14 @@ static int	sendBundleByTcpcl(SenderThreadParms *stp, Object bundleZco)
 	uvast		bytesRemaining;
 	int		flags;
 	ZcoReader	reader;
+	ZcoSpan		span;
 	uvast		bytesToLoad;
-	uvast		bytesToSend;
+	vast		bytesToSend;
 	int		firstByte;
 	Sdnv		segLengthSdnv;
 	char		segHeader[4];
 	int		segHeaderLen;
+	int		result;
 
 	if (session->sock == -1)
 	{
@@ -890,36 +892,62 @@ pipeline.", session->outductName);
 		{
 			bytesToLoad = TCPCL_BUFSZ;
 		}
-		else
-		{
-			flags |= 0x01;		/*	Last segment.	*/
-		}
+
+		/*	Each segment is either copied into the buffer
+		 *	or, if it resides in a file, sent from the file.	*/
 
 		CHKERR(sdr_begin_xn(sdr));
-		bytesToSend = zco_transmit(sdr, &reader, bytesToLoad,
-				stp->buffer);
-		if (sdr_end_xn(sdr) < 0 || bytesToSend != bytesToLoad)
+		bytesToSend = zco_transmit_span(sdr, &reader, bytesToLoad,
+				stp->buffer, &span);
+		if (sdr_end_xn(sdr) < 0 || bytesToSend <= 0)
 		{
+			if (span.fd >= 0)
+			{
+				close(span.fd);
+			}
+
 			putErrmsg("Incomplete zco_transmit.",
 					session->outductName);
 			return -1;
 		}
 
+		if (bytesToSend == bytesRemaining)
+		{
+			flags |= 0x01;		/*	Last segment.	*/
+		}
+
 		firstByte = 0x10 | flags;
 		segHeader[0] = firstByte;
-		encodeSdnv(&segLengthSdnv, bytesToLoad);
+		encodeSdnv(&segLengthSdnv, bytesToSend);
 		memcpy(segHeader + 1, segLengthSdnv.text, segLengthSdnv.length);
 		segHeaderLen = 1 + segLengthSdnv.length;
 		pthread_mutex_lock(&(session->socketMutex));
 		if (itcp_send(&(session->sock), segHeader, segHeaderLen) < 1)
 		{
 			pthread_mutex_unlock(&(session->socketMutex));
+			if (span.fd >= 0)
+			{
+				close(span.fd);
+			}
+
 			writeMemoNote("[?] tcpcl session lost (seg header)",
 					neighbor->vplan->neighborEid);
 			return 0;
 		}
 
-		if (itcp_send(&(session->sock), stp->buffer, bytesToSend) < 1)
+		if (span.fd >= 0)
+		{
+			result = itcp_sendfile(&(session->sock), span.fd,
+					span.offset, bytesToSend);
+			close(span.fd);
+		}
+		else
+		{
+			result = itcp_send(&(session->sock), stp->buffer,
+					bytesToSend);
+		}
+
+		if (result < 1)
 		{
 			pthread_mutex_unlock(&(session->socketMutex));
 			writeMemoNote("[?] tcpcl session lost (seg content)",
@@ -197,7 +197,7 @@ node's host name> | @} [:<its port number>]");
 			continue;	/*	Get next bundle.	*/
 		}
 
-		CHKZERO(sdr_begin_xn(sdr));
+		CHKZERO(sdr_begin_read_xn(sdr));
 		bundleLength = zco_length(sdr, bundleZco);
 		sdr_exit_xn(sdr);
 		bytesSent = sendBundleByUDP(&socketName, &ductSocket,
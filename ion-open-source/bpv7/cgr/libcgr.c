@@ -21,17 +21,111 @@
 
 #define CGRVDB_NAME	"cgrvdb"
 
+/*	Number of threads that concurrently compute the spur routes
+ *	branching off a selected route; zero for serial computation.	*/
+
+#ifndef CGR_SPUR_WORKERS
+#define	CGR_SPUR_WORKERS	(0)
+#endif
+
+/*	Nonzero to cache forwarding decisions in routing objects;
+ *	build with -DCGR_ROUTE_CACHE=0 to select a route afresh
+ *	for every bundle.						*/
+
+#ifndef CGR_ROUTE_CACHE
+#define	CGR_ROUTE_CACHE		(1)
+#endif
+
 typedef struct
 {
 	/*	Working values, reset for each Dijkstra run.		*/
 
-	IonCXref	*predecessor;	/*	On path to destination.	*/
+	int		predecessor;	/*	Vertex index, or -1.	*/
 	time_t		arrivalTime;	/*	As from time(2).	*/
 	unsigned int	hopCount;
 	int		visited;	/*	Boolean.		*/
 	int		suppressed;	/*	Boolean.		*/
+	unsigned int	epoch;		/*	When values were reset.	*/
 } CgrContactNote;	/*	IonCXref routingObject is one of these.	*/
 
+/*	The Dijkstra search's priority queue: a binary min-heap of
+ *	contact graph vertices keyed by arrival time, then hop count,
+ *	then vertex index, i.e., the contact's position in the contact
+ *	index (so ties are broken exactly as by a scan of the index).  A contact is inserted
+ *	again whenever its arrival time improves; superseded entries
+ *	are discarded as they reach the top of the heap.		*/
+
+#define	CGR_HEAP_INITIAL_SIZE	(256)
+
+typedef struct
+{
+	int		vertex;
+	time_t		arrivalTime;
+	unsigned int	hopCount;
+} CgrHeapEntry;
+
+typedef struct
+{
+	CgrHeapEntry	*entries;
+	int		length;
+	int		capacity;
+} CgrHeap;
+
+/*	The work areas of a Dijkstra search are either the contacts'
+ *	own CgrContactNotes, which are shared by every process that
+ *	computes routes on this node, or else a private array of
+ *	CgrContactNotes indexed by vertex, as used by a spur worker
+ *	thread.  Either way, a note's values are reset on its first
+ *	reference in each new epoch.					*/
+
+typedef struct
+{
+	CgrContactNote	*notes;		/*	NULL: use contacts'.	*/
+	unsigned int	epoch;
+	CgrHeap		heap;
+} CgrWorkAreas;
+
+/*	A CgrSearchContext is the read-only state shared by all of
+ *	the Dijkstra searches performed in computing a single route
+ *	or a single set of spur routes.					*/
+
+typedef struct
+{
+	IonCGraph	*graph;
+	IonCVertex	*vertices;
+	IonCRow		*rows;
+	int		vertexCount;
+	uvast		ownNodeNbr;
+	int		ownRow;		/*	Row index, or -1.	*/
+	uvast		terminusNodeNbr;
+	time_t		currentTime;
+} CgrSearchContext;
+
+/*	A CgrSearch is a single Dijkstra search, either from the root
+ *	of the contact graph or from the root of a spur, with all
+ *	contacts on the spur's root path suppressed and the edges
+ *	that would duplicate selected routes excluded, together with
+ *	the path that the search found.					*/
+
+typedef struct
+{
+	PsmAddress	rootOfSpur;	/*	An SmListElt in hops.	*/
+	int		root;		/*	Vertex index, or -1.	*/
+	time_t		rootArrivalTime;
+	unsigned int	rootHopCount;
+	int		*suppressed;	/*	Vertex indices.		*/
+	int		suppressedCount;
+	int		*excluded;	/*	Vertex indices.		*/
+	int		excludedCount;
+
+	/*	Results of the search.					*/
+
+	int		failed;		/*	Boolean.		*/
+	time_t		arrivalTime;
+	int		*path;		/*	Vertex indices.		*/
+	int		pathLength;
+} CgrSearch;
+
 /*		Functions for managing the CGR database.		*/
 
 static void	removeRoute(PsmPartition ionwm, PsmAddress routeElt)
@@ -149,6 +243,11 @@ static void	discardRouteList(PsmPartition ionwm, PsmAddress routes)
 	sm_list_destroy(ionwm, routes, NULL, NULL);
 }
 
+static void	eraseDecision(PsmPartition ionwm, PsmAddress elt, void *arg)
+{
+	psm_free(ionwm, sm_list_data(ionwm, elt));
+}
+
 static void	detachRoutingObject(PsmPartition ionwm,
 			CgrRtgObject *routingObject)
 {
@@ -182,6 +281,12 @@ static void	detachRoutingObject(PsmPartition ionwm,
 		sm_list_destroy(ionwm, routingObject->viaPassageways, NULL,
 				NULL);
 	}
+
+	if (routingObject->decisions)
+	{
+		sm_list_destroy(ionwm, routingObject->decisions, eraseDecision,
+				NULL);
+	}
 }
 
 void	cgr_clear_vdb(CgrVdb *vdb)
@@ -236,6 +341,27 @@ static int	disabledRoute(PsmPartition ionwm, PsmAddress routeElt,
 	return 0;
 }
 
+static void	expireWorkAreas(PsmPartition ionwm)
+{
+	IonVdb		*ionvdb = getIonVdb();
+	PsmAddress	elt;
+	IonCXref	*contact;
+
+	/*	Mark all contact work areas stale: epoch zero is
+	 *	never current.						*/
+
+	for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
+		if (contact->routingObject)
+		{
+			((CgrContactNote *) psp(ionwm,
+					contact->routingObject))->epoch = 0;
+		}
+	}
+}
+
 CgrVdb	*cgr_get_vdb()
 {
 	static char	*name = CGRVDB_NAME;
@@ -273,6 +399,11 @@ CgrVdb	*cgr_get_vdb()
 
 	vdb = (CgrVdb *) psp(ionwm, vdbAddress);
 	memset((char *) vdb, 0, sizeof(CgrVdb));
+
+	/*	Contact work areas may survive a prior CGR volatile
+	 *	database, so their epochs can't be trusted.		*/
+
+	expireWorkAreas(ionwm);
 	if ((vdb->routingObjects = sm_list_create(ionwm)) == 0
 	|| psm_catlg(ionwm, name, vdbAddress) < 0)
 	{
@@ -340,7 +471,18 @@ static int	getApplicableRange(IonCXref *contact, unsigned int *owlt)
 	return -1;
 }
 
-static CgrContactNote	*getWorkArea(PsmPartition ionwm, IonCXref *contact)
+static void	resetWorkArea(CgrContactNote *work, unsigned int epoch)
+{
+	work->predecessor = -1;
+	work->arrivalTime = MAX_TIME;
+	work->hopCount = 0;
+	work->visited = 0;
+	work->suppressed = 0;
+	work->epoch = epoch;
+}
+
+static CgrContactNote	*getWorkArea(PsmPartition ionwm, unsigned int epoch,
+				IonCXref *contact)
 {
 	CgrContactNote	*work;
 
@@ -361,93 +503,338 @@ static CgrContactNote	*getWorkArea(PsmPartition ionwm, IonCXref *contact)
 		work = (CgrContactNote *) psp(ionwm, contact->routingObject);
 	}
 
+	/*	The epoch is the CGR volatile database's workEpoch,
+	 *	which is shared by every process that computes routes
+	 *	on this node, as are the work areas themselves.		*/
+
+	if (work->epoch != epoch)
+	{
+		/*	First reference to this work area in the
+		 *	current Dijkstra search; reset its values.	*/
+
+		resetWorkArea(work, epoch);
+	}
+
 	return work;
 }
 
-static int	clearWorkAreas(IonCXref *rootContact)
+static int	beginWorkEpoch()
 {
 	PsmPartition	ionwm = getIonwm();
-	IonVdb		*ionvdb = getIonVdb();
+	CgrVdb		*cgrvdb = cgr_get_vdb();
+
+	CHKERR(cgrvdb);
+	cgrvdb->workEpoch++;
+	if (cgrvdb->workEpoch == 0)
+	{
+		/*	Epoch number has wrapped around, so stale work
+		 *	areas might now look current.			*/
+
+		cgrvdb->workEpoch = 1;
+		expireWorkAreas(ionwm);
+	}
+
+	return 0;
+}
+
+static unsigned int	marginalOwlt(unsigned int owlt)
+{
+	/*	Allow for possible additional latency due to the
+	 *	movement of the receiving node during the propagation
+	 *	of signal from the sending node.			*/
+
+	return owlt + (((MAX_SPEED_MPH / 3600) * owlt) / 186282);
+}
+
+static void	getRootArrival(PsmPartition ionwm, PsmAddress rootOfSpur,
+			time_t currentTime, time_t *arrivalTime,
+			unsigned int *hopCount)
+{
 	PsmAddress	elt;
 	IonCXref	*contact;
-	CgrContactNote	*work;
+	unsigned int	owlt;
 
-	for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex); elt;
-			elt = sm_rbt_next(ionwm, elt))
+	/*	Compute best-case arrival time at the end of the root
+	 *	path of a spur, i.e., at the receiving node of the
+	 *	spur's root contact, exactly as Dijkstra's Algorithm
+	 *	would have computed it along that path.  Yen's
+	 *	algorithm searches for each spur from the end of its
+	 *	root path, so the spur search must begin at this
+	 *	time rather than at whatever arrival time some other
+	 *	search noted for the root contact.			*/
+
+	*arrivalTime = currentTime;
+	*hopCount = 0;
+	for (elt = sm_list_first(ionwm, sm_list_list(ionwm, rootOfSpur));
+			elt; elt = sm_list_next(ionwm, elt))
 	{
-		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
-		CHKERR(work = getWorkArea(ionwm, contact));
-		work->predecessor = NULL;
-		work->visited = 0;
-		work->suppressed = 0;
+		contact = (IonCXref *) psp(ionwm, sm_list_data(ionwm, elt));
+		if (contact->fromTime > *arrivalTime)
+		{
+			*arrivalTime = contact->fromTime;
+		}
+
+		if (getApplicableRange(contact, &owlt) == 0)
+		{
+			*arrivalTime += marginalOwlt(owlt);
+		}
+
+		*hopCount += 1;
+		if (elt == rootOfSpur)
+		{
+			break;
+		}
+	}
+}
+
+static PsmAddress	citeContact(PsmPartition ionwm, CgrRoute *route,
+				IonCXref *contact)
+{
+	PsmAddress	citation;
+
+	/*	Content of citation (which is a list element) is the
+	 *	address of the contact that is this hop of this route.
+	 *
+	 *	Content of new member of contact's citations list is
+	 *	the address of this list element.			*/
+
+	citation = sm_list_insert_first(ionwm, route->hops,
+			psa(ionwm, contact));
+	if (citation == 0)
+	{
+		putErrmsg("Can't insert contact into route.", NULL);
+		return 0;
+	}
+
+	if (contact->citations == 0)
+	{
+		contact->citations = sm_list_create(ionwm);
+		if (contact->citations == 0)
+		{
+			putErrmsg("Can't create citation list.", NULL);
+			return 0;
+		}
+	}
+
+	if (sm_list_insert_last(ionwm, contact->citations, citation) == 0)
+	{
+		putErrmsg("Can't insert contact into route.", NULL);
+		return 0;
+	}
+
+	return citation;
+}
+
+static int	heapPrecedes(CgrHeapEntry *a, CgrHeapEntry *b)
+{
+	if (a->arrivalTime != b->arrivalTime)
+	{
+		return (a->arrivalTime < b->arrivalTime);
+	}
+
+	if (a->hopCount != b->hopCount)
+	{
+		return (a->hopCount < b->hopCount);
+	}
+
+	return (a->vertex < b->vertex);
+}
+
+static int	heapInsert(CgrHeap *heap, int vertex, CgrContactNote *work)
+{
+	CgrHeapEntry	*entries;
+	CgrHeapEntry	entry;
+	int		capacity;
+	int		i;
+	int		parent;
+
+	if (heap->length == heap->capacity)
+	{
+		capacity = heap->capacity ? heap->capacity * 2
+				: CGR_HEAP_INITIAL_SIZE;
+		entries = (CgrHeapEntry *) MTAKE(capacity
+				* sizeof(CgrHeapEntry));
+		if (entries == NULL)
+		{
+			putErrmsg("Can't expand CGR heap.", NULL);
+			return -1;
+		}
+
+		if (heap->entries)
+		{
+			memcpy((char *) entries, (char *) heap->entries,
+					heap->length * sizeof(CgrHeapEntry));
+			MRELEASE(heap->entries);
+		}
 
-		/*	Reset arrival time, except preserve arrival
-		 *	time of root contact.				*/
+		heap->entries = entries;
+		heap->capacity = capacity;
+	}
 
-		if (contact != rootContact)
+	entry.vertex = vertex;
+	entry.arrivalTime = work->arrivalTime;
+	entry.hopCount = work->hopCount;
+	for (i = heap->length; i > 0; i = parent)
+	{
+		parent = (i - 1) / 2;
+		if (!heapPrecedes(&entry, heap->entries + parent))
 		{
-			work->arrivalTime = MAX_TIME;
-			work->hopCount = 0;
+			break;
 		}
+
+		heap->entries[i] = heap->entries[parent];
 	}
 
+	heap->entries[i] = entry;
+	heap->length++;
 	return 0;
 }
 
-static int	edgeIsExcluded(PsmPartition ionwm, PsmAddress excludedEdges,
-			PsmAddress contactAddr)
+static void	heapRemoveFirst(CgrHeap *heap, CgrHeapEntry *first)
 {
-	PsmAddress	elt;
+	CgrHeapEntry	last;
+	int		i;
+	int		child;
 
-	if (excludedEdges)
+	*first = heap->entries[0];
+	heap->length--;
+	last = heap->entries[heap->length];
+	for (i = 0; (child = (2 * i) + 1) < heap->length; i = child)
 	{
-		for (elt = sm_list_first(ionwm, excludedEdges); elt;
-				elt = sm_list_next(ionwm, elt))
+		if (child + 1 < heap->length
+		&& heapPrecedes(heap->entries + child + 1,
+				heap->entries + child))
 		{
-			if (sm_list_data(ionwm, elt) == contactAddr)
-			{
-				return 1;
-			}
+			child++;
 		}
+
+		if (!heapPrecedes(heap->entries + child, &last))
+		{
+			break;
+		}
+
+		heap->entries[i] = heap->entries[child];
+	}
+
+	heap->entries[i] = last;
+}
+
+/*	Functions for searching the contact graph.			*/
+
+static int	loadSearchContext(PsmPartition ionwm,
+			CgrSearchContext *context, IonNode *terminusNode,
+			time_t currentTime)
+{
+	memset((char *) context, 0, sizeof(CgrSearchContext));
+	context->graph = rfx_contact_graph();
+	if (context->graph == NULL)
+	{
+		putErrmsg("Can't load contact graph.", NULL);
+		return -1;
 	}
 
+	context->vertexCount = context->graph->vertexCount;
+	context->vertices = (IonCVertex *) psp(ionwm,
+			context->graph->vertices);
+	context->rows = (IonCRow *) psp(ionwm, context->graph->rows);
+	context->ownNodeNbr = getOwnNodeNbr();
+	context->ownRow = rfx_graph_row(context->graph, context->ownNodeNbr);
+	context->terminusNodeNbr = terminusNode->nodeNbr;
+	context->currentTime = currentTime;
 	return 0;
 }
 
-static int	computeDistanceToTerminus(IonCXref *rootContact,
-			CgrContactNote *rootWork, IonNode *terminusNode,
-			time_t currentTime, PsmAddress excludedEdges,
-			CgrRoute *route, CgrTrace *trace)
+static CgrContactNote	*getVertexWorkArea(PsmPartition ionwm,
+				CgrSearchContext *context, CgrWorkAreas *areas,
+				int vertex)
 {
-	PsmPartition	ionwm = getIonwm();
-	IonVdb		*ionvdb = getIonVdb();
-	IonCXref	*current;
+	CgrContactNote	*work;
+
+	if (areas->notes == NULL)
+	{
+		return getWorkArea(ionwm, areas->epoch, (IonCXref *)
+				psp(ionwm, context->vertices[vertex].contact));
+	}
+
+	work = areas->notes + vertex;
+	if (work->epoch != areas->epoch)
+	{
+		resetWorkArea(work, areas->epoch);
+	}
+
+	return work;
+}
+
+static int	edgeIsExcluded(CgrSearch *search, int vertex)
+{
+	int	i;
+
+	for (i = 0; i < search->excludedCount; i++)
+	{
+		if (search->excluded[i] == vertex)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int	searchContactGraph(PsmPartition ionwm,
+			CgrSearchContext *context, CgrSearch *search,
+			CgrWorkAreas *areas, CgrTrace *trace)
+{
+	IonCVertex	*vertices = context->vertices;
+	IonCRow		*rows = context->rows;
+	CgrHeap		*heap = &areas->heap;
+	CgrContactNote	rootWork;
+	int		current;
 	CgrContactNote	*currentWork;
-	IonCXref	arg;
-	PsmAddress	elt;
-	PsmAddress	contactAddr;
-	IonCXref	*contact;
+	int		row;
+	int		i;
+	int		end;
+	IonCVertex	*vertex;
 	CgrContactNote	*work;
 	unsigned int	owlt;
-	unsigned int	owltMargin;
 	time_t		transmitTime;
 	time_t		arrivalTime;
-	IonCXref	*finalContact = NULL;
-	time_t		earliestFinalArrivalTime = MAX_TIME;
-	IonCXref	*nextCurrentContact;
-	time_t		earliestArrivalTime;
-	unsigned int	fewestHops;
-	time_t		earliestEndTime;
-	PsmAddress	addr;
-	PsmAddress	citation;
-	IonCXref	*firstContact;
+	int		nextCurrentVertex;
+	CgrHeapEntry	entry;
 
 	/*	This is an implementation of Dijkstra's Algorithm.	*/
 
 	TRACE(CgrBeginRoute);
-	current = rootContact;
-	currentWork = rootWork;
-	memset((char *) &arg, 0, sizeof(IonCXref));
+	heap->length = 0;
+
+	/*	Suppress contacts that would introduce loops, i.e.,
+	 *	all contacts on the root path for this spur path.
+	 *	But start from the arrival time at the root of the
+	 *	spur so that the computed arrival times of non-
+	 *	suppressed contacts will be correct.			*/
+
+	for (i = 0; i < search->suppressedCount; i++)
+	{
+		CHKERR(work = getVertexWorkArea(ionwm, context, areas,
+				search->suppressed[i]));
+		work->suppressed = 1;
+	}
+
+	current = search->root;
+	if (current < 0)	/*	Root of the contact graph.	*/
+	{
+		resetWorkArea(&rootWork, areas->epoch);
+		currentWork = &rootWork;
+		row = context->ownRow;
+	}
+	else
+	{
+		CHKERR(currentWork = getVertexWorkArea(ionwm, context, areas,
+				current));
+		row = vertices[current].successors;
+	}
+
+	currentWork->arrivalTime = search->rootArrivalTime;
+	currentWork->hopCount = search->rootHopCount;
 
 	/*	Perform this outer loop until either the best
 	 *	route to the end vertex has been identified or else
@@ -464,24 +851,42 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 		 *	this invocation of Dijkstra's Algorithm.
 		 *
 		*	Each time we cycle through the outer loop, we
-		*	perform two inner loops.  
+		*	perform two inner loops.
 		*
 		 *	In the first innner loop, we consider all
 		 *	unvisited successors (i.e., topologically
 		 *	adjacent "next-hop" contacts; the "frontier")
 		 *	of the current contact, in each case computing
 		 *	best-case arrival time for a bundle that might
-		 *	be transmitted during that contact.		*/
+		 *	be transmitted during that contact.  These
+		 *	are the vertices in the contact graph row for
+		 *	the receiving node of the current contact.	*/
 
-		TRACE(CgrConsiderRoot, current->fromNode, current->toNode);
-		arg.fromNode = current->toNode;
-		for (oK(sm_rbt_search(ionwm, ionvdb->contactIndex,
-				rfx_order_contacts, &arg, &elt));
-				elt; elt = sm_rbt_next(ionwm, elt))
+		if (current < 0)
 		{
-			contactAddr = sm_rbt_data(ionwm, elt);
-			contact = (IonCXref *) psp(ionwm, contactAddr);
-			if (contact->toTime <= currentTime)
+			TRACE(CgrConsiderRoot, context->ownNodeNbr,
+					context->ownNodeNbr);
+		}
+		else
+		{
+			TRACE(CgrConsiderRoot, vertices[current].fromNode,
+					vertices[current].toNode);
+		}
+
+		if (row < 0)
+		{
+			i = end = 0;	/*	No successors.		*/
+		}
+		else
+		{
+			i = rows[row].firstVertex;
+			end = i + rows[row].vertexCount;
+		}
+
+		for (; i < end; i++)
+		{
+			vertex = vertices + i;
+			if (vertex->toTime <= context->currentTime)
 			{
 				/*	Contact is ended, is about to
 				 *	be purged.			*/
@@ -489,20 +894,10 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				continue;
 			}
 
-			/*	Note: contact->fromNode can't be less
-			 *	than current->toNode: we started at
-			 *	that node with sm_rbt_search.		*/
-
-			if (contact->fromNode > current->toNode)
-			{
-				/*	No more relevant contacts.	*/
-
-				break;
-			}
-
-			TRACE(CgrConsiderContact, contact->fromNode,
-					contact->toNode);
-			CHKERR(work = getWorkArea(ionwm, contact));
+			TRACE(CgrConsiderContact, vertex->fromNode,
+					vertex->toNode);
+			CHKERR(work = getVertexWorkArea(ionwm, context, areas,
+					i));
 			if (work->suppressed)
 			{
 				TRACE(CgrIgnoreContact, CgrSuppressed);
@@ -515,10 +910,9 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				continue;
 			}
 
-			if (current == rootContact)
+			if (current == search->root)
 			{
-				if (edgeIsExcluded(ionwm, excludedEdges,
-						contactAddr))
+				if (edgeIsExcluded(search, i))
 				{
 					work->suppressed = 1;
 					TRACE(CgrIgnoreContact, CgrSuppressed);
@@ -526,7 +920,7 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				}
 			}
 
-			if (contact->toTime <= currentWork->arrivalTime)
+			if (vertex->toTime <= currentWork->arrivalTime)
 			{
 				TRACE(CgrIgnoreContact, CgrContactEndsEarly);
 
@@ -539,9 +933,10 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 			}
 
 			/*	Get OWLT between the nodes in contact,
-			 *	from applicable range in range index.	*/
+			 *	as noted from the applicable range in
+			 *	the range index.			*/
 
-			if (getApplicableRange(contact, &owlt) < 0)
+			if (!vertex->ranged)
 			{
 				TRACE(CgrIgnoreContact, CgrNoRange);
 
@@ -553,13 +948,7 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				continue;
 			}
 
-			/*	Allow for possible additional latency
-			 *	due to the movement of the receiving
-			 *	node during the propagation of signal
-			 *	from the sending node.			*/
-
-			owltMargin = ((MAX_SPEED_MPH / 3600) * owlt) / 186282;
-			owlt += owltMargin;
+			owlt = marginalOwlt(vertex->owlt);
 
 			/*	Compute cost of choosing this edge:
 			 *	earliest bundle arrival time, given
@@ -567,13 +956,13 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 			 *	node in the course of the current
 			 *	contact.				*/
 
-			if (contact->fromTime < currentWork->arrivalTime)
+			if (vertex->fromTime < currentWork->arrivalTime)
 			{
 				transmitTime = currentWork->arrivalTime;
 			}
 			else
 			{
-				transmitTime = contact->fromTime;
+				transmitTime = vertex->fromTime;
 			}
 
 			arrivalTime = transmitTime + owlt;
@@ -606,9 +995,13 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 
 				work->arrivalTime = arrivalTime;
 				work->predecessor = current;
-				work->hopCount =
-					(getWorkArea(ionwm, current))->hopCount;
-				work->hopCount++;
+				work->hopCount = currentWork->hopCount + 1;
+				if (heapInsert(heap, i, work) < 0)
+				{
+					putErrmsg("Can't queue CGR contact.",
+							NULL);
+					return -1;
+				}
 			}
 		}
 
@@ -618,25 +1011,25 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 
 		currentWork->visited = 1;
 
-		/*	Now the second inner loop: among ALL non-
-		 *	suppressed contacts in the graph (not just the
-		 *	successors to the current contact), select the
-		 *	one with the earliest arrival time (the least
-		 *	distance from the root vertex) -- and, in the
-		 *	event of a tie, the one comprising the smallest
-		 *	number of successive contacts ("hops") -- to be
-		 *	the new "current" vertex to analyze.		*/
-
-		nextCurrentContact = NULL;
-		earliestArrivalTime = MAX_TIME;
-		fewestHops = (unsigned int) -1;
-		for (elt = sm_rbt_first(ionwm, ionvdb->contactIndex); elt;
-				elt = sm_rbt_next(ionwm, elt))
-		{
-			contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm,
-					elt));
-			CHKERR(contact);
-			if (contact->toTime <= currentTime)
+		/*	Now select, among ALL non-suppressed contacts
+		 *	in the graph (not just the successors to the
+		 *	current contact), the one with the earliest
+		 *	arrival time (the least distance from the root
+		 *	vertex) -- and, in the event of a tie, the one
+		 *	comprising the smallest number of successive
+		 *	contacts ("hops") -- to be the new "current"
+		 *	vertex to analyze.  Every reachable unvisited
+		 *	contact is in the heap, so this is the first
+		 *	heap entry that has been neither visited nor
+		 *	superseded by a later improvement in its
+		 *	arrival time.					*/
+
+		nextCurrentVertex = -1;
+		while (heap->length > 0)
+		{
+			heapRemoveFirst(heap, &entry);
+			if (vertices[entry.vertex].toTime
+					<= context->currentTime)
 			{
 				/*	Contact is ended, is about to
 				 *	be purged.			*/
@@ -644,200 +1037,413 @@ static int	computeDistanceToTerminus(IonCXref *rootContact,
 				continue;
 			}
 
-			CHKERR(work = getWorkArea(ionwm, contact));
+			CHKERR(work = getVertexWorkArea(ionwm, context, areas,
+					entry.vertex));
 			if (work->suppressed || work->visited)
 			{
 				continue;	/*	Ineligible.	*/
 			}
 
-			if (work->arrivalTime == MAX_TIME)
-			{
-				/*	Not reachable from root.	*/
-
-				continue;
-			}
-
-			/*	Dijkstra search edge cost function.	*/
-
-			if (work->arrivalTime > earliestArrivalTime)
-			{
-				/*	Not the lowest-cost edge.	*/
-
-				continue;
-			}
-
-			if (work->arrivalTime == earliestArrivalTime
-					&& work->hopCount >= fewestHops)
+			if (work->arrivalTime != entry.arrivalTime)
 			{
-				/*	Not the lowest-cost edge.	*/
-
-				continue;
+				continue;	/*	Superseded.	*/
 			}
 
-			/*	Best candidate "next current" contact
-			 *	seen so far.				*/
-
-			nextCurrentContact = contact;
-			earliestArrivalTime = work->arrivalTime;
-			fewestHops = work->hopCount;
+			nextCurrentVertex = entry.vertex;
+			break;
 		}
 
 		/*	If search is complete, stop.  Else repeat,
 		 *	with new value of "current".			*/
 
-		if (nextCurrentContact == NULL)
+		if (nextCurrentVertex < 0)
 		{
 			/*	End of search; can't proceed any
 			 *	further toward the terminal contact.	*/
 
-			break;	/*	Out of outer loop; no path.	*/
+			return 0;	/*	No path.		*/
 		}
 
-		current = nextCurrentContact;
-		currentWork = (CgrContactNote *)
-				psp(ionwm, current->routingObject);
-		if (current->toNode == terminusNode->nodeNbr)
+		current = nextCurrentVertex;
+		currentWork = work;
+		row = vertices[current].successors;
+		if (vertices[current].toNode == context->terminusNodeNbr)
 		{
-			earliestFinalArrivalTime = currentWork->arrivalTime;
-			finalContact = current;
 			break;	/*	Out of outer loop; found path.	*/
 		}
 	}
 
-	/*	Have finished a single Dijkstra search of the contact
-	 *	graph, excluding those contacts that were suppressed.	*/
+	/*	We have found the best path from the root to the
+	 *	destination node, given the applicable exclusions.
+	 *	Record the path, backtracking to the root.		*/
 
-	if (finalContact)	/*	Got route to terminal contact.	*/
+	search->arrivalTime = currentWork->arrivalTime;
+	search->pathLength = currentWork->hopCount - search->rootHopCount;
+	search->path = (int *) MTAKE(search->pathLength * sizeof(int));
+	if (search->path == NULL)
 	{
-		/*	We have found the best path from the local node
-		 *	to the destination node, given the applicable
-		 *	exclusions.					*/
+		putErrmsg("Can't record CGR path.", NULL);
+		return -1;
+	}
 
-		route->arrivalTime = earliestFinalArrivalTime;
-		route->arrivalConfidence = 1.0;
+	for (i = search->pathLength - 1; i >= 0; i--)
+	{
+		search->path[i] = current;
+		CHKERR(work = getVertexWorkArea(ionwm, context, areas,
+				current));
+		current = work->predecessor;
+	}
 
-		/*	Load the entire route into the "hops" list,
-		 *	backtracking to root, and compute the time
-		 *	at which the route will become unusable.	*/
+	return 0;
+}
 
-		route->hops = sm_list_create(ionwm);
-		if (route->hops == 0)
-		{
-			putErrmsg("Can't create CGR route hops list.", NULL);
-			return -1;
+static int	runSearch(PsmPartition ionwm, CgrSearchContext *context,
+			CgrSearch *search, CgrTrace *trace)
+{
+	CgrWorkAreas	areas;
+	int		result;
+
+	/*	A search performed by the calling thread uses the
+	 *	contacts' own work areas.				*/
+
+	if (beginWorkEpoch() < 0)
+	{
+		putErrmsg("Can't begin CGR search.", NULL);
+		return -1;
+	}
+
+	memset((char *) &areas, 0, sizeof areas);
+	areas.epoch = cgr_get_vdb()->workEpoch;
+	result = searchContactGraph(ionwm, context, search, &areas, trace);
+	if (areas.heap.entries)
+	{
+		MRELEASE(areas.heap.entries);
+	}
+
+	if (result < 0)
+	{
+		putErrmsg("Can't finish Dijkstra search.", NULL);
+	}
+
+	return result;
+}
+
+static int	excludeEdges(PsmPartition ionwm, CgrRtgObject *routingObj,
+			CgrRoute *lastSelectedRoute, PsmAddress rootOfSpurAddr,
+			PsmAddress excludedEdges)
+{
+	PsmAddress	routeElt;
+	PsmAddress	nextRouteElt;
+	PsmAddress	routeAddr;
+	CgrRoute	*route;
+	PsmAddress	contactElt;
+	PsmAddress	nextContactElt;
+	PsmAddress	contactAddr;
+	PsmAddress	rootPathContactElt;
+	PsmAddress	nextRootPathContactElt;
+	PsmAddress	rootPathContactAddr;
+
+	/*	Exclude edges that would introduce duplicates: for
+	 *	each existing route that has this same root path,
+	 *	exclude the edge from the end of the root path to
+	 *	the first subsequent contact.				*/
+
+//printf("*** rootOfSpurAddr is " UVAST_FIELDSPEC ". ***\n", rootOfSpurAddr);
+	for (routeElt = sm_list_first(ionwm, routingObj->selectedRoutes);
+			routeElt; routeElt = nextRouteElt)
+	{
+		nextRouteElt = sm_list_next(ionwm, routeElt);
+		if (disabledRoute(ionwm, routeElt, &routeAddr, &route))
+		{
+			continue;
 		}
 
-		earliestEndTime = MAX_TIME;
-		contact = finalContact;
-		while (contact)
+//puts("*** Looking for edges to exclude on a selected route. ***");
+		nextContactElt = sm_list_first(ionwm, route->hops);
+		nextRootPathContactElt = sm_list_first(ionwm,
+				lastSelectedRoute->hops);
+		contactAddr = 0;
+		rootPathContactAddr = 0;
+		while (1)
 		{
-			work = (CgrContactNote *) psp(ionwm,
-					contact->routingObject);
-			if (contact->toTime < earliestEndTime)
+//printf("*** rootPathContactAddr is " UVAST_FIELDSPEC ". ***\n", rootPathContactAddr);
+			if (contactAddr != rootPathContactAddr)
 			{
-				earliestEndTime = contact->toTime;
+//puts("*** Root paths diverge at this point. ***");
+				/*	No shared root path, so
+				 *	end review of this route.	*/
+
+				break;
 			}
 
-			route->arrivalConfidence *= contact->confidence;
-			addr = psa(ionwm, contact);
-			TRACE(CgrHop, contact->fromNode, contact->toNode);
-			citation = sm_list_insert_first(ionwm, route->hops,
-					addr);
+//puts("*** Root path is the same up to this point. ***");
+		       	if (rootPathContactAddr == rootOfSpurAddr)
+			{
+				/*	Entire root path is shared,
+				 *	so suppress the next contact
+				 *	in this route and end review
+				 *	of this route.			*/
 
-			/*	Content of citation (which is a list
-			 *	element) is the address of the contact
-			 *	that is this hop of this route.
-			 *
-			 *	Content of new member of contact's
-			 *	citations list is the address of this
-			 *	list element.				*/
+				if (nextContactElt)
+				{
+					contactAddr = sm_list_data(ionwm,
+					       		nextContactElt);
+					if (contactAddr)
+					{
+						if (sm_list_insert_last(ionwm,
+							excludedEdges,
+							contactAddr) == 0)
+						{
+							putErrmsg("Can't add \
+excluded edge.", NULL);
+							return -1;
+						}
 
-			if (citation == 0)
-			{
-				putErrmsg("Can't insert contact into route.",
-						NULL);
-				return -1;
+//contact = (IonCXref *) psp(ionwm, contactAddr);
+//printf("*** Suppressing contact to node " UVAST_FIELDSPEC " after end of root path. ***\n", contact->toNode);
+					}
+				}
+
+				break;
 			}
 
-			if (contact->citations == 0)
+			/*	Up to this point, this route's root
+			 *	path is the same as that of the new
+			 *	spur route we are computing.  Review
+			 *	of this route must continue.		*/
+
+			if (nextContactElt == 0 || nextRootPathContactElt == 0)
 			{
-				contact->citations = sm_list_create(ionwm);
-				if (contact->citations == 0)
-				{
-					putErrmsg("Can't create citation list.",
-							NULL);
-					return -1;
-				}
+//puts("*** Reached end of route before reaching root of spur! ***");
+				/*	Root paths diverge, end review.	*/
+
+				break;
 			}
 
-			if (sm_list_insert_last(ionwm, contact->citations,
-					citation) == 0)
+//puts("*** Preparing to check next root path contact. ***");
+			contactElt = nextContactElt;
+			contactAddr = sm_list_data(ionwm, contactElt);
+			if (contactAddr == 0)
 			{
-				putErrmsg("Can't insert contact into route.",
-						NULL);
-				return -1;
+				break;
 			}
 
-			firstContact = contact;
-			contact = work->predecessor;
-			if (contact == rootContact)
+			nextContactElt = sm_list_next(ionwm, contactElt);
+			rootPathContactElt = nextRootPathContactElt;
+			rootPathContactAddr = sm_list_data(ionwm,
+					rootPathContactElt);
+			if (rootPathContactAddr == 0)
 			{
 				break;
 			}
+
+			nextRootPathContactElt = sm_list_next(ionwm,
+					rootPathContactElt);
+		}
+//puts("*** Done looking for contacts to exclude on that selected route. ***");
+	}
+
+//puts("*** Done looking for contacts to exclude on selected routes. ***");
+	return 0;
+}
+
+static int	graftTrunk(PsmPartition ionwm, CgrRoute *newRoute,
+			PsmAddress rootOfSpur, CgrTrace *trace)
+{
+	PsmAddress	contactElt;
+	IonCXref	*contact;
+	PsmAddress	citation;
+
+	/*	Prepend common trunk route to the spur route.  Each
+	 *	trunk contact is cited like any other hop, so that
+	 *	the route is disabled when any of them is deleted.
+	 *	The trunk contacts are also reflected in the route's
+	 *	toTime and arrivalConfidence, which (as for every
+	 *	other route) characterize the entire end-to-end
+	 *	path: otherwise a spur route might be selected after
+	 *	one of its trunk contacts has ended, or be rated as
+	 *	more reliable than it is.				*/
+
+	newRoute->rootOfSpur = 0;
+	contact = NULL;
+	contactElt = rootOfSpur;
+	while (contactElt)
+	{
+//puts("*** Prepending a contact from trunk to spur route. ***");
+		contact = (IonCXref *) psp(ionwm, sm_list_data(ionwm,
+				contactElt));
+		TRACE(CgrHop, contact->fromNode, contact->toNode);
+		citation = citeContact(ionwm, newRoute, contact);
+		if (citation == 0)
+		{
+			putErrmsg("Can't prepend trunk to spur route.", NULL);
+			return -1;
+		}
+
+		if (newRoute->rootOfSpur == 0)
+		{
+			/*	Further spurs from this route will
+			 *	branch off its own copy of the root.	*/
+
+			newRoute->rootOfSpur = citation;
 		}
 
-		/*	Now use the first contact in the route to
-		 *	characterize the route.				*/
+		if (contact->toTime < newRoute->toTime)
+		{
+			newRoute->toTime = contact->toTime;
+		}
 
-		route->toNodeNbr = firstContact->toNode;
-		route->fromTime = firstContact->fromTime;
-		route->toTime = earliestEndTime;
+		newRoute->arrivalConfidence *= contact->confidence;
+		contactElt = sm_list_prev(ionwm, contactElt);
+	}
+
+	/*	Have now navigated back through all contacts in the
+	 *	route.  Make sure the first of the contacts preceding
+	 *	the root of the spur within this route - if any - is
+	 *	used to characterize the route.				*/
+
+	if (contact)
+	{
+		newRoute->toNodeNbr = contact->toNode;
+		newRoute->fromTime = contact->fromTime;
 	}
 
 	return 0;
 }
 
-static int	computeRoute(PsmPartition ionwm, PsmAddress rootContactElt,
-			IonNode *terminusNode, time_t currentTime,
-		       	PsmAddress excludedEdges, PsmAddress *routeAddr,
-			CgrTrace *trace)
+static int	contactVertex(PsmPartition ionwm, CgrSearchContext *context,
+			PsmAddress contactAddr)
 {
-	IonCXref	*rootContact;
-	CgrContactNote	*rootWork;
-	PsmAddress	rootOfSpur;
-	PsmAddress	addr;
-	CgrRoute	*route;
-	IonCXref	graphRoot;
-	CgrContactNote	graphRootWork;
+	return rfx_graph_vertex(context->graph,
+			(IonCXref *) psp(ionwm, contactAddr));
+}
 
-	*routeAddr = 0;		/*	Default.			*/
-	if (rootContactElt)	/*	Computing route from waypoint.	*/
+static int	prepareSearch(PsmPartition ionwm, CgrSearchContext *context,
+			CgrSearch *search, CgrRtgObject *routingObj,
+			CgrRoute *lastSelectedRoute)
+{
+	PsmAddress	rootOfSpurAddr = 0;
+	PsmAddress	contactElt;
+	PsmAddress	excludedEdges;
+	int		count;
+	int		vertex;
+
+	search->root = -1;
+	search->rootArrivalTime = context->currentTime;
+	search->rootHopCount = 0;
+	if (search->rootOfSpur)
 	{
-//puts("*** Starting at a waypoint of the last selected route. ***");
-		rootContact = (IonCXref *) psp(ionwm, sm_list_data(ionwm,
-				rootContactElt));
-		if (rootContact->toNode == terminusNode->nodeNbr)
+		rootOfSpurAddr = sm_list_data(ionwm, search->rootOfSpur);
+		search->root = contactVertex(ionwm, context, rootOfSpurAddr);
+		CHKERR(search->root >= 0);
+		getRootArrival(ionwm, search->rootOfSpur, context->currentTime,
+				&search->rootArrivalTime, &search->rootHopCount);
+
+		/*	Suppress all contacts on the root path.		*/
+
+		search->suppressed = (int *) MTAKE(search->rootHopCount
+				* sizeof(int));
+		if (search->suppressed == NULL)
 		{
-			/*	No forwarding from destination.		*/
+			putErrmsg("Can't note suppressed contacts.", NULL);
+			return -1;
+		}
 
-			return 0;
+		for (contactElt = sm_list_prev(ionwm, search->rootOfSpur);
+				contactElt; contactElt = sm_list_prev(ionwm,
+				contactElt))
+		{
+			vertex = contactVertex(ionwm, context,
+					sm_list_data(ionwm, contactElt));
+			if (vertex >= 0)
+			{
+				search->suppressed[search->suppressedCount] =
+						vertex;
+				search->suppressedCount++;
+			}
 		}
+	}
 
-		rootWork = (CgrContactNote *) psp(ionwm,
-				rootContact->routingObject);
-		rootOfSpur = rootContactElt;
+	if (lastSelectedRoute == NULL)
+	{
+		return 0;	/*	First route; no exclusions.	*/
+	}
+
+	excludedEdges = sm_list_create(ionwm);
+	CHKERR(excludedEdges);
+	if (excludeEdges(ionwm, routingObj, lastSelectedRoute, rootOfSpurAddr,
+			excludedEdges) < 0)
+	{
+		sm_list_destroy(ionwm, excludedEdges, NULL, NULL);
+		putErrmsg("Can't exclude edges.", NULL);
+		return -1;
+	}
+
+	count = sm_list_length(ionwm, excludedEdges);
+	if (count > 0)
+	{
+		search->excluded = (int *) MTAKE(count * sizeof(int));
+		if (search->excluded == NULL)
+		{
+			sm_list_destroy(ionwm, excludedEdges, NULL, NULL);
+			putErrmsg("Can't note excluded edges.", NULL);
+			return -1;
+		}
+
+		for (contactElt = sm_list_first(ionwm, excludedEdges);
+				contactElt; contactElt = sm_list_next(ionwm,
+				contactElt))
+		{
+			vertex = contactVertex(ionwm, context,
+					sm_list_data(ionwm, contactElt));
+			if (vertex >= 0)
+			{
+				search->excluded[search->excludedCount] =
+						vertex;
+				search->excludedCount++;
+			}
+		}
+	}
+
+	sm_list_destroy(ionwm, excludedEdges, NULL, NULL);
+	return 0;
+}
+
+static void	releaseSearch(CgrSearch *search)
+{
+	if (search->suppressed)
+	{
+		MRELEASE(search->suppressed);
+	}
+
+	if (search->excluded)
+	{
+		MRELEASE(search->excluded);
+	}
+
+	if (search->path)
+	{
+		MRELEASE(search->path);
 	}
-	else	 /*	Computing route from root of contact graph.	*/
+}
+
+static int	loadRoute(PsmPartition ionwm, CgrSearchContext *context,
+			CgrSearch *search, PsmAddress *routeAddr,
+			CgrTrace *trace)
+{
+	PsmAddress	addr;
+	CgrRoute	*route;
+	IonCXref	*contact = NULL;
+	int		i;
+
+	*routeAddr = 0;		/*	Default.			*/
+	if (search->path == NULL)
 	{
-//puts("*** Starting at root of contact graph. ***");
+		TRACE(CgrNoMoreRoutes);
+
+		/*	No more routes in graph.			*/
 
-		memset((char *) &graphRoot, 0, sizeof graphRoot);
-		graphRoot.fromNode = graphRoot.toNode = getOwnNodeNbr();
-		rootContact = &graphRoot;
-		memset((char *) &graphRootWork, 0, sizeof graphRootWork);
-		graphRootWork.arrivalTime = currentTime;
-		rootWork = &graphRootWork;
-		rootOfSpur = 0;
+		return 0;
 	}
 
 	addr = psm_zalloc(ionwm, sizeof(CgrRoute));
@@ -849,60 +1455,70 @@ static int	computeRoute(PsmPartition ionwm, PsmAddress rootContactElt,
 
 	route = (CgrRoute *) psp(ionwm, addr);
 	memset((char *) route, 0, sizeof(CgrRoute));
-	route->rootOfSpur = rootOfSpur;
-
-	/*	Run Dijkstra search.					*/
-
-	if (computeDistanceToTerminus(rootContact, rootWork, terminusNode,
-			currentTime, excludedEdges, route, trace) < 0)
+	route->arrivalTime = search->arrivalTime;
+	route->arrivalConfidence = 1.0;
+	route->hops = sm_list_create(ionwm);
+	if (route->hops == 0)
 	{
-		if (route->hops)
-		{
-			sm_list_destroy(ionwm, route->hops, NULL, NULL);
-		}
-
 		psm_free(ionwm, addr);
-		putErrmsg("Can't finish Dijstra search.", NULL);
+		putErrmsg("Can't create CGR route hops list.", NULL);
 		return -1;
 	}
 
-	if (route->toNodeNbr == 0)
-	{
-		TRACE(CgrNoMoreRoutes);
-
-		/*	No more routes in graph.			*/
+	/*	Load the entire route into the "hops" list,
+	 *	backtracking to root, and compute the time at
+	 *	which the route will become unusable.			*/
 
-		if (route->hops)
+	route->toTime = MAX_TIME;
+	for (i = search->pathLength - 1; i >= 0; i--)
+	{
+		contact = (IonCXref *) psp(ionwm,
+				context->vertices[search->path[i]].contact);
+		if (contact->toTime < route->toTime)
 		{
-			sm_list_destroy(ionwm, route->hops, NULL, NULL);
+			route->toTime = contact->toTime;
 		}
 
-		psm_free(ionwm, addr);
-		*routeAddr = 0;
+		route->arrivalConfidence *= contact->confidence;
+		TRACE(CgrHop, contact->fromNode, contact->toNode);
+		if (citeContact(ionwm, route, contact) == 0)
+		{
+			return -1;
+		}
 	}
-	else
-	{
-		TRACE(CgrProposeRoute, route->toNodeNbr,
-				(unsigned int)(route->fromTime),
-				(unsigned int)(route->arrivalTime));
 
-		/*	Found best route, given current exclusions.	*/
+	/*	Now use the first contact in the route to
+	 *	characterize the route.					*/
+
+	route->toNodeNbr = contact->toNode;
+	route->fromTime = contact->fromTime;
+	TRACE(CgrProposeRoute, route->toNodeNbr,
+			(unsigned int)(route->fromTime),
+			(unsigned int)(route->arrivalTime));
+
+	/*	Found best route, given current exclusions.		*/
 
-		*routeAddr = addr;
+	if (graftTrunk(ionwm, route, search->rootOfSpur, trace) < 0)
+	{
+		return -1;
 	}
 
+	*routeAddr = addr;
 	return 0;
 }
 
 static int	insertFirstRoute(IonNode *terminusNode, time_t currentTime,
 			CgrTrace *trace)
 {
-	PsmPartition	ionwm = getIonwm();
-	IonVdb		*ionvdb = getIonVdb();
-	CgrVdb		*cgrvdb	= cgr_get_vdb();
-	PsmAddress	routeAddr;
-	CgrRtgObject	*routingObj;
-	CgrRoute	*route;
+	PsmPartition		ionwm = getIonwm();
+	IonVdb			*ionvdb = getIonVdb();
+	CgrVdb			*cgrvdb	= cgr_get_vdb();
+	CgrSearchContext	context;
+	CgrSearch		search;
+	int			result;
+	PsmAddress		routeAddr;
+	CgrRtgObject		*routingObj;
+	CgrRoute		*route;
 
 //puts("***Inserting first route.***");
 	CHKERR(ionwm);
@@ -911,9 +1527,25 @@ static int	insertFirstRoute(IonNode *terminusNode, time_t currentTime,
 
 	/*	Find first route.					*/
 
-	clearWorkAreas(NULL);
-	if (computeRoute(ionwm, 0, terminusNode, currentTime, 0, &routeAddr,
-			trace) < 0)
+	memset((char *) &search, 0, sizeof search);
+	result = loadSearchContext(ionwm, &context, terminusNode, currentTime);
+	if (result == 0)
+	{
+		result = prepareSearch(ionwm, &context, &search, NULL, NULL);
+	}
+
+	if (result == 0)
+	{
+		result = runSearch(ionwm, &context, &search, trace);
+	}
+
+	if (result == 0)
+	{
+		result = loadRoute(ionwm, &context, &search, &routeAddr, trace);
+	}
+
+	releaseSearch(&search);
+	if (result < 0)
 	{
 		putErrmsg("Can't insert first route.", NULL);
 		return -1;
@@ -939,242 +1571,290 @@ static int	insertFirstRoute(IonNode *terminusNode, time_t currentTime,
 	return 0;
 }
 
-static int	computeSpurRoute(PsmPartition ionwm, IonNode *terminusNode,
-			CgrRoute *lastSelectedRoute, time_t currentTime, 
-			PsmAddress rootOfSpur, CgrRtgObject *routingObj,
-			CgrTrace *trace)
-{
-	PsmAddress	rootOfSpurAddr;
-	PsmAddress	excludedEdges;
-	PsmAddress	contactElt;
-	PsmAddress	nextContactElt;
-	PsmAddress	contactAddr;
-	IonCXref	*contact;
-	CgrContactNote	*work;
-	unsigned int	owlt;
-	PsmAddress	routeElt;
-	PsmAddress	nextRouteElt;
-	PsmAddress	routeAddr;
-	CgrRoute	*route;
-	PsmAddress	rootPathContactElt;
-	PsmAddress	nextRootPathContactElt;
-	PsmAddress	rootPathContactAddr;
-	int		result;
-	PsmAddress	newRouteAddr;
-	CgrRoute	*newRoute;
+#ifndef ION4WIN
 
-//puts("*** Computing a spur route. ***");
-	if (rootOfSpur == 0)
-	{
-		rootOfSpurAddr = 0;
-		clearWorkAreas(NULL);
-	}
-	else
-	{
-		rootOfSpurAddr = sm_list_data(ionwm, rootOfSpur);
-		clearWorkAreas((IonCXref *) psp(ionwm, rootOfSpurAddr));
-	}
+/*	Parallel spur route computation.  The spur routes branching
+ *	off a selected route are mutually independent searches, so
+ *	when CGR_SPUR_WORKERS is nonzero (and no trace is requested)
+ *	they are performed concurrently by a pool of worker threads.
+ *	Each worker runs searchContactGraph against its own private
+ *	array of work areas, so the workers never write to the
+ *	contacts themselves.  The calling thread then builds the
+ *	resulting routes and appends them to the list of known routes
+ *	in spur order, exactly as when the searches are serial.	*/
 
-	excludedEdges = sm_list_create(ionwm);
-	CHKERR(excludedEdges);
+typedef struct
+{
+	PsmPartition	ionwm;
+	CgrSearchContext *context;
+	CgrSearch	*searches;
+	int		searchCount;
+	int		nextSearch;
+	pthread_mutex_t	mutex;
+} CgrSpurJob;
 
-	/*	Suppress contacts that would introduce loops, i.e.,
-	 *	all contacts on the root path for this spur path.
-	 *	But restore arrival times for those contacts so that
-	 *	the computed arrival times of non-suppressed contacts
-	 *	will be correct.					*/
+typedef struct
+{
+	CgrSpurJob	*job;
+	pthread_t	thread;
+	CgrWorkAreas	areas;		/*	Private.		*/
+} CgrSpurWorker;
+
+static void	*runSpurWorker(void *parm)
+{
+	CgrSpurWorker	*worker = (CgrSpurWorker *) parm;
+	CgrSpurJob	*job = worker->job;
+	int		searchNbr;
 
-	if (rootOfSpur != 0)
+	while (1)
 	{
-//puts("*** Suppressing contacts on root path. ***");
-		contactElt = sm_list_prev(ionwm, rootOfSpur);
-		while (contactElt)
+		pthread_mutex_lock(&job->mutex);
+		searchNbr = job->nextSearch;
+		if (searchNbr < job->searchCount)
 		{
-			contactAddr = sm_list_data(ionwm, contactElt);
-			contact = (IonCXref *) psp(ionwm, contactAddr);
-			CHKERR(work = getWorkArea(ionwm, contact));
-			if (getApplicableRange(contact, &owlt) >= 0)
-			{
-				/*	 Got OWLT; add some margin.	*/
-
-				owlt += ((MAX_SPEED_MPH/3600) * owlt) / 186282;
-			}
-
-			work->arrivalTime = contact->fromTime + owlt;
-			work->suppressed = 1;
-//debugPrint("*** Suppressing contact to node " UVAST_FIELDSPEC " on root path. ***\n", contact->toNode);
-			contactElt = sm_list_prev(ionwm, contactElt);
+			job->nextSearch++;
 		}
-	}
 
-	/*	Exclude edges that would introduce duplicates: for
-	 *	each existing route that has this same root path,
-	 *	exclude the edge from the end of the root path to
-	 *	the first subsequent contact.				*/
+		pthread_mutex_unlock(&job->mutex);
+		if (searchNbr >= job->searchCount)
+		{
+			break;
+		}
 
-//printf("*** rootOfSpurAddr is " UVAST_FIELDSPEC ". ***\n", rootOfSpurAddr);
-	for (routeElt = sm_list_first(ionwm, routingObj->selectedRoutes);
-			routeElt; routeElt = nextRouteElt)
-	{
-		nextRouteElt = sm_list_next(ionwm, routeElt);
-		if (disabledRoute(ionwm, routeElt, &routeAddr, &route))
+		worker->areas.epoch++;
+		if (worker->areas.epoch == 0)
 		{
-			continue;
+			/*	Epoch number has wrapped around.	*/
+
+			memset((char *) worker->areas.notes, 0,
+					job->context->vertexCount
+					* sizeof(CgrContactNote));
+			worker->areas.epoch = 1;
 		}
 
-//puts("*** Looking for edges to exclude on a selected route. ***");
-		nextContactElt = sm_list_first(ionwm, route->hops);
-		nextRootPathContactElt = sm_list_first(ionwm,
-				lastSelectedRoute->hops);
-		contactAddr = 0;
-		rootPathContactAddr = 0;
-		while (1)
+		if (searchContactGraph(job->ionwm, job->context,
+				job->searches + searchNbr, &worker->areas,
+				NULL) < 0)
 		{
-//printf("*** rootPathContactAddr is " UVAST_FIELDSPEC ". ***\n", rootPathContactAddr);
-			if (contactAddr != rootPathContactAddr)
-			{
-//puts("*** Root paths diverge at this point. ***");
-				/*	No shared root path, so
-				 *	end review of this route.	*/
+			job->searches[searchNbr].failed = 1;
+		}
+	}
+
+	return NULL;
+}
 
-				break;
-			}
+static void	releaseSpurWorkers(CgrSpurWorker *workers, int workerCount)
+{
+	int		i;
+	CgrSpurWorker	*worker;
 
-//puts("*** Root path is the same up to this point. ***");
-		       	if (rootPathContactAddr == rootOfSpurAddr)
-			{
-				/*	Entire root path is shared,
-				 *	so suppress the next contact
-				 *	in this route and end review
-				 *	of this route.			*/
+	for (i = 0; i < workerCount; i++)
+	{
+		worker = workers + i;
+		if (worker->areas.notes)
+		{
+			MRELEASE(worker->areas.notes);
+		}
 
-				if (nextContactElt)
-				{
-					contactAddr = sm_list_data(ionwm,
-					       		nextContactElt);
-					if (contactAddr)
-					{
-						if (sm_list_insert_last(ionwm,
-							excludedEdges,
-							contactAddr) == 0)
-						{
-							putErrmsg("Can't add \
-excluded edge.", NULL);
-							sm_list_destroy(ionwm,
-								excludedEdges,
-								NULL, NULL);
-							return -1;
-						}
+		if (worker->areas.heap.entries)
+		{
+			MRELEASE(worker->areas.heap.entries);
+		}
+	}
 
-//contact = (IonCXref *) psp(ionwm, contactAddr);
-//printf("*** Suppressing contact to node " UVAST_FIELDSPEC " after end of root path. ***\n", contact->toNode);
-					}
-				}
+	MRELEASE(workers);
+}
 
-				break;
-			}
+static int	runSpurWorkers(PsmPartition ionwm, CgrSearchContext *context,
+			CgrSearch *searches, int searchCount)
+{
+	CgrSpurJob	job;
+	CgrSpurWorker	*workers;
+	int		workerCount;
+	int		i;
+	int		started;
 
-			/*	Up to this point, this route's root
-			 *	path is the same as that of the new
-			 *	spur route we are computing.  Review
-			 *	of this route must continue.		*/
+	workerCount = CGR_SPUR_WORKERS;
+	if (workerCount > searchCount)
+	{
+		workerCount = searchCount;
+	}
 
-			if (nextContactElt == 0 || nextRootPathContactElt == 0)
-			{
-//puts("*** Reached end of route before reaching root of spur! ***");
-				/*	Root paths diverge, end review.	*/
+	workers = (CgrSpurWorker *) MTAKE(workerCount * sizeof(CgrSpurWorker));
+	if (workers == NULL)
+	{
+		putErrmsg("Can't allocate CGR spur workers.", NULL);
+		return -1;
+	}
 
-				break;
-			}
+	memset((char *) workers, 0, workerCount * sizeof(CgrSpurWorker));
+	memset((char *) &job, 0, sizeof job);
+	job.ionwm = ionwm;
+	job.context = context;
+	job.searches = searches;
+	job.searchCount = searchCount;
+	for (i = 0; i < workerCount; i++)
+	{
+		workers[i].job = &job;
+		workers[i].areas.notes = (CgrContactNote *)
+				MTAKE(context->vertexCount
+				* sizeof(CgrContactNote));
+		if (workers[i].areas.notes == NULL)
+		{
+			releaseSpurWorkers(workers, workerCount);
+			putErrmsg("Can't allocate CGR spur work areas.", NULL);
+			return -1;
+		}
+	}
 
-//puts("*** Preparing to check next root path contact. ***");
-			contactElt = nextContactElt;
-			contactAddr = sm_list_data(ionwm, contactElt);
-			if (contactAddr == 0)
-			{
-				break;
-			}
+	/*	The calling thread is itself the first worker.		*/
 
-			nextContactElt = sm_list_next(ionwm, contactElt);
-			rootPathContactElt = nextRootPathContactElt;
-			rootPathContactAddr = sm_list_data(ionwm,
-					rootPathContactElt);
-			if (rootPathContactAddr == 0)
-			{
-				break;
-			}
+	pthread_mutex_init(&job.mutex, NULL);
+	for (started = 1; started < workerCount; started++)
+	{
+		if (pthread_begin(&workers[started].thread, NULL,
+				runSpurWorker, workers + started, "cgrspur"))
+		{
+			putSysErrmsg("Can't start CGR spur worker", NULL);
+			break;
+		}
+	}
 
-			nextRootPathContactElt = sm_list_next(ionwm,
-					rootPathContactElt);
+	oK(runSpurWorker(workers));
+	for (i = 1; i < started; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	pthread_mutex_destroy(&job.mutex);
+	releaseSpurWorkers(workers, workerCount);
+	for (i = 0; i < searchCount; i++)
+	{
+		if (searches[i].failed)
+		{
+			putErrmsg("CGR spur search failed.", NULL);
+			return -1;
 		}
-//puts("*** Done looking for contacts to exclude on that selected route. ***");
 	}
 
-//puts("*** Done looking for contacts to exclude on selected routes. ***");
+	return 0;
+}
 
-	/*	Compute best route, within these constraints.		*/
+#endif		/*	end of #ifndef ION4WIN				*/
 
-	result = computeRoute(ionwm, rootOfSpur, terminusNode, currentTime,
-			excludedEdges, &newRouteAddr, trace);
-	sm_list_destroy(ionwm, excludedEdges, NULL, NULL);
-	if (result < 0)
+static int	computeSpurRoutes(PsmPartition ionwm, IonNode *terminusNode,
+			CgrRoute *lastSelectedRoute, time_t currentTime,
+			PsmAddress rootOfSpur, PsmAddress rootOfNextSpur,
+			CgrRtgObject *routingObj, CgrTrace *trace)
+{
+	CgrSearchContext	context;
+	CgrSearch		*searches;
+	int			searchCount;
+	int			searchesDone = 0;
+	PsmAddress		elt;
+	CgrSearch		*search;
+	PsmAddress		newRouteAddr;
+	CgrRoute		*newRoute;
+	int			i;
+	int			result = 0;
+
+//puts("*** Computing spur routes. ***");
+	if (loadSearchContext(ionwm, &context, terminusNode, currentTime) < 0)
 	{
-		putErrmsg("Can't compute route.", NULL);
 		return -1;
 	}
 
-	if (newRouteAddr == 0)		/*	No route found.		*/
+	/*	One search per spur root: the root of the last selected
+	 *	route's own spur, then every later hop of the route.
+	 *	(A spur can't branch off a contact to the terminus.)	*/
+
+	searchCount = 1 + sm_list_length(ionwm, lastSelectedRoute->hops);
+	searches = (CgrSearch *) MTAKE(searchCount * sizeof(CgrSearch));
+	if (searches == NULL)
 	{
-//puts("*** No newly computed route reported. ***");
-		return 0;
+		putErrmsg("Can't allocate CGR spur searches.", NULL);
+		return -1;
 	}
 
-	newRoute = (CgrRoute *) psp(ionwm, newRouteAddr);
-	newRoute->rootOfSpur = rootOfSpur;
+	memset((char *) searches, 0, searchCount * sizeof(CgrSearch));
+	searchCount = 0;
+	elt = rootOfSpur;
+	while (1)
+	{
+		if (elt == 0 || ((IonCXref *) psp(ionwm, sm_list_data(ionwm,
+				elt)))->toNode != terminusNode->nodeNbr)
+		{
+			searches[searchCount].rootOfSpur = elt;
+			searchCount++;
+		}
+
+		elt = rootOfNextSpur;
+		if (elt == 0)
+		{
+			break;
+		}
 
-	/*	Prepend common trunk route to the spur route.		*/
+		rootOfNextSpur = sm_list_next(ionwm, elt);
+	}
 
-	contact = NULL;
-	contactElt = rootOfSpur;
-	while (contactElt)
+	for (i = 0; i < searchCount; i++)
 	{
-//puts("*** Prepending a contact from trunk to spur route. ***");
-		contactAddr = sm_list_data(ionwm, contactElt);
-		contact = (IonCXref *) psp(ionwm, contactAddr);
-		TRACE(CgrHop, contact->fromNode, contact->toNode);
-		if (sm_list_insert_first(ionwm, newRoute->hops, contactAddr)
-				== 0)
+		if (prepareSearch(ionwm, &context, searches + i, routingObj,
+				lastSelectedRoute) < 0)
 		{
-			putErrmsg("Can't prepend trunk to spur route.", NULL);
-			return -1;
+			result = -1;
+			break;
 		}
+	}
 
-		contactElt = sm_list_prev(ionwm, contactElt);
+#ifndef ION4WIN
+	if (result == 0 && CGR_SPUR_WORKERS > 0 && trace == NULL
+	&& context.vertexCount > 0)
+	{
+		result = runSpurWorkers(ionwm, &context, searches, searchCount);
+		searchesDone = 1;
 	}
+#endif
 
-	/*	Have now navigated back through all contacts in the
-	 *	route.  Make sure the first of the contacts preceding
-	 *	the root of the spur within this route - if any - is
-	 *	used to characterize the route.				*/
+	/*	Append the spur routes to the list of known routes.	*/
 
-	if (contact)
+	for (i = 0; result == 0 && i < searchCount; i++)
 	{
-		route->toNodeNbr = contact->toNode;
-		route->fromTime = contact->fromTime;
-	}
+		search = searches + i;
+		if (!searchesDone)
+		{
+			result = runSearch(ionwm, &context, search, trace);
+			if (result < 0)
+			{
+				break;
+			}
+		}
 
-	/*	Append new route to list of known routes.		*/
+		result = loadRoute(ionwm, &context, search, &newRouteAddr,
+				trace);
+		if (result < 0 || newRouteAddr == 0)
+		{
+			continue;
+		}
 
 //puts("*** Appending newly computed route to list B. ***");
-	newRoute->referenceElt = sm_list_insert_last(ionwm,
-			routingObj->knownRoutes, newRouteAddr);
-	if (newRoute->referenceElt == 0)
+		newRoute = (CgrRoute *) psp(ionwm, newRouteAddr);
+		newRoute->referenceElt = sm_list_insert_last(ionwm,
+				routingObj->knownRoutes, newRouteAddr);
+		if (newRoute->referenceElt == 0)
+		{
+			putErrmsg("Can't append known route.", NULL);
+			result = -1;
+		}
+	}
+
+	for (i = 0; i < searchCount; i++)
 	{
-		putErrmsg("Can't append known route.", NULL);
-		return -1;
+		releaseSearch(searches + i);
 	}
 
-	return 0;
+	MRELEASE(searches);
+	return result;
 }
 
 static int	computeAnotherRoute(IonNode *terminusNode,
@@ -1225,25 +1905,12 @@ static int	computeAnotherRoute(IonNode *terminusNode,
 	/*	Compute spur routes that branch off the current last
 	 *	selected route, inserting them into Yen's "list B".	*/
 
-	while (1)
+	if (computeSpurRoutes(ionwm, terminusNode, lastSelectedRoute,
+			currentTime, rootOfSpur, rootOfNextSpur, routingObj,
+			trace) < 0)
 	{
-		if (computeSpurRoute(ionwm, terminusNode, lastSelectedRoute,
-				currentTime, rootOfSpur, routingObj, trace) < 0)
-		{
-			putErrmsg("Failed computing spur route.", NULL);
-			return -1;
-		}
-
-		rootOfSpur = rootOfNextSpur;
-		if (rootOfSpur == 0)
-		{
-			/*	Receiver of prior root contact was
-			 *	the destination.			*/
-
-			break;	/*	No more spur routes.		*/
-		}
-
-		rootOfNextSpur = sm_list_next(ionwm, rootOfSpur);
+		putErrmsg("Failed computing spur routes.", NULL);
+		return -1;
 	}
 
 //puts("*** Finished computing all spur routes from last selected route. ***");
@@ -1708,7 +2375,6 @@ static int	tryRoute(CgrRoute *route, time_t currentTime, Bundle *bundle,
 {
 	Sdr		sdr = getIonsdr();
 	PsmPartition	wm = getIonwm();
-	char		eid[SDRSTRING_BUFSZ];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 	Object		planObj;
@@ -1717,9 +2383,7 @@ static int	tryRoute(CgrRoute *route, time_t currentTime, Bundle *bundle,
 	LystElt		candidateElt;
 	CgrRoute	*candidateRoute;
 
-	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0",
-			route->toNodeNbr);
-	findPlan(eid, &vplan, &vplanElt);
+	findIpnPlan(route->toNodeNbr, &vplan, &vplanElt);
 	if (vplanElt == 0)
 	{
 		TRACE(CgrExcludeRoute, CgrNoPlan);
@@ -2300,6 +2964,182 @@ static int	loadCriticalBestRoutesList(IonNode *terminusNode,
 	return 0;
 }
 
+static int	decisionIsCacheable(Bundle *bundle, Lyst excludedNodes,
+			CgrTrace *trace)
+{
+	/*	Only the first forwarding of a non-critical bundle is
+	 *	a routine decision: forwarding critical bundles, or
+	 *	additional copies of bundles, or bundles for which
+	 *	some nodes are excluded, depends on more than the
+	 *	bundle's class.  Traced decisions are never cached.	*/
+
+	return (CGR_ROUTE_CACHE
+		&& trace == NULL
+		&& lyst_length(excludedNodes) == 0
+		&& bundle->dlvConfidence == 0.0
+		&& !(bundle->ancillaryData.flags & BP_MINIMUM_LATENCY));
+}
+
+static void	loadDecisionKey(Bundle *bundle, CgrDecision *key)
+{
+	unsigned int	size = guessBundleSize(bundle);
+
+	memset((char *) key, 0, sizeof(CgrDecision));
+	key->priority = bundle->priority;
+	key->ordinal = bundle->ordinal;
+	while (size > 1)
+	{
+		key->sizeClass++;
+		size >>= 1;
+	}
+
+	key->doNotFragment = (bundle->bundleProcFlags & BDL_DOES_NOT_FRAGMENT)
+			? 1 : 0;
+}
+
+static CgrDecision	*findDecision(PsmPartition ionwm,
+				CgrRtgObject *routingObj, CgrDecision *key)
+{
+	PsmAddress	elt;
+	CgrDecision	*decision;
+
+	if (routingObj->decisions == 0)
+	{
+		return NULL;
+	}
+
+	for (elt = sm_list_first(ionwm, routingObj->decisions); elt;
+			elt = sm_list_next(ionwm, elt))
+	{
+		decision = (CgrDecision *) psp(ionwm, sm_list_data(ionwm, elt));
+		if (decision->priority == key->priority
+		&& decision->ordinal == key->ordinal
+		&& decision->sizeClass == key->sizeClass
+		&& decision->doNotFragment == key->doNotFragment)
+		{
+			return decision;
+		}
+	}
+
+	return NULL;
+}
+
+static int	reuseDecision(CgrRtgObject *routingObj, Bundle *bundle,
+			Lyst excludedNodes, CgrTrace *trace, Lyst bestRoutes,
+			time_t currentTime, time_t deadline)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
+	CgrDecision	key;
+	CgrDecision	*decision;
+	CgrRoute	*route;
+
+	if (!decisionIsCacheable(bundle, excludedNodes, trace))
+	{
+		return 0;
+	}
+
+	loadDecisionKey(bundle, &key);
+	decision = findDecision(ionwm, routingObj, &key);
+	if (decision == NULL
+	|| decision->planVersion != ionvdb->planVersion
+	|| decision->toTime <= currentTime)
+	{
+		return 0;	/*	No applicable decision.		*/
+	}
+
+	/*	A selected route is removed only when it has ended or
+	 *	one of its contacts has been deleted, which changes
+	 *	the contact plan version, so the route still exists.
+	 *	Re-check it for this bundle.				*/
+
+	route = (CgrRoute *) psp(ionwm, decision->routeAddr);
+	if (route->arrivalTime > deadline)
+	{
+		return 0;
+	}
+
+	if (tryRoute(route, currentTime, bundle, NULL, bestRoutes) < 0)
+	{
+		putErrmsg("Failed trying cached route.", NULL);
+		return -1;
+	}
+
+	if (lyst_length(bestRoutes) == 0)
+	{
+		return 0;	/*	Route is no longer usable.	*/
+	}
+
+	if (route->pbat != decision->pbat)
+	{
+		/*	Volume committed to the route's contacts has
+		 *	changed its projected arrival time, so some
+		 *	other route may now be better.			*/
+
+		lyst_clear(bestRoutes);
+		return 0;
+	}
+
+	return 1;
+}
+
+static int	recordDecision(CgrRtgObject *routingObj, Bundle *bundle,
+			Lyst excludedNodes, CgrTrace *trace, Lyst bestRoutes)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
+	CgrDecision	key;
+	CgrDecision	*decision;
+	PsmAddress	addr;
+	CgrRoute	*route;
+
+	if (!decisionIsCacheable(bundle, excludedNodes, trace)
+	|| lyst_length(bestRoutes) != 1)
+	{
+		return 0;
+	}
+
+	if (routingObj->decisions == 0)
+	{
+		routingObj->decisions = sm_list_create(ionwm);
+		if (routingObj->decisions == 0)
+		{
+			putErrmsg("Can't create CGR decisions list.", NULL);
+			return -1;
+		}
+	}
+
+	loadDecisionKey(bundle, &key);
+	decision = findDecision(ionwm, routingObj, &key);
+	if (decision == NULL)
+	{
+		addr = psm_zalloc(ionwm, sizeof(CgrDecision));
+		if (addr == 0)
+		{
+			putErrmsg("Can't create CGR decision.", NULL);
+			return -1;
+		}
+
+		if (sm_list_insert_last(ionwm, routingObj->decisions, addr)
+				== 0)
+		{
+			psm_free(ionwm, addr);
+			putErrmsg("Can't cache CGR decision.", NULL);
+			return -1;
+		}
+
+		decision = (CgrDecision *) psp(ionwm, addr);
+	}
+
+	route = (CgrRoute *) lyst_data(lyst_first(bestRoutes));
+	memcpy((char *) decision, (char *) &key, sizeof(CgrDecision));
+	decision->planVersion = ionvdb->planVersion;
+	decision->routeAddr = psa(ionwm, route);
+	decision->toTime = route->toTime;
+	decision->pbat = route->pbat;
+	return 0;
+}
+
 int	cgr_create_routing_object(IonNode *node)
 {
 	PsmPartition	ionwm = getIonwm();
@@ -2380,11 +3220,33 @@ int	cgr_identify_best_routes(IonNode *terminusNode, Bundle *bundle,
 	}
 	else
 	{
-		if (loadBestRoutesList(terminusNode, 0, bundle,
-				excludedNodes, trace, bestRoutes,
-				currentTime, deadline, routingObj) < 0)
+		switch (reuseDecision(routingObj, bundle, excludedNodes,
+				trace, bestRoutes, currentTime, deadline))
 		{
-			putErrmsg("Can't find best route to destination.",
+		case 1:			/*	Cached route is best.	*/
+			break;
+
+		case 0:			/*	Must select route.	*/
+			if (loadBestRoutesList(terminusNode, 0, bundle,
+					excludedNodes, trace, bestRoutes,
+					currentTime, deadline, routingObj) < 0)
+			{
+				putErrmsg("Can't find best route to \
+destination.", utoa(terminusNode->nodeNbr));
+				return -1;
+			}
+
+			if (recordDecision(routingObj, bundle, excludedNodes,
+					trace, bestRoutes) < 0)
+			{
+				putErrmsg("Can't cache best route.", NULL);
+				return -1;
+			}
+
+			break;
+
+		default:
+			putErrmsg("Can't reuse best route to destination.",
 					utoa(terminusNode->nodeNbr));
 			return -1;
 		}
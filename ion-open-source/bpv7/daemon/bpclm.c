@@ -401,7 +401,7 @@ int	main(int argc, char *argv[])
 	}
 
 	sdr = getIonsdr();
-	CHKZERO(sdr_begin_xn(sdr));	/*	Just to lock database.	*/
+	CHKZERO(sdr_begin_read_xn(sdr));	/*	Just to lock database.	*/
 	findPlan(nodeName, &vplan, &vplanElt);
 	if (vplanElt == 0)
 	{
@@ -86,6 +86,19 @@ extern void	sec_get_bpsecBibRule(char *srcEid, char *destEid,
 
 extern Object	sec_get_bpsecBibRuleList();
 
+extern Object	sec_next_bpsecBibRule(char *srcEid, char *destEid,
+			int *cursor);
+		/*	Returns the address of the next BIB rule, in
+		 *	rule list order, that applies to bundles from
+		 *	srcEid to destEid.  Wild card match is okay.
+		 *	Set *cursor to -1 to get the first such rule;
+		 *	*cursor is updated on each call.  Returns 0 when
+		 *	no further rule applies, ((Object) ERROR) if
+		 *	the applicable rules can't be determined (the
+		 *	caller must then fail rather than skip security
+		 *	processing).  Must be called within an SDR
+		 *	transaction.					*/
+
 extern void	sec_get_bpsecBcbRule(char *srcEid, char *destEid,
 			BpBlockType *blkType, Object *ruleAddr, Object *eltp);
 		/*	Finds the BCB rule that most narrowly applies
@@ -97,6 +110,12 @@ extern void	sec_get_bpsecBcbRule(char *srcEid, char *destEid,
 
 extern Object	sec_get_bpsecBcbRuleList();
 
+extern Object	sec_next_bpsecBcbRule(char *srcEid, char *destEid,
+			int *cursor);
+		/*	Returns the address of the next BCB rule, in
+		 *	rule list order, that applies to bundles from
+		 *	srcEid to destEid, as for sec_next_bpsecBibRule.*/
+
 extern int	sec_get_bpsecNumKeys(int *size);
 		/* Retrieves number of keys and maximum size
 		 * of each key name.
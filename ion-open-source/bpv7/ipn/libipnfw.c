@@ -129,7 +129,6 @@ IpnDB	*getIpnConstants()
 void	ipn_findPlan(uvast nodeNbr, Object *planAddr, Object *eltp)
 {
 	Sdr		sdr = getIonsdr();
-	char		eid[MAX_EID_LEN + 1];
 	VPlan		*vplan;
 	PsmAddress	vplanElt;
 
@@ -144,8 +143,7 @@ void	ipn_findPlan(uvast nodeNbr, Object *planAddr, Object *eltp)
 		return;
 	}
 
-	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0", nodeNbr);
-	findPlan(eid, &vplan, &vplanElt);
+	findIpnPlan(nodeNbr, &vplan, &vplanElt);
 	if (vplanElt == 0)
 	{
 		return;
@@ -851,6 +851,8 @@ typedef struct
 
 	PsmAddress	schemes;	/*	SM list: VScheme.	*/
 	PsmAddress	plans;		/*	SM list: VPlan.		*/
+	PsmAddress	planIndex;	/*	SM RB tree: plan elts.	*/
+	PsmAddress	ipnPlanIndex;	/*	SM RB tree: plan elts.	*/
 	PsmAddress	inducts;	/*	SM list: VInduct.	*/
 	PsmAddress	outducts;	/*	SM list: VOutduct.	*/
 	PsmAddress	discoveries;	/*	SM list: Discovery.	*/
@@ -1292,6 +1294,39 @@ extern int		bpEndAcq(	AcqWorkArea *workArea);
 			 *	cycle of bundle acquisition just as
 			 *	if the return code had been 1.		*/
 
+extern int		bpAcquireBundles(AcqWorkArea *workArea,
+					char **bufs,
+					int *lengths,
+					int count);
+			/*	Acquires a batch of "count" complete
+			 *	bundles, each of which is the array
+			 *	of bytes at bufs[i] of length
+			 *	lengths[i], as if bpBeginAcq(),
+			 *	bpContinueAcq() (with no attendant),
+			 *	and bpEndAcq() had been invoked for
+			 *	each one in turn.  Intended for use
+			 *	by convergence-layer adapters that
+			 *	receive many small bundles at once,
+			 *	such as udpcli using recvmmsg().
+			 *
+			 *	ZCO space for the entire batch is
+			 *	reserved in a single request, and
+			 *	the bundles are all acquired within
+			 *	a single SDR transaction.  If the
+			 *	batch can't be acquired that way
+			 *	(ZCO space for the whole batch is
+			 *	not currently available, or some
+			 *	bundle is too large to be acquired
+			 *	into the SDR heap), the bundles are
+			 *	instead acquired one at a time; any
+			 *	bundle for which ZCO space is then
+			 *	unavailable is discarded due to
+			 *	congestion and acquisition continues
+			 *	with the next bundle of the batch.
+			 *
+			 *	Returns 0 on success, -1 on any
+			 *	system failure.				*/
+
 extern int		bpDestroyBundle(Object bundleToDestroy,
 					int unconditional);
 			/*	bpDestroyBundle destroys the bundle,
@@ -1406,6 +1441,8 @@ extern int		serializePayloadBlock(Payload *payload,
 				unsigned char blkProcFlags);
 
 extern void		findPlan(char *eid, VPlan **vplan, PsmAddress *elt);
+extern void		findIpnPlan(uvast nodeNbr, VPlan **vplan,
+				PsmAddress *elt);
 
 extern int		addPlan(char *eid, unsigned int nominalRate);
 extern int		updatePlan(char *eid, unsigned int nominalRate);
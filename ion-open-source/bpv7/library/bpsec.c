@@ -59,6 +59,18 @@ static int	filterEid(char *outputEid, char *inputEid, int eidIsInRule)
 	return 1;
 }
 
+static void	noteRulesChange()
+{
+	SecVdb	*secvdb = getSecVdb();
+
+	/*	Invalidates every process's BPsec rule index.		*/
+
+	if (secvdb)
+	{
+		secvdb->rulesVersion++;
+	}
+}
+
 int	sec_activeKey(char *keyName)
 {
 	Sdr	sdr = getIonsdr();
@@ -248,6 +260,11 @@ void	sec_clearBPsecRules(char *srcEid, char *destEid, BpBlockType *blockType)
 			}
 		}
 
+		if (rmCount > 0)
+		{
+			noteRulesChange();
+		}
+
 		isprintf(rmStr, 5, "%d", rmCount);
 		writeMemoNote("[i] integrity rules removed", rmStr);
 		if (sdr_end_xn(sdr) < 0)
@@ -293,6 +310,11 @@ rules cleared.");
 			}
 		}
 
+		if (rmCount > 0)
+		{
+			noteRulesChange();
+		}
+
 		isprintf(rmStr, 5, "%d", rmCount);
 		writeMemoNote("[i] confidentiality rules removed", rmStr);
 		if (sdr_end_xn(sdr) < 0)
@@ -310,6 +332,315 @@ confidentiality rules cleared.");
 	return;
 }
 
+/*		BPsec rule index					*/
+
+/*	Every bundle sourced, forwarded, or delivered is checked
+ *	against all BIB and BCB rules, so each process keeps a
+ *	private index of the rules compiled from the SDR rule lists.
+ *	Every rule EID is a prefix terminated by the '~' wild card,
+ *	so the index sorts the rules by the length of the prefix of
+ *	the security destination EID and then by that prefix; the
+ *	rules whose destinations match a given EID are found by one
+ *	binary search per distinct prefix length, and only those
+ *	rules' security source EIDs are then compared.  The index is
+ *	rebuilt whenever the rulesVersion in the security vdb shows
+ *	that some process has changed the rules.  Because the index
+ *	belongs to a single process, it is allocated from the
+ *	private heap rather than from ION's shared working memory,
+ *	so it simply goes away when the process terminates.	*/
+
+typedef struct
+{
+	Object		ruleObj;
+	int		ordinal;	/*	Position in rule list.	*/
+	int		prefixLen;	/*	-1 if no wild card.	*/
+	int		srcEidLen;
+	int		destEidLen;
+	char		*srcEid;
+	char		*destEid;
+} IndexedRule;
+
+typedef struct
+{
+	int		prefixLen;
+	int		first;		/*	Index into rules.	*/
+	int		count;
+} RuleGroup;
+
+typedef struct
+{
+	int		built;
+	unsigned int	version;
+	int		ruleCount;
+	IndexedRule	*rules;
+	int		groupCount;
+	RuleGroup	*groups;
+} RuleIndex;
+
+static int	compareIndexedRules(const void *a, const void *b)
+{
+	IndexedRule	*r1 = (IndexedRule *) a;
+	IndexedRule	*r2 = (IndexedRule *) b;
+	int		result;
+
+	if (r1->prefixLen != r2->prefixLen)
+	{
+		return (r1->prefixLen < r2->prefixLen ? -1 : 1);
+	}
+
+	result = strcmp(r1->destEid, r2->destEid);
+	if (result != 0)
+	{
+		return result;
+	}
+
+	return (r1->ordinal < r2->ordinal ? -1 : 1);
+}
+
+static void	clearRuleIndex(RuleIndex *index)
+{
+	int	i;
+
+	for (i = 0; i < index->ruleCount; i++)
+	{
+		if (index->rules[i].srcEid)
+		{
+			free(index->rules[i].srcEid);
+		}
+
+		if (index->rules[i].destEid)
+		{
+			free(index->rules[i].destEid);
+		}
+	}
+
+	if (index->rules)
+	{
+		free(index->rules);
+	}
+
+	if (index->groups)
+	{
+		free(index->groups);
+	}
+
+	memset((char *) index, 0, sizeof(RuleIndex));
+}
+
+static char	*copyRuleEid(Object eidObj, int *length)
+{
+	Sdr	sdr = getIonsdr();
+	char	eidBuffer[SDRSTRING_BUFSZ];
+	char	*eid;
+
+	*length = sdr_string_read(sdr, eidBuffer, eidObj);
+	if (*length < 1)
+	{
+		return NULL;
+	}
+
+	eid = malloc(*length + 1);
+	if (eid)
+	{
+		memcpy(eid, eidBuffer, *length + 1);
+	}
+
+	return eid;
+}
+
+static int	buildRuleIndex(RuleIndex *index, Object rules)
+{
+	Sdr		sdr = getIonsdr();
+	Object		elt;
+	int		ordinal;
+	IndexedRule	*rule;
+	BPsecBibRule	ruleBuf;	/*	BCB rule layout is same.*/
+	int		i;
+
+	clearRuleIndex(index);
+	index->ruleCount = sdr_list_length(sdr, rules);
+	if (index->ruleCount > 0)
+	{
+		index->rules = (IndexedRule *) malloc(index->ruleCount
+				* sizeof(IndexedRule));
+		index->groups = (RuleGroup *) malloc(index->ruleCount
+				* sizeof(RuleGroup));
+		if (index->rules == NULL || index->groups == NULL)
+		{
+			index->ruleCount = 0;
+			clearRuleIndex(index);
+			putErrmsg("Can't allocate BPsec rule index.", NULL);
+			return -1;
+		}
+
+		memset((char *) index->rules, 0, index->ruleCount
+				* sizeof(IndexedRule));
+	}
+
+	for (elt = sdr_list_first(sdr, rules), ordinal = 0; elt;
+			elt = sdr_list_next(sdr, elt), ordinal++)
+	{
+		rule = index->rules + ordinal;
+		rule->ruleObj = sdr_list_data(sdr, elt);
+		rule->ordinal = ordinal;
+		sdr_read(sdr, (char *) &ruleBuf, rule->ruleObj,
+				sizeof(BPsecBibRule));
+		rule->srcEid = copyRuleEid(ruleBuf.securitySrcEid,
+				&rule->srcEidLen);
+		rule->destEid = copyRuleEid(ruleBuf.destEid,
+				&rule->destEidLen);
+		if (rule->srcEid == NULL || rule->destEid == NULL)
+		{
+			index->ruleCount = ordinal + 1;
+			clearRuleIndex(index);
+			putErrmsg("Can't index BPsec rule.", NULL);
+			return -1;
+		}
+
+		if (rule->destEid[rule->destEidLen - 1] == '~')
+		{
+			rule->prefixLen = rule->destEidLen - 1;
+		}
+		else
+		{
+			rule->prefixLen = -1;
+		}
+	}
+
+	qsort(index->rules, index->ruleCount, sizeof(IndexedRule),
+			compareIndexedRules);
+	for (i = 0; i < index->ruleCount; i++)
+	{
+		if (index->groupCount == 0 || index->rules[i].prefixLen
+			!= index->groups[index->groupCount - 1].prefixLen)
+		{
+			index->groups[index->groupCount].prefixLen =
+					index->rules[i].prefixLen;
+			index->groups[index->groupCount].first = i;
+			index->groups[index->groupCount].count = 0;
+			index->groupCount++;
+		}
+
+		index->groups[index->groupCount - 1].count++;
+	}
+
+	index->built = 1;
+	return 0;
+}
+
+static Object	nextIndexedRule(RuleIndex *index, Object rules,
+			char *srcEid, char *destEid, int *cursor)
+{
+	SecVdb		*secvdb = getSecVdb();
+	int		srcEidLen;
+	int		destEidLen;
+	int		scanAll;
+	IndexedRule	*best = NULL;
+	RuleGroup	*group;
+	int		g;
+	int		cmpLen;
+	int		lo;
+	int		hi;
+	int		mid;
+	IndexedRule	*rule;
+
+	CHKZERO(srcEid);
+	CHKZERO(destEid);
+	CHKZERO(cursor);
+	if (secvdb == NULL || rules == 0)
+	{
+		return 0;	/*	No security database.		*/
+	}
+
+	if (!index->built || index->version != secvdb->rulesVersion)
+	{
+		if (buildRuleIndex(index, rules) < 0)
+		{
+			putErrmsg("Can't rebuild BPsec rule index.", NULL);
+			return ((Object) ERROR);
+		}
+
+		index->version = secvdb->rulesVersion;
+	}
+
+	srcEidLen = istrlen(srcEid, SDRSTRING_BUFSZ);
+	destEidLen = istrlen(destEid, SDRSTRING_BUFSZ);
+	if (srcEidLen < 1 || destEidLen < 1)
+	{
+		return 0;
+	}
+
+	/*	A wild-carded destination EID would match rules in
+	 *	every group; just check every rule in that case.	*/
+
+	scanAll = (destEid[destEidLen - 1] == '~');
+	for (g = 0; g < index->groupCount; g++)
+	{
+		group = index->groups + g;
+		lo = group->first;
+		hi = group->first + group->count;
+		if (!scanAll && group->prefixLen > 0)
+		{
+			/*	Find the first rule whose destination
+			 *	prefix matches destEid, as eidsMatch
+			 *	would compare them.			*/
+
+			cmpLen = MIN(group->prefixLen, destEidLen);
+			while (lo < hi)
+			{
+				mid = (lo + hi) / 2;
+				if (strncmp(index->rules[mid].destEid, destEid,
+						cmpLen) < 0)
+				{
+					lo = mid + 1;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
+
+			hi = group->first + group->count;
+		}
+		else
+		{
+			cmpLen = 0;
+		}
+
+		for (; lo < hi; lo++)
+		{
+			rule = index->rules + lo;
+			if (cmpLen > 0 && strncmp(rule->destEid, destEid,
+					cmpLen) != 0)
+			{
+				break;	/*	Past all matching rules.*/
+			}
+
+			if (rule->ordinal <= *cursor
+			|| (best && rule->ordinal > best->ordinal))
+			{
+				continue;
+			}
+
+			if (eidsMatch(rule->destEid, rule->destEidLen, destEid,
+					destEidLen)
+			&& eidsMatch(rule->srcEid, rule->srcEidLen, srcEid,
+					srcEidLen))
+			{
+				best = rule;
+			}
+		}
+	}
+
+	if (best == NULL)
+	{
+		return 0;
+	}
+
+	*cursor = best->ordinal;
+	return best->ruleObj;
+}
+
 /*		Block Integrity Block Support				*/
 
 void	sec_get_bpsecBibRule(char *secSrcEid, char *secDestEid,
@@ -479,6 +810,7 @@ int	sec_addBPsecBibRule(char *secSrcEid, char *secDestEid,
 	}
 
 	elt = sdr_list_insert_last(sdr, secdb->bpsecBibRules,ruleObj);
+	noteRulesChange();
 	sdr_write(sdr, ruleObj, (char *) &rule, sizeof(BPsecBibRule));
 	if (sdr_end_xn(sdr) < 0)
 	{
@@ -600,6 +932,7 @@ int	sec_removeBPsecBibRule(char *secSrcEid, char *secDestEid,
 
 	CHKERR(sdr_begin_xn(sdr));
 	sdr_list_delete(sdr, elt, NULL, NULL);
+	noteRulesChange();
 	GET_OBJ_POINTER(sdr, BPsecBibRule, rule, ruleObj);
 	sdr_free(sdr, rule->securitySrcEid);
 	sdr_free(sdr, rule->destEid);
@@ -782,6 +1115,7 @@ int	sec_addBPsecBcbRule(char *secSrcEid, char *secDestEid,
 	}
 
 	elt = sdr_list_insert_last(sdr, secdb->bpsecBcbRules,ruleObj);
+	noteRulesChange();
 
 	sdr_write(sdr, ruleObj, (char *) &rule, sizeof(BPsecBcbRule));
 	if (sdr_end_xn(sdr) < 0)
@@ -907,6 +1241,7 @@ int	sec_removeBPsecBcbRule(char *secSrcEid, char *secDestEid,
 
 	CHKERR(sdr_begin_xn(sdr));
 	sdr_list_delete(sdr, elt, NULL, NULL);
+	noteRulesChange();
 	GET_OBJ_POINTER(sdr, BPsecBcbRule, rule, ruleObj);
 	sdr_free(sdr, rule->securitySrcEid);
 	sdr_free(sdr, rule->destEid);
@@ -946,6 +1281,22 @@ Object sec_get_bpsecBcbRuleList()
 	return secdb->bpsecBcbRules;
 }
 
+Object	sec_next_bpsecBibRule(char *srcEid, char *destEid, int *cursor)
+{
+	static RuleIndex	bibIndex;
+
+	return nextIndexedRule(&bibIndex, sec_get_bpsecBibRuleList(), srcEid,
+			destEid, cursor);
+}
+
+Object	sec_next_bpsecBcbRule(char *srcEid, char *destEid, int *cursor)
+{
+	static RuleIndex	bcbIndex;
+
+	return nextIndexedRule(&bcbIndex, sec_get_bpsecBcbRuleList(), srcEid,
+			destEid, cursor);
+}
+
 /* Size is the maximum size of a key name. */
 int	sec_get_bpsecNumKeys(int *size)
 {
@@ -201,6 +201,28 @@ typedef struct
 	 *	of the contact graph to the first contact in "hops".	*/
 } CgrRoute;
 
+typedef struct
+{
+	/*	A cached forwarding decision: the route that was
+	 *	selected for the last bundle of this class (priority,
+	 *	ordinal, size class, fragmentability) sent toward
+	 *	the routing object's node.  It is reused, after
+	 *	re-checking that route alone for the new bundle, as
+	 *	long as the contact plan is unchanged, the route has
+	 *	not ended, and the route's projected bundle arrival
+	 *	time is unaffected by the volume committed to its
+	 *	contacts since the decision was made.			*/
+
+	int		priority;
+	int		ordinal;
+	int		sizeClass;	/*	log2 of bundle size.	*/
+	int		doNotFragment;	/*	Boolean.		*/
+	unsigned int	planVersion;	/*	IonVdb's, when made.	*/
+	PsmAddress	routeAddr;	/*	CgrRoute.		*/
+	time_t		toTime;		/*	Route's, when made.	*/
+	time_t		pbat;		/*	Route's, when made.	*/
+} CgrDecision;
+
 typedef struct
 {
 	/*	ION supports the concept that different endpoints in
@@ -233,13 +255,19 @@ typedef struct
 	 *	passageway nodes (ultimately just one) through which
 	 *	a bundle destined for this remote node should be
 	 *	forwarded in the event that the node is in some
-	 *	foreign region.						*/
+	 *	foreign region.
+	 *
+	 *	Finally, unless libcgr is built with CGR_ROUTE_CACHE
+	 *	zero, the CgrRtgObject contains the list of forwarding
+	 *	decisions cached for bundles destined for the remote
+	 *	node.							*/
 
 	PsmAddress	nodeAddr;	/*	Back-reference.		*/
 	PsmAddress	selectedRoutes;	/*	SmList of CgrRoute.	*/
 	PsmAddress	knownRoutes;	/*	SmList of CgrRoute.	*/
 	PsmAddress	proximateNodes;	/*	SmList of uvast node#s.	*/
 	PsmAddress	viaPassageways;	/*	SmList of uvast node#s.	*/
+	PsmAddress	decisions;	/*	SmList of CgrDecision.	*/
 } CgrRtgObject;	/*	IonNode's routingObject is one of these.	*/
 
 /*		Data structure for the CGR volatile database.		*/
@@ -259,6 +287,13 @@ typedef struct
 	 *	remote destination node that has got a routing object.	*/
 
 	PsmAddress	routingObjects;	/*	SmList of CgrRtgObject.	*/
+
+	/*	Each Dijkstra search of the contact graph begins a new
+	 *	epoch; a contact's work area is reset upon the first
+	 *	reference to it in the epoch, rather than clearing all
+	 *	work areas before every search.				*/
+
+	unsigned int	workEpoch;
 } CgrVdb;
 
 extern void		cgr_start();
@@ -224,6 +224,7 @@ static int	noteContactAcquired(uvast discoveryNodeNbr,
 		neighbor->xmitRate = xmitRate;
 		toggleScheduledContacts(ownNodeNbr, discoveryNodeNbr,
 				CtScheduled, CtSuppressed);
+		rfx_contacts_revised();
 		CHKERR(sdr_end_xn(sdr) == 0);
 	}
 
@@ -277,6 +278,7 @@ static int	noteContactAcquired(uvast discoveryNodeNbr,
 		neighbor->recvRate = recvRate;
 		toggleScheduledContacts(discoveryNodeNbr, ownNodeNbr,
 				CtScheduled, CtSuppressed);
+		rfx_contacts_revised();
 		CHKERR(sdr_end_xn(sdr) == 0);
 	}
 
@@ -577,6 +579,7 @@ static int	noteContactLost(uvast discoveryNodeNbr, time_t startTime)
 			neighbor->xmitRate = 0;
 			toggleScheduledContacts(ownNodeNbr, discoveryNodeNbr,
 					CtSuppressed, CtScheduled);
+			rfx_contacts_revised();
 			CHKERR(sdr_end_xn(sdr) == 0);
 		}
 	}
@@ -632,6 +635,7 @@ static int	noteContactLost(uvast discoveryNodeNbr, time_t startTime)
 			neighbor->recvRate = 0;
 			toggleScheduledContacts(discoveryNodeNbr, ownNodeNbr,
 					CtSuppressed, CtScheduled);
+			rfx_contacts_revised();
 			CHKERR(sdr_end_xn(sdr) == 0);
 		}
 	}
@@ -1729,8 +1729,9 @@ static int	bcbAttachAll(Bundle *bundle, size_t xmitRate)
 int	bpsec_encrypt(Bundle *bundle)
 {
 	Sdr			sdr = getIonsdr();
-	Object			rules;
-	Object			elt;
+	char			srcEid[SDRSTRING_BUFSZ];
+	char			destEid[SDRSTRING_BUFSZ];
+	int			cursor = -1;
 	Object			ruleObj;
 	BPsecBcbRule		rule;
 	BcbProfile		*prof;
@@ -1751,14 +1752,23 @@ int	bpsec_encrypt(Bundle *bundle)
 	 *	could pass that value directly to bpsec_encrypt
 	 *	as an API parameter.					*/
 
-	rules = sec_get_bpsecBcbRuleList();
+	if (bpsec_getRuleEids(bundle, srcEid, destEid) < 0)
+	{
+		return -1;
+	}
 
 	/*	Apply all applicable BCB rules.				*/
 
-	for (elt = sdr_list_first(sdr, rules); elt;
-			elt = sdr_list_next(sdr, elt))
+	for (ruleObj = sec_next_bpsecBcbRule(srcEid, destEid, &cursor);
+			ruleObj; ruleObj = sec_next_bpsecBcbRule(srcEid,
+			destEid, &cursor))
 	{
-		ruleObj = sdr_list_data(sdr, elt);
+		if (ruleObj == (Object) ERROR)
+		{
+			putErrmsg("Can't find applicable BCB rules.", NULL);
+			return -1;
+		}
+
 		sdr_read(sdr, (char *) &rule, ruleObj, sizeof(BPsecBcbRule));
 		if (rule.blockType == PrimaryBlk
 		|| rule.blockType == BlockIntegrityBlk
@@ -1774,11 +1784,6 @@ int	bpsec_encrypt(Bundle *bundle)
 			continue;
 		}
 
-		if (!bpsec_BcbRuleApplies(bundle, &rule))
-		{
-			continue;
-		}
-
 		prof = get_bcb_prof_by_name(rule.profileName);
 		if (prof == NULL)
 		{
@@ -2030,8 +2035,9 @@ int	bpsec_decrypt(AcqWorkArea *work)
 {
 	Sdr			sdr = getIonsdr();
 	Bundle			*bundle = &(work->bundle);
-	Object			rules;
-	Object			elt;
+	char			srcEid[SDRSTRING_BUFSZ];
+	char			destEid[SDRSTRING_BUFSZ];
+	int			cursor = -1;
 	Object			ruleObj;
 	BPsecBcbRule		rule;
 	BcbProfile		*prof;
@@ -2050,14 +2056,23 @@ int	bpsec_decrypt(AcqWorkArea *work)
 	int			result;
 	AcqExtBlock		*bib;
 
-	rules = sec_get_bpsecBcbRuleList();
+	if (bpsec_getRuleEids(bundle, srcEid, destEid) < 0)
+	{
+		return -1;
+	}
 
 	/*	Apply all applicable BCB rules.				*/
 
-	for (elt = sdr_list_first(sdr, rules); elt;
-			elt = sdr_list_next(sdr, elt))
+	for (ruleObj = sec_next_bpsecBcbRule(srcEid, destEid, &cursor);
+			ruleObj; ruleObj = sec_next_bpsecBcbRule(srcEid,
+			destEid, &cursor))
 	{
-		ruleObj = sdr_list_data(sdr, elt);
+		if (ruleObj == (Object) ERROR)
+		{
+			putErrmsg("Can't find applicable BCB rules.", NULL);
+			return -1;
+		}
+
 		sdr_read(sdr, (char *) &rule, ruleObj, sizeof(BPsecBibRule));
 		if (rule.blockType == PrimaryBlk
 		|| rule.blockType == BlockIntegrityBlk
@@ -2073,11 +2088,6 @@ int	bpsec_decrypt(AcqWorkArea *work)
 			continue;
 		}
 
-		if (!bpsec_BcbRuleApplies(bundle, &rule))
-		{
-			continue;
-		}
-
 		prof = get_bcb_prof_by_name(rule.profileName);
 		if (prof == NULL)
 		{
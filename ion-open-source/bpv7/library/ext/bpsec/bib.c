@@ -859,8 +859,9 @@ static int	bibAttachAll(Bundle *bundle)
 int	bpsec_sign(Bundle *bundle)
 {
 	Sdr			sdr = getIonsdr();
-	Object			rules;
-	Object			elt;
+	char			srcEid[SDRSTRING_BUFSZ];
+	char			destEid[SDRSTRING_BUFSZ];
+	int			cursor = -1;
 	Object			ruleObj;
 	BPsecBibRule		rule;
 	BibProfile		*prof;
@@ -873,14 +874,23 @@ int	bpsec_sign(Bundle *bundle)
 	Object			blockObj;
 	ExtensionBlock		block;
 
-	rules = sec_get_bpsecBibRuleList();
+	if (bpsec_getRuleEids(bundle, srcEid, destEid) < 0)
+	{
+		return -1;
+	}
 
 	/*	Apply all applicable BIB rules.				*/
 
-	for (elt = sdr_list_first(sdr, rules); elt;
-			elt = sdr_list_next(sdr, elt))
+	for (ruleObj = sec_next_bpsecBibRule(srcEid, destEid, &cursor);
+			ruleObj; ruleObj = sec_next_bpsecBibRule(srcEid,
+			destEid, &cursor))
 	{
-		ruleObj = sdr_list_data(sdr, elt);
+		if (ruleObj == (Object) ERROR)
+		{
+			putErrmsg("Can't find applicable BIB rules.", NULL);
+			return -1;
+		}
+
 		sdr_read(sdr, (char *) &rule, ruleObj, sizeof(BPsecBibRule));
 		if (rule.blockType == BlockIntegrityBlk
 		|| rule.blockType == BlockConfidentialityBlk)
@@ -892,11 +902,6 @@ int	bpsec_sign(Bundle *bundle)
 			continue;
 		}
 
-		if (!bpsec_BibRuleApplies(bundle, &rule))
-		{
-			continue;
-		}
-
 		prof = get_bib_prof_by_name(rule.profileName);
 		if (prof == NULL)
 		{
@@ -1173,8 +1178,9 @@ int	bpsec_verify(AcqWorkArea *work)
 {
 	Sdr			sdr = getIonsdr();
 	Bundle			*bundle = &(work->bundle);
-	Object			rules;
-	Object			elt;
+	char			srcEid[SDRSTRING_BUFSZ];
+	char			destEid[SDRSTRING_BUFSZ];
+	int			cursor = -1;
 	Object			ruleObj;
 	BPsecBibRule		rule;
 	BibProfile		*prof;
@@ -1192,14 +1198,23 @@ int	bpsec_verify(AcqWorkArea *work)
 	int			result;
 	uvast			length = 0;
 
-	rules = sec_get_bpsecBibRuleList();
+	if (bpsec_getRuleEids(bundle, srcEid, destEid) < 0)
+	{
+		return -1;
+	}
 
 	/*	Apply all applicable BIB rules.				*/
 
-	for (elt = sdr_list_first(sdr, rules); elt;
-			elt = sdr_list_next(sdr, elt))
+	for (ruleObj = sec_next_bpsecBibRule(srcEid, destEid, &cursor);
+			ruleObj; ruleObj = sec_next_bpsecBibRule(srcEid,
+			destEid, &cursor))
 	{
-		ruleObj = sdr_list_data(sdr, elt);
+		if (ruleObj == (Object) ERROR)
+		{
+			putErrmsg("Can't find applicable BIB rules.", NULL);
+			return -1;
+		}
+
 		sdr_read(sdr, (char *) &rule, ruleObj, sizeof(BPsecBibRule));
 		if (rule.blockType == BlockIntegrityBlk
 		|| rule.blockType == BlockConfidentialityBlk)
@@ -1211,11 +1226,6 @@ int	bpsec_verify(AcqWorkArea *work)
 			continue;
 		}
 
-		if (!bpsec_BibRuleApplies(bundle, &rule))
-		{
-			continue;
-		}
-
 		prof = get_bib_prof_by_name(rule.profileName);
 		if (prof == NULL)
 		{
@@ -1154,6 +1154,50 @@ int	bpsec_BcbRuleApplies(Bundle *bundle, BPsecBcbRule *rule)
 	return result;
 }
 
+/******************************************************************************
+ *
+ * \par Function Name: bpsec_getRuleEids
+ *
+ * \par Purpose: Copies the source and destination EIDs of a bundle into
+ *		buffers of length SDRSTRING_BUFSZ, for matching against
+ *		BPsec rules by sec_next_bpsecBibRule and
+ *		sec_next_bpsecBcbRule.
+ *
+ * \retval int -- 0 - The EIDs were copied.
+ *		 -1 - System error.
+ *
+ * \param[in]	bundle	The bundle whose EIDs are wanted.
+ * \param[out]	srcEid	The bundle's source EID.
+ *		destEid	The bundle's destination EID.
+ *
+ * \par Notes:
+ *****************************************************************************/
+
+int	bpsec_getRuleEids(Bundle *bundle, char *srcEid, char *destEid)
+{
+	char	*eid;
+
+	readEid(&(bundle->id.source), &eid);
+	if (eid == NULL)
+	{
+		putErrmsg("Can't read bundle source EID.", NULL);
+		return -1;
+	}
+
+	istrcpy(srcEid, eid, SDRSTRING_BUFSZ);
+	MRELEASE(eid);
+	readEid(&(bundle->destination), &eid);
+	if (eid == NULL)
+	{
+		putErrmsg("Can't read bundle destination EID.", NULL);
+		return -1;
+	}
+
+	istrcpy(destEid, eid, SDRSTRING_BUFSZ);
+	MRELEASE(eid);
+	return 0;
+}
+
 /******************************************************************************
  *
  * \par Function Name: bpsec_destinationIsLocal
@@ -304,6 +304,8 @@ extern int		bpsec_deserializeASB(AcqExtBlock *blk, AcqWorkArea *wk);
 
 extern int		bpsec_BibRuleApplies(Bundle *bundle, BPsecBibRule *r);
 extern int		bpsec_BcbRuleApplies(Bundle *bundle, BPsecBcbRule *r);
+extern int		bpsec_getRuleEids(Bundle *bundle, char *srcEid,
+				char *destEid);
 
 extern int		bpsec_destinationIsLocal(Bundle *bundle);
 
@@ -747,34 +747,75 @@ static void	resetPlan(VPlan *vplan)
 	vplan->clmPid = ERROR;
 }
 
+/*	The VPlans in the volatile database are indexed by two
+ *	red-black trees.  The nodes of both trees have as their data
+ *	the addresses of the elements of the bpvdb->plans list that
+ *	reference the VPlans.  planIndex is ordered by neighbor EID
+ *	and contains all plans; ipnPlanIndex is ordered by neighbor
+ *	node number and contains only the plans whose neighbor EIDs
+ *	are of the form "ipn:<node number>.0".				*/
+
+static int	orderPlansByEid(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	VPlan	*vplan;
+
+	vplan = (VPlan *) psp(partition, sm_list_data(partition, nodeData));
+	return strcmp(vplan->neighborEid, (char *) dataBuffer);
+}
+
+static int	orderPlansByNodeNbr(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	VPlan	*vplan;
+	uvast	nodeNbr = *((uvast *) dataBuffer);
+
+	vplan = (VPlan *) psp(partition, sm_list_data(partition, nodeData));
+	if (vplan->neighborNodeNbr < nodeNbr)
+	{
+		return -1;
+	}
+
+	if (vplan->neighborNodeNbr > nodeNbr)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static int	isIpnNodePlan(VPlan *vplan)
+{
+	char	eid[MAX_EID_LEN + 1];
+
+	if (vplan->neighborNodeNbr == 0)
+	{
+		return 0;
+	}
+
+	isprintf(eid, sizeof eid, "ipn:" UVAST_FIELDSPEC ".0",
+			vplan->neighborNodeNbr);
+	return (strcmp(vplan->neighborEid, eid) == 0);
+}
+
 static int	raisePlan(Object planElt, BpVdb *bpvdb)
 {
 	Sdr		sdr = getIonsdr();
 	PsmPartition	bpwm = getIonwm();
 	Object		planObj;
 	BpPlan		plan;
+	PsmAddress	node;
+	PsmAddress	successor;
 	PsmAddress	elt;
 	VPlan		*vplan;
-	int		result;
 	PsmAddress	addr;
 
 	planObj = sdr_list_data(sdr, planElt);
 	sdr_read(sdr, (char *) &plan, planObj, sizeof(BpPlan));
-	for (elt = sm_list_first(bpwm, bpvdb->plans); elt;
-			elt = sm_list_next(bpwm, elt))
+	node = sm_rbt_search(bpwm, bpvdb->planIndex, orderPlansByEid,
+			plan.neighborEid, &successor);
+	if (node)
 	{
-		vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, elt));
-		result = strcmp(vplan->neighborEid, plan.neighborEid);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)		/*	Insert before this one.	*/
-		{
-			break;		/*	Same as end of list.	*/
-		}
-
 		return 0;		/*	Already raised.		*/
 	}
 
@@ -784,9 +825,14 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 		return -1;
 	}
 
-	if (elt)
+	/*	The plans list is kept in EID order, so insert the
+	 *	new plan before the plan whose EID is its successor
+	 *	in the index, if any.					*/
+
+	if (successor)
 	{
-		elt = sm_list_insert_before(bpwm, elt, addr);
+		elt = sm_list_insert_before(bpwm, sm_rbt_data(bpwm, successor),
+				addr);
 	}
 	else
 	{
@@ -806,6 +852,28 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 	vplan->updateStats = plan.updateStats;
 	istrcpy(vplan->neighborEid, plan.neighborEid, sizeof plan.neighborEid);
 	vplan->neighborNodeNbr = plan.neighborNodeNbr;
+	if (sm_rbt_insert(bpwm, bpvdb->planIndex, elt, orderPlansByEid,
+			vplan->neighborEid) == 0)
+	{
+		oK(sm_list_delete(bpwm, elt, NULL, NULL));
+		psm_free(bpwm, addr);
+		return -1;
+	}
+
+	if (isIpnNodePlan(vplan))
+	{
+		if (sm_rbt_insert(bpwm, bpvdb->ipnPlanIndex, elt,
+				orderPlansByNodeNbr,
+				&(vplan->neighborNodeNbr)) == 0)
+		{
+			sm_rbt_delete(bpwm, bpvdb->planIndex, orderPlansByEid,
+					vplan->neighborEid, NULL, NULL);
+			oK(sm_list_delete(bpwm, elt, NULL, NULL));
+			psm_free(bpwm, addr);
+			return -1;
+		}
+	}
+
 	vplan->semaphore = SM_SEM_NONE;
 	vplan->xmitThrottle.nominalRate = plan.nominalRate;
 	vplan->xmitThrottle.capacity = plan.nominalRate;
@@ -816,9 +884,18 @@ static int	raisePlan(Object planElt, BpVdb *bpvdb)
 static void	dropPlan(VPlan *vplan, PsmAddress vplanElt)
 {
 	PsmPartition	bpwm = getIonwm();
+	BpVdb		*bpvdb = _bpvdb(NULL);
 	PsmAddress	vplanAddr;
 
 	vplanAddr = sm_list_data(bpwm, vplanElt);
+	if (isIpnNodePlan(vplan))
+	{
+		sm_rbt_delete(bpwm, bpvdb->ipnPlanIndex, orderPlansByNodeNbr,
+				&(vplan->neighborNodeNbr), NULL, NULL);
+	}
+
+	sm_rbt_delete(bpwm, bpvdb->planIndex, orderPlansByEid,
+			vplan->neighborEid, NULL, NULL);
 	if (vplan->semaphore != SM_SEM_NONE)
 	{
 		sm_SemEnd(vplan->semaphore);
@@ -1270,6 +1347,8 @@ static BpVdb	*_bpvdb(char **name)
 		vdb->watching = db->watching;
 		if ((vdb->schemes = sm_list_create(wm)) == 0
 		|| (vdb->plans = sm_list_create(wm)) == 0
+		|| (vdb->planIndex = sm_rbt_create(wm)) == 0
+		|| (vdb->ipnPlanIndex = sm_rbt_create(wm)) == 0
 		|| (vdb->inducts = sm_list_create(wm)) == 0
 		|| (vdb->outducts = sm_list_create(wm)) == 0
 		|| (vdb->discoveries = sm_list_create(wm)) == 0
@@ -1516,6 +1595,8 @@ static void	dropVdb(PsmPartition wm, PsmAddress vdbAddress)
 	}
 
 	sm_list_destroy(wm, vdb->plans, NULL, NULL);
+	sm_rbt_destroy(wm, vdb->planIndex, NULL, NULL);
+	sm_rbt_destroy(wm, vdb->ipnPlanIndex, NULL, NULL);
 	while ((elt = sm_list_first(wm, vdb->inducts)) != 0)
 	{
 		vinduct = (VInduct *) psp(wm, sm_list_data(wm, elt));
@@ -3789,8 +3870,7 @@ void	findPlan(char *eidIn, VPlan **vplan, PsmAddress *vplanElt)
 {
 	PsmPartition	bpwm = getIonwm();
 	char		eid[SDRSTRING_BUFSZ];
-	PsmAddress	elt;
-	int		result;
+	PsmAddress	node;
 
 	CHKVOID(vplanElt);
 	*vplanElt = 0;			/*	Default.		*/
@@ -3803,29 +3883,41 @@ void	findPlan(char *eidIn, VPlan **vplan, PsmAddress *vplanElt)
 
 	/*	This function locates the volatile egress plan
 	 *	object identified by the specified endpoint ID,
-	 *	if any; must be an exact match.  (Note that BpPlans
-	 *	are *not* ordered alphabetically by EID; only the
-	 *	VPlans in the volatile database are.)			*/
+	 *	if any; must be an exact match.				*/
 
-	for (elt = sm_list_first(bpwm, (_bpvdb(NULL))->plans); elt;
-			elt = sm_list_next(bpwm, elt))
+	node = sm_rbt_search(bpwm, (_bpvdb(NULL))->planIndex,
+			orderPlansByEid, eid, NULL);
+	if (node)
 	{
-		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, elt));
-		result = strcmp((*vplan)->neighborEid, eid);
-		if (result < 0)
-		{
-			continue;
-		}
+		*vplanElt = sm_rbt_data(bpwm, node);
+		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, *vplanElt));
+	}
+}
 
-		if (result == 0)	/*	Found matching plan.	*/
-		{
-			*vplanElt = elt;
-		}
+void	findIpnPlan(uvast nodeNbr, VPlan **vplan, PsmAddress *vplanElt)
+{
+	PsmPartition	bpwm = getIonwm();
+	PsmAddress	node;
 
-		/*	One way or another, the search is now done.	*/
+	/*	This function locates the volatile egress plan
+	 *	object whose neighbor EID is "ipn:<nodeNbr>.0", if
+	 *	any, without formatting that EID string.		*/
 
+	CHKVOID(vplanElt);
+	*vplanElt = 0;			/*	Default.		*/
+	CHKVOID(vplan);
+	if (nodeNbr == 0)
+	{
 		return;
 	}
+
+	node = sm_rbt_search(bpwm, (_bpvdb(NULL))->ipnPlanIndex,
+			orderPlansByNodeNbr, &nodeNbr, NULL);
+	if (node)
+	{
+		*vplanElt = sm_rbt_data(bpwm, node);
+		*vplan = (VPlan *) psp(bpwm, sm_list_data(bpwm, *vplanElt));
+	}
 }
 
 int	addPlan(char *eidIn, unsigned int nominalRate)
@@ -7111,6 +7203,60 @@ int	bpLoadAcq(AcqWorkArea *work, Object zco)
 	return 0;
 }
 
+static int	startWorkZco(Sdr sdr, BpDB *bpdb, AcqWorkArea *work)
+{
+	/*	Creates the ZCO into which the first extent of a
+	 *	new acquisition will be appended.			*/
+
+	work->zco = zco_create(sdr, ZcoSdrSource, 0, 0, 0, ZcoInbound);
+	if (work->zco == (Object) ERROR)
+	{
+		putErrmsg("Can't start inbound bundle ZCO.", NULL);
+		return -1;
+	}
+
+	work->zcoElt = sdr_list_insert_last(sdr, bpdb->inboundBundles,
+			work->zco);
+	if (work->zcoElt == 0)
+	{
+		putErrmsg("Can't start inbound bundle ZCO.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	appendHeapExtent(Sdr sdr, AcqWorkArea *work, char *bytes,
+			int length)
+{
+	Object	extentObj;
+
+	/*	ZCO space for this extent must already have been
+	 *	awarded to the caller.					*/
+
+	extentObj = sdr_insert(sdr, bytes, length);
+	if (extentObj)
+	{
+		/*	Pass additive inverse of length to
+		 *	zco_append_extent to indicate that
+		 *	space has already been awarded.			*/
+
+		switch (zco_append_extent(sdr, work->zco, ZcoSdrSource,
+				extentObj, 0, 0 - length))
+		{
+		case ERROR:
+		case 0:
+			putErrmsg("Can't append heap extent.", NULL);
+			return -1;
+
+		default:
+			break;		/*	Out of switch.		*/
+		}
+	}
+
+	return 0;
+}
+
 int	bpContinueAcq(AcqWorkArea *work, char *bytes, int length,
 		ReqAttendant *attendant, unsigned char priority)
 {
@@ -7122,7 +7268,6 @@ int	bpContinueAcq(AcqWorkArea *work, char *bytes, int length,
 	vast			heapSpaceNeeded = 0;
 	vast			fileSpaceNeeded = 0;
 	ReqTicket		ticket;
-	Object			extentObj;
 	char			cwd[200];
 	char			fileName[SDRSTRING_BUFSZ];
 	int			fd;
@@ -7215,20 +7360,8 @@ int	bpContinueAcq(AcqWorkArea *work, char *bytes, int length,
 	CHKERR(sdr_begin_xn(sdr));
 	if (work->zco == 0)	/*	First extent of acquisition.	*/
 	{
-		work->zco = zco_create(sdr, ZcoSdrSource, 0, 0, 0, ZcoInbound);
-		if (work->zco == (Object) ERROR)
+		if (startWorkZco(sdr, bpdb, work) < 0)
 		{
-			putErrmsg("Can't start inbound bundle ZCO.", NULL);
-			sdr_cancel_xn(sdr);
-			ionShred(ticket);	/*	Cancel request.	*/
-			return -1;
-		}
-
-		work->zcoElt = sdr_list_insert_last(sdr, bpdb->inboundBundles,
-				work->zco);
-		if (work->zcoElt == 0)
-		{
-			putErrmsg("Can't start inbound bundle ZCO.", NULL);
 			sdr_cancel_xn(sdr);
 			ionShred(ticket);	/*	Cancel request.	*/
 			return -1;
@@ -7250,26 +7383,11 @@ int	bpContinueAcq(AcqWorkArea *work, char *bytes, int length,
 
 	if (source == ZcoSdrSource)
 	{
-		extentObj = sdr_insert(sdr, bytes, length);
-		if (extentObj)
+		if (appendHeapExtent(sdr, work, bytes, length) < 0)
 		{
-			/*	Pass additive inverse of length to
-			 *	zco_append_extent to indicate that
-			 *	space has already been awarded.		*/
-
-			switch (zco_append_extent(sdr, work->zco, ZcoSdrSource,
-					extentObj, 0, 0 - length))
-			{
-			case ERROR:
-			case 0:
-				putErrmsg("Can't append heap extent.", NULL);
-				sdr_cancel_xn(sdr);
-				ionShred(ticket);	/*	Cancel.	*/
-				return -1;
-
-			default:
-				break;		/*	Out of switch.	*/
-			}
+			sdr_cancel_xn(sdr);
+			ionShred(ticket);	/*	Cancel request.	*/
+			return -1;
 		}
 
 		if (sdr_end_xn(sdr) < 0)
@@ -7773,14 +7891,39 @@ uvast	computeBufferCrc(BpCrcType crcType, unsigned char *buffer,
 	return crc32;
 }
 
+#define	CRC_SCAN_LIMIT	(1 << 30)
+
+typedef struct
+{
+	BpCrcType	crcType;
+	uvast		crc;
+} CrcScan;
+
+static int	addToCrc(char *text, vast length, void *arg)
+{
+	CrcScan	*scan = (CrcScan *) arg;
+	int	bytesToProcess;
+
+	while (length > 0)
+	{
+		bytesToProcess = length > CRC_SCAN_LIMIT ? CRC_SCAN_LIMIT
+				: length;
+		scan->crc = computeBufferCrc(scan->crcType,
+				(unsigned char *) text, bytesToProcess, 0,
+				scan->crc, NULL);
+		text += bytesToProcess;
+		length -= bytesToProcess;
+	}
+
+	return 0;
+}
+
 int	computeZcoCrc(BpCrcType crcType, ZcoReader *reader, int bytesToProcess,
 		uvast *crc, uvast *extractedCrc)
 {
-	char	buffer[10000];
-	int	reloadLimit;
+	char	buffer[5];
+	CrcScan	scan;
 	int	crcSize;
-	int	endOfBlock = 0;
-	int	bytesToReceive;
 	int	bytesReceived;
 
 	if (crcType == X25CRC16)
@@ -7792,38 +7935,32 @@ int	computeZcoCrc(BpCrcType crcType, ZcoReader *reader, int bytesToProcess,
 		crcSize = 5;		/*	CBOR 32-bit integer.	*/
 	}
 
-	reloadLimit = sizeof buffer - crcSize;
-	while (bytesToProcess > 0)
-	{
-		if (bytesToProcess > reloadLimit)
-		{
-			/*	Can't load all remaining data bytes
-			 *	plus CRC in this buffer, so don't
-			 *	load all remaining data bytes.		*/
-
-			bytesToReceive = reloadLimit;
-		}
-		else
-		{
-			/*	Load all remaining data bytes plus CRC.	*/
-
-			endOfBlock = 1;
-			bytesToProcess += crcSize;
-			bytesToReceive = bytesToProcess;
-		}
+	/*	All data bytes are passed to the CRC computation in
+	 *	place, extent by extent, without staging copies.	*/
 
-		bytesReceived = zco_receive_source(getIonsdr(), reader,
-				bytesToReceive, buffer);
-	       	if (bytesReceived != bytesToReceive)
+	scan.crcType = crcType;
+	scan.crc = *crc;
+	if (bytesToProcess > 0)
+	{
+		if (zco_scan_source(getIonsdr(), reader, bytesToProcess,
+				addToCrc, &scan) != bytesToProcess)
 		{
 			return -1;
 		}
+	}
 
-		*crc = computeBufferCrc(crcType, (unsigned char *) buffer,
-				bytesReceived, endOfBlock, *crc, extractedCrc);
-		bytesToProcess -= bytesReceived;
+	/*	Then the CRC itself, which must be extracted and
+	 *	then treated as zero for the CRC computation.		*/
+
+	bytesReceived = zco_receive_source(getIonsdr(), reader, crcSize,
+			buffer);
+	if (bytesReceived != crcSize)
+	{
+		return -1;
 	}
 
+	*crc = computeBufferCrc(crcType, (unsigned char *) buffer,
+			bytesReceived, 1, scan.crc, extractedCrc);
 	return 0;
 }
 
@@ -8438,7 +8575,7 @@ static int	checkPayloadCrc(AcqWorkArea *work)
 	unsigned int	bytesToSkip;
 	unsigned int	bytesSkipped;
 	int		crcSize;
-	uvast		computedCrc;
+	uvast		computedCrc = 0;
 	uvast		extractedCrc;
 	
 	zco_start_receiving(work->zco, &reader);
@@ -9274,6 +9411,141 @@ int	bpEndAcq(AcqWorkArea *work)
 	return eraseWorkZco(work);
 }
 
+static int	acquireEachBundle(AcqWorkArea *work, char **bufs, int *lengths,
+			int count)
+{
+	int	i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (bpBeginAcq(work, 0, NULL) < 0
+		|| bpContinueAcq(work, bufs[i], lengths[i], 0, 0) < 0)
+		{
+			putErrmsg("Can't acquire bundle in batch.", itoa(i));
+			return -1;
+		}
+
+		if (work->zco == 0)
+		{
+			/*	No ZCO space for this bundle, so there
+			 *	is nothing for bpEndAcq to acquire:
+			 *	the bundle is discarded due to
+			 *	congestion and we go on to the next.	*/
+
+			writeMemo("[?] ZCO space is congested; discarding \
+bundle.");
+			bpInductTally(work->vduct, BP_INDUCT_CONGESTIVE,
+					lengths[i]);
+			bpCancelAcq(work);
+			continue;
+		}
+
+		if (bpEndAcq(work) < 0)
+		{
+			putErrmsg("Can't acquire bundle in batch.", itoa(i));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int	bpAcquireBundles(AcqWorkArea *work, char **bufs, int *lengths,
+		int count)
+{
+	Sdr		sdr = getIonsdr();
+			OBJ_POINTER(BpDB, bpdb);
+	vast		heapSpaceNeeded = 0;
+	ReqTicket	ticket;
+	int		i;
+
+	CHKERR(work);
+	CHKERR(bufs);
+	CHKERR(lengths);
+	CHKERR(count >= 0);
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	/*	Total up the heap space needed for the batch.  Any
+	 *	bundle too large to be acquired into the heap must
+	 *	be acquired into a file, so in that case the batch
+	 *	is simply acquired one bundle at a time.		*/
+
+	GET_OBJ_POINTER(sdr, BpDB, bpdb, getBpDbObject());
+	for (i = 0; i < count; i++)
+	{
+		CHKERR(bufs[i]);
+		CHKERR(lengths[i] >= 0);
+		if (lengths[i] > bpdb->maxAcqInHeap)
+		{
+			return acquireEachBundle(work, bufs, lengths, count);
+		}
+
+		heapSpaceNeeded += lengths[i];
+	}
+
+	/*	Reserve ZCO space for the entire batch in a single
+	 *	non-blocking request.  If that space is not currently
+	 *	available, acquire the bundles one at a time instead
+	 *	so that as many of them as possible are accepted; the
+	 *	rest are discarded due to congestion, as by bpEndAcq.	*/
+
+	if (ionRequestZcoSpace(ZcoInbound, 0, 0, heapSpaceNeeded, 0, 0, NULL,
+			&ticket) < 0)
+	{
+		putErrmsg("Failed trying to reserve ZCO space.", NULL);
+		return -1;
+	}
+
+	if (!(ionSpaceAwarded(ticket)))
+	{
+		return acquireEachBundle(work, bufs, lengths, count);
+	}
+
+	/*	Acquire all bundles of the batch in the scope of a
+	 *	single SDR transaction; the transactions of bpEndAcq
+	 *	are nested within this one, so the cost of committing
+	 *	the transaction is incurred only once per batch.	*/
+
+	if (!sdr_begin_xn(sdr))
+	{
+		ionShred(ticket);		/*	Cancel request.	*/
+		return -1;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if (bpBeginAcq(work, 0, NULL) < 0
+		|| startWorkZco(sdr, bpdb, work) < 0
+		|| appendHeapExtent(sdr, work, bufs[i], lengths[i]) < 0
+		|| bpEndAcq(work) < 0)
+		{
+			putErrmsg("Can't acquire bundle in batch.", itoa(i));
+			sdr_cancel_xn(sdr);
+			ionShred(ticket);	/*	Cancel request.	*/
+
+			/*	The acquisition ZCO, if any, was
+			 *	rolled back with the transaction.	*/
+
+			work->zco = 0;
+			work->zcoElt = 0;
+			return -1;
+		}
+	}
+
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("Can't acquire batch of bundles.", itoa(count));
+		ionShred(ticket);		/*	Cancel request.	*/
+		return -1;
+	}
+
+	ionShred(ticket);		/*	Dismiss reservation.	*/
+	return 0;
+}
+
 /*	*	*	Status report functions		*	*	*/
 
 static int	serializeStatusRpt(Bundle *bundle, Object *zco)
@@ -15,6 +15,23 @@
 #ifndef _UDPCLA_H_
 #define _UDPCLA_H_
 
+/*	The UDP_MULTISEND option, as for LTP, enables udpcli to
+ *	receive multiple bundles in a single recvmmsg() call and
+ *	acquire them all at once by bpAcquireBundles(), sharply
+ *	reducing per-bundle system call and SDR transaction overhead
+ *	when the induct is flooded with small bundles.		*/
+
+#ifdef	UDP_MULTISEND
+#if (defined(linux) && !(defined(bionic)))
+#ifndef MULTIRECV_BUFFER_COUNT
+#define	MULTIRECV_BUFFER_COUNT	(32)
+#endif
+#define	_GNU_SOURCE
+#else 	/*	!(defined(linux) && !(defined(bionic)))			*/
+#undef	UDP_MULTISEND
+#endif	/*	End of #if (defined(linux) && !(defined(bionic)))	*/
+#endif	/*	End if #ifdef UDP_MULTISEND				*/
+
 #include "bpP.h"
 #include <pthread.h>
 
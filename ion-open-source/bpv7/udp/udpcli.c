@@ -37,8 +37,169 @@ static void	*handleDatagrams(void *parm)
 	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
 	char			*procName = "udpcli";
 	AcqWorkArea		*work;
-	char			*buffer;
 	int			bundleLength;
+#ifdef UDP_MULTISEND
+	char			*buffers;
+	struct iovec		*iovecs;
+	struct mmsghdr		*msgs;
+	char			**bundles;
+	int			*bundleLengths;
+	int			bundleCount;
+	int			batchLength;
+	int			i;
+
+	snooze(1);	/*	Let main thread become interruptible.	*/
+	work = bpGetAcqArea(rtp->vduct);
+	if (work == NULL)
+	{
+		putErrmsg("udpcli can't get acquisition work area.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	/*	Initialize recvmmsg buffers.				*/
+
+	buffers = MTAKE(UDPCLA_BUFSZ * MULTIRECV_BUFFER_COUNT);
+	if (buffers == NULL)
+	{
+		bpReleaseAcqArea(work);
+		putErrmsg("No space for bundle buffer array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	iovecs = MTAKE(sizeof(struct iovec) * MULTIRECV_BUFFER_COUNT);
+	if (iovecs == NULL)
+	{
+		MRELEASE(buffers);
+		bpReleaseAcqArea(work);
+		putErrmsg("No space for iovec array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	msgs = MTAKE(sizeof(struct mmsghdr) * MULTIRECV_BUFFER_COUNT);
+	if (msgs == NULL)
+	{
+		MRELEASE(iovecs);
+		MRELEASE(buffers);
+		bpReleaseAcqArea(work);
+		putErrmsg("No space for mmsghdr array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	bundles = MTAKE(sizeof(char *) * MULTIRECV_BUFFER_COUNT);
+	if (bundles == NULL)
+	{
+		MRELEASE(msgs);
+		MRELEASE(iovecs);
+		MRELEASE(buffers);
+		bpReleaseAcqArea(work);
+		putErrmsg("No space for bundle pointer array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	bundleLengths = MTAKE(sizeof(int) * MULTIRECV_BUFFER_COUNT);
+	if (bundleLengths == NULL)
+	{
+		MRELEASE(bundles);
+		MRELEASE(msgs);
+		MRELEASE(iovecs);
+		MRELEASE(buffers);
+		bpReleaseAcqArea(work);
+		putErrmsg("No space for bundle length array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	memset(msgs, 0, sizeof(struct mmsghdr) * MULTIRECV_BUFFER_COUNT);
+	for (i = 0; i < MULTIRECV_BUFFER_COUNT; i++)
+	{
+		iovecs[i].iov_base = buffers + (i * UDPCLA_BUFSZ);
+		iovecs[i].iov_len = UDPCLA_BUFSZ;
+		msgs[i].msg_hdr.msg_iov = iovecs + i;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/*	Can now start receiving bundles.  On failure, take
+	 *	down the CLI.						*/
+
+	while (rtp->running)
+	{	
+		batchLength = recvmmsg(rtp->ductSocket, msgs,
+				MULTIRECV_BUFFER_COUNT, MSG_WAITFORONE, NULL);
+		if (batchLength < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;	/*	Interrupted.	*/
+			}
+
+			if (errno != EBADF)	/*	Not shutdown.	*/
+			{
+				putSysErrmsg("Can't acquire bundles", NULL);
+				ionKillMainThread(procName);
+			}
+
+			rtp->running = 0;
+			continue;
+		}
+
+		/*	Collect the bundles in this batch, so that
+		 *	they can all be acquired at once.		*/
+
+		bundleCount = 0;
+		for (i = 0; i < batchLength; i++)
+		{
+			bundleLength = msgs[i].msg_len;
+			if (bundleLength == 1)
+			{
+				/*	Normal stop.			*/
+
+				rtp->running = 0;
+				break;
+			}
+
+			if (bundleLength == 0)
+			{
+				continue;	/*	Empty datagram.	*/
+			}
+
+			bundles[bundleCount] = (char *) iovecs[i].iov_base;
+			bundleLengths[bundleCount] = bundleLength;
+			bundleCount++;
+		}
+
+		if (bpAcquireBundles(work, bundles, bundleLengths,
+				bundleCount) < 0)
+		{
+			putErrmsg("Can't acquire bundles.", NULL);
+			ionKillMainThread(procName);
+			rtp->running = 0;
+			continue;
+		}
+
+		/*	Make sure other tasks have a chance to run.	*/
+
+		sm_TaskYield();
+	}
+
+	writeErrmsgMemos();
+	writeMemo("[i] udpcli receiver thread has ended.");
+
+	/*	Free resources.						*/
+
+	bpReleaseAcqArea(work);
+	MRELEASE(bundleLengths);
+	MRELEASE(bundles);
+	MRELEASE(msgs);
+	MRELEASE(iovecs);
+	MRELEASE(buffers);
+	return NULL;
+#else
+	char			*buffer;
 	struct sockaddr_in	fromAddr;
 	unsigned int		hostNbr;
 	char			hostName[MAXHOSTNAMELEN + 1];
@@ -111,6 +272,7 @@ static void	*handleDatagrams(void *parm)
 	bpReleaseAcqArea(work);
 	MRELEASE(buffer);
 	return NULL;
+#endif
 }
 
 /*	*	*	Main thread functions	*	*	*	*/
@@ -78,8 +78,9 @@ typedef struct
  *	in the file (and beyond it as necessary) and return the length
  *	of the current record.  It is also required to update the
  *	computed checksum for the file by passing each octet of the
- *	current record to the cfdp_update_checksum() function, along
- *	with the checksum type that is passed to the reader function.
+ *	current record to the cfdp_update_checksum() function (or the
+ *	entire record to cfdp_update_checksum_buffer()), along with
+ *	the checksum type that is passed to the reader function.
  *
  *	In the absence of a specified reader function, the default
  *	reader function simply returns CFDP_MAX_FILE_DATA or the
@@ -228,6 +229,11 @@ extern void	cfdp_update_checksum(unsigned char octet,
 			vast		*offset,
 			unsigned int	*checksum,
 			CfdpCksumType	ckType);
+extern void	cfdp_update_checksum_buffer(unsigned char *buffer,
+			int		length,
+			vast		*offset,
+			unsigned int	*checksum,
+			CfdpCksumType	ckType);
 extern
 MetadataList	cfdp_create_usrmsg_list();
 extern int	cfdp_add_usrmsg(MetadataList list,
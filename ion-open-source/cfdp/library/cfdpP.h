@@ -11,6 +11,7 @@
 
 #include "lyst.h"
 #include "zco.h"
+#include "sdrhash.h"
 #include "crc.h"
 #include "cfdp.h"
 
@@ -23,6 +24,17 @@ extern "C" {
 
 #define	CFDP_MAX_PDU_SIZE	65535
 
+/*	Dimensions of the hash tables that index FDUs by transaction
+ *	ID.  The estimate is only for sizing; it is not a limit.	*/
+
+#ifndef CFDP_EST_MAX_FDUS
+#define	CFDP_EST_MAX_FDUS	400
+#endif
+
+#ifndef CFDP_MEAN_SEARCH_LENGTH
+#define	CFDP_MEAN_SEARCH_LENGTH	4
+#endif
+
 typedef struct
 {
 	Object		text;
@@ -258,6 +270,16 @@ typedef struct
 	Object		outboundFdus;	/*	SDR list: OutFdu	*/
 	Object		events;		/*	SDR list: CfdpEvent	*/
 	Object		entities;	/*	SDR list: Entity	*/
+
+	/*	Each entry of outboundFdusHash, keyed by transaction
+	 *	number, is the address of the outboundFdus list
+	 *	element for an OutFdu.  Each entry of inboundFdusHash,
+	 *	keyed by the entire CfdpTransactionId, is the address
+	 *	of the element of some Entity's inboundFdus list for
+	 *	an InFdu.						*/
+
+	Object		outboundFdusHash;
+	Object		inboundFdusHash;
 	Object		finishPdus;	/*	SDR list: FinishPdu	*/
 	Object		finsPending;	/*	SDR list: FinishPending	*/
 } CfdpDB;
@@ -350,6 +372,9 @@ extern int		checkFile(char *);
 extern int		ckTypeOkay(unsigned int ckType);
 extern void		addToChecksum(unsigned char octet, vast *offset,
 				unsigned int *checksum, CfdpCksumType ckType);
+extern void		addBufferToChecksum(unsigned char *buffer,
+				unsigned int length, vast *offset,
+				unsigned int *checksum, CfdpCksumType ckType);
 
 extern int		getReqNbr();	/*	Returns next req nbr.	*/
 
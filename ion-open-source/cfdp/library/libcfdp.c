@@ -136,6 +136,13 @@ void	cfdp_update_checksum(unsigned char octet, vast *offset,
 	addToChecksum(octet, offset, checksum, ckType);
 }
 
+void	cfdp_update_checksum_buffer(unsigned char *buffer, int length,
+		vast *offset, unsigned int *checksum, CfdpCksumType ckType)
+{
+	CHKVOID(length >= 0);
+	addBufferToChecksum(buffer, length, offset, checksum, ckType);
+}
+
 static int	defaultReader(int fd, unsigned int *checksum,
 			CfdpCksumType ckType)
 {
@@ -143,8 +150,6 @@ static int	defaultReader(int fd, unsigned int *checksum,
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	vast		offset;
 	int		length;
-	int		i;
-	char		*octet;
 
 	offset = ilseek(fd, 0, SEEK_CUR);
 	if (offset < 0)
@@ -160,11 +165,8 @@ static int	defaultReader(int fd, unsigned int *checksum,
 		return -1;
 	}
 
-	for (i = 0, octet = defaultReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBufferToChecksum((unsigned char *) defaultReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -176,7 +178,6 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum,
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	vast		offset;
 	int		length;
-	int		i;
 	char		*octet;
 	unsigned int	recordLen;
 	unsigned short	pktlen;
@@ -252,11 +253,8 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum,
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = pktReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBufferToChecksum((unsigned char *) pktReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -318,11 +316,8 @@ int	cfdp_read_text_lines(int fd, unsigned int *checksum,
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = textReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum,
-				ckType);
-	}
+	addBufferToChecksum((unsigned char *) textReaderBuf, length, &offset,
+			checksum, ckType);
 
 	return length;
 }
@@ -1134,6 +1129,7 @@ int	createFDU(CfdpNumber *destinationEntityNbr, unsigned int utParmsLength,
 	int		lengthRemaining;
 	char		metadataBuffer[255];
 	Object		fduObj;
+	Object		fduElt;
 	CfdpEvent	event;
 	int		metadataFnRet;
 
@@ -1563,7 +1559,17 @@ too long.", sourceFileName);
 	}
 
 	sdr_write(sdr, fduObj, (char *) &fdu, sizeof(OutFdu));
-	sdr_list_insert_last(sdr, db.outboundFdus, fduObj);
+	fduElt = sdr_list_insert_last(sdr, db.outboundFdus, fduObj);
+	if (fduElt == 0
+	|| sdr_hash_insert(sdr, db.outboundFdusHash,
+			(char *) fdu.transactionId.transactionNbr.buffer,
+			fduElt, NULL) < 1)
+	{
+		sdr_cancel_xn(sdr);
+		putErrmsg("Can't index CFDP outbound FDU.", sourceFileName);
+		return -1;
+	}
+
 	if (messagesToUser)
 	{
 		destroyUsrmsgList(&messagesToUser);
@@ -260,6 +260,85 @@ void	addToChecksum(unsigned char octet, vast *offset,
 	return;
 }
 
+static void	addBufferToModularChecksum(unsigned char *buffer,
+			unsigned int length, vast *offset,
+			unsigned int *checksum)
+{
+	unsigned int	sum = *checksum;
+	unsigned int	words;
+
+	/*	Octets preceding the next 4-byte boundary (relative
+	 *	to the start of the file) are added one at a time.	*/
+
+	while (length > 0 && (*offset & 0x03) != 0)
+	{
+		addToModularChecksum(*buffer, offset, &sum);
+		buffer++;
+		length--;
+	}
+
+	/*	Each following group of 4 octets is one complete
+	 *	big-endian word of the file, so it can be added to
+	 *	the checksum in a single step.				*/
+
+	words = length >> 2;
+	*offset += (words << 2);
+	length -= (words << 2);
+	while (words > 0)
+	{
+		sum += (((unsigned int) buffer[0]) << 24)
+			+ (((unsigned int) buffer[1]) << 16)
+			+ (((unsigned int) buffer[2]) << 8)
+			+ ((unsigned int) buffer[3]);
+		buffer += 4;
+		words--;
+	}
+
+	/*	Trailing octets of a partial word.			*/
+
+	while (length > 0)
+	{
+		addToModularChecksum(*buffer, offset, &sum);
+		buffer++;
+		length--;
+	}
+
+	*checksum = sum;
+}
+
+void	addBufferToChecksum(unsigned char *buffer, unsigned int length,
+		vast *offset, unsigned int *checksum, CfdpCksumType ckType)
+{
+	CHKVOID(checksum);
+	if (length == 0)
+	{
+		return;
+	}
+
+	CHKVOID(buffer);
+	switch (ckType)
+	{
+	case ModularChecksum:
+		CHKVOID(offset);
+		addBufferToModularChecksum(buffer, length, offset, checksum);
+		break;
+
+	case CRC32CChecksum:
+		*checksum = ion_CRC32_1EDC6F41_C((char *) buffer, length,
+				*checksum);
+		break;
+
+	case NullChecksum:
+		*checksum = 0;
+		break;
+
+	default:			/*	Unsupported checksum	*/
+		break;
+	}
+
+	return;
+}
+
 int	getReqNbr()
 {
 	Sdr	sdr = getIonsdr();
@@ -482,6 +561,11 @@ int	cfdpInit()
 		cfdpdbBuf.outboundFdus = sdr_list_create(sdr);
 		cfdpdbBuf.events = sdr_list_create(sdr);
 		cfdpdbBuf.entities = sdr_list_create(sdr);
+		cfdpdbBuf.outboundFdusHash = sdr_hash_create(sdr, 8,
+				CFDP_EST_MAX_FDUS, CFDP_MEAN_SEARCH_LENGTH);
+		cfdpdbBuf.inboundFdusHash = sdr_hash_create(sdr,
+				sizeof(CfdpTransactionId), CFDP_EST_MAX_FDUS,
+				CFDP_MEAN_SEARCH_LENGTH);
 		cfdpdbBuf.finishPdus = sdr_list_create(sdr);
 		cfdpdbBuf.finsPending = sdr_list_create(sdr);
 		sdr_write(sdr, cfdpdbObject, (char *) &cfdpdbBuf,
@@ -1259,17 +1343,14 @@ Object	findOutFdu(CfdpTransactionId *transactionId, OutFdu *fduBuf,
 	CHKZERO(fduBuf);
 	CHKZERO(fduElt);
 	*fduElt = 0;			/*	Default.		*/
-	for (elt = sdr_list_first(sdr, cfdpConstants->outboundFdus); elt;
-			elt = sdr_list_next(sdr, elt))
+	if (sdr_hash_retrieve(sdr, cfdpConstants->outboundFdusHash,
+			(char *) transactionId->transactionNbr.buffer,
+			(Address *) &elt, NULL) == 1)
 	{
 		fduObj = sdr_list_data(sdr, elt);
 		sdr_read(sdr, (char *) fduBuf, fduObj, sizeof(OutFdu));
-		if (memcmp(fduBuf->transactionId.transactionNbr.buffer,
-				transactionId->transactionNbr.buffer, 8) == 0)
-		{
-			*fduElt = elt;
-			return fduObj;
-		}
+		*fduElt = elt;
+		return fduObj;
 	}
 
 	return 0;
@@ -1294,7 +1375,9 @@ static Object	createInFdu(CfdpTransactionId *transactionId, Entity *entity,
 	if (fduObj == 0 || fdubuf->messagesToUser == 0
 	|| fdubuf->filestoreRequests == 0 || fdubuf->extents == 0
 	|| (*fduElt = sdr_list_insert_last(sdr, entity->inboundFdus,
-			fduObj)) == 0)
+			fduObj)) == 0
+	|| sdr_hash_insert(sdr, (_cfdpConstants())->inboundFdusHash,
+			(char *) transactionId, *fduElt, NULL) < 1)
 	{
 		return 0;		/*	System failure.		*/
 	}
@@ -1314,45 +1397,34 @@ Object	findInFdu(CfdpTransactionId *transactionId, InFdu *fduBuf,
 	Object	elt;
 	Object	entityObj;
 	Entity	entity;
-	int	foundIt;
 	Object	fduObj;
 
 	CHKZERO(transactionId);
 	CHKZERO(fduBuf);
 	CHKZERO(fduElt);
+	if (sdr_hash_retrieve(sdr, (_cfdpConstants())->inboundFdusHash,
+			(char *) transactionId, (Address *) &elt, NULL) == 1)
+	{
+		/*	FDU is already started.				*/
+
+		fduObj = sdr_list_data(sdr, elt);
+		sdr_read(sdr, (char *) fduBuf, fduObj, sizeof(InFdu));
+		*fduElt = elt;
+		return fduObj;
+	}
+
 	cfdp_decompress_number(&sourceEntityId,
 			&transactionId->sourceEntityNbr);
 	elt = locateEntity(sourceEntityId, NULL);
 	if (elt)	/*	This is a known source entity.		*/
 	{
-		entityObj = sdr_list_data(sdr, elt);
-		sdr_read(sdr, (char *) &entity, entityObj, sizeof(Entity));
-		foundIt = 0;
-		for (elt = sdr_list_first(sdr, entity.inboundFdus); elt;
-				elt = sdr_list_next(sdr, elt))
-		{
-			fduObj = sdr_list_data(sdr, elt);
-			sdr_read(sdr, (char *) fduBuf, fduObj,
-					sizeof(InFdu));
-			if (memcmp((char *) &fduBuf->transactionId,
-					(char *) transactionId,
-					sizeof(CfdpTransactionId)) == 0)
-			{
-				foundIt = 1;
-				break;
-			}
-		}
-	
-		if (foundIt)	/*	FDU is already started.		*/
-		{
-			*fduElt = elt;
-			return fduObj;
-		}
-
 		/*	No such FDU.  Create it?			*/
 
 		if (createIfNotFound)
 		{
+			entityObj = sdr_list_data(sdr, elt);
+			sdr_read(sdr, (char *) &entity, entityObj,
+					sizeof(Entity));
 			return createInFdu(transactionId, &entity, fduBuf,
 					fduElt);
 		}
@@ -1515,6 +1587,9 @@ void	destroyOutFdu(OutFdu *fdu, Object fduObj, Object fduElt)
 		zco_destroy_file_ref(sdr, fdu->fileRef);
 	}
 
+	sdr_hash_remove(sdr, (_cfdpConstants())->outboundFdusHash,
+			(char *) fdu->transactionId.transactionNbr.buffer,
+			NULL);
 	sdr_free(sdr, fduObj);
 	sdr_list_delete(sdr, fduElt, NULL, NULL);
 }
@@ -1648,6 +1723,8 @@ void	destroyInFdu(InFdu *fdu, Object fduObj, Object fduElt)
 		sdr_list_delete(sdr, elt, NULL, NULL);
 	}
 
+	sdr_hash_remove(sdr, (_cfdpConstants())->inboundFdusHash,
+			(char *) &fdu->transactionId, NULL);
 	sdr_free(sdr, fduObj);
 	sdr_list_delete(sdr, fduElt, NULL, NULL);
 	if (cfdpvdb->currentFdu == fduObj)
@@ -3723,14 +3800,10 @@ static int	writeSegmentData(InFdu *fdu, unsigned char **cursor,
 	}
 
 	fdu->bytesReceived += bytesToWrite;
-	while (bytesToWrite > 0)
-	{
-		addToChecksum(**cursor, segmentOffset, &fdu->computedChecksum,
-				fdu->ckType);
-		(*cursor)++;
-		(*bytesRemaining)--;
-		bytesToWrite--;
-	}
+	addBufferToChecksum(*cursor, bytesToWrite, segmentOffset,
+			&fdu->computedChecksum, fdu->ckType);
+	(*cursor) += bytesToWrite;
+	(*bytesRemaining) -= bytesToWrite;
 
 	return 0;
 }
@@ -360,6 +360,41 @@ typedef struct
 	PsmAddress	citations;	/*	SM list of SmList elts.	*/
 } IonCXref;
 
+/*	The contact graph is a compact, read-only image of the contact
+ *	and range indexes, laid out in compressed sparse row form for
+ *	route computation.  Vertices are the contacts, in contact index
+ *	order; the rows are the runs of vertices that share the same
+ *	sending node, so the successors of any vertex are the vertices
+ *	of the row of its receiving node.  The graph is discarded on
+ *	any change to either index and is rebuilt when next needed.	*/
+
+typedef struct
+{
+	PsmAddress	contact;	/*	IonCXref		*/
+	uvast		fromNode;	/*	Copied from IonCXref.	*/
+	uvast		toNode;		/*	Copied from IonCXref.	*/
+	time_t		fromTime;	/*	Copied from IonCXref.	*/
+	time_t		toTime;		/*	Copied from IonCXref.	*/
+	unsigned int	owlt;		/*	Of applicable range.	*/
+	int		ranged;		/*	Boolean: owlt is known.	*/
+	int		successors;	/*	Row of toNode, or -1.	*/
+} IonCVertex;
+
+typedef struct
+{
+	uvast		nodeNbr;	/*	Sending node.		*/
+	int		firstVertex;
+	int		vertexCount;
+} IonCRow;
+
+typedef struct
+{
+	int		vertexCount;
+	int		rowCount;
+	PsmAddress	vertices;	/*	Array of IonCVertex	*/
+	PsmAddress	rows;		/*	Array of IonCRow	*/
+} IonCGraph;
+
 typedef enum
 {
 	IonStopImputedRange = 0,
@@ -417,6 +452,8 @@ typedef struct
 	PsmAddress	neighbors;	/*	SM RB tree: IonNeighbor	*/
 	PsmAddress	contactIndex;	/*	SM RB tree: IonCXref	*/
 	PsmAddress	rangeIndex;	/*	SM RB tree: IonRXref	*/
+	PsmAddress	contactGraph;	/*	IonCGraph, 0 if stale	*/
+	unsigned int	planVersion;	/*	Contact plan edits.	*/
 	PsmAddress	timeline;	/*	SM RB tree: IonEvent	*/
 	PsmAddress	probes;		/*	SM list: IonProbe	*/
 	PsmAddress	requisitions[2];/*	SM list: Requisition	*/
@@ -519,6 +556,7 @@ extern void		stopIonMemTrace();
 
 extern int		setDeltaFromUTC(int newDelta);
 extern time_t		getCtime();	/*	Unix 1970 epoch time.	*/
+extern vast		getCtimeMsec();	/*	In milliseconds.	*/
 extern int		ionClockIsSynchronized();
 
 extern time_t		readTimestampLocal(char *timestampBuffer,
@@ -77,6 +77,7 @@ typedef struct
 typedef struct
 {
 	PsmAddress	publicKeys;	/*	SM RB tree of PubKeyRef	*/
+	unsigned int	rulesVersion;	/*	Bumped on rule changes.	*/
 } SecVdb;
 
 extern int	secInitialize();
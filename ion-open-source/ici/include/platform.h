@@ -634,6 +634,10 @@ typedef void	(*FUNCPTR)(saddr, saddr, saddr, saddr, saddr, saddr, saddr,
 
 #else				/****	Not bionic		     ****/
 
+#ifndef NO_FUTEX_SEMAPHORES	/****	SVR4 table, futex take/give  ****/
+#define FUTEX_SEMAPHORES
+#endif
+
 #include <asm/param.h>		/****	...to get MAXHOSTNAMELEN     ****/
 #include <sys/param.h>		/****	...to get MAXPATHLEN	     ****/
 #ifndef uClibc			/****	uClibc subset of Linux	     ****/
@@ -879,6 +883,8 @@ extern void			printDottedString(unsigned int hostNbr,
 extern int			itcp_connect(char *socketSpec,
 					unsigned short defaultPort, int *sock);
 extern int			itcp_send(int *sock, char *from, int length);
+extern int			itcp_sendfile(int *sock, int fd, vast offset,
+					int length);
 extern int			itcp_recv(int *sock, char *into, int length);
 extern void			itcp_handleConnectionLoss();
 
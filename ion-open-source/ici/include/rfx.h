@@ -131,6 +131,43 @@ extern int		rfx_remove_range(time_t *fromTime,
 				system error, an indicative value
 				greater than 0 on any user error.	*/
 
+/*	*	Functions for route computation over the contact graph.	*/
+
+extern IonCGraph	*rfx_contact_graph();
+			/*	Returns the current contact graph,
+				first building it from the contact
+				and range indexes if it has been
+				discarded since it was last built.
+				Must be called within a transaction.
+				The graph remains valid until the
+				transaction ends.  Returns NULL on
+				any system error.			*/
+
+extern int		rfx_graph_row(IonCGraph *graph,
+				uvast nodeNbr);
+			/*	Returns the index of the row of the
+				contact graph for contacts from the
+				indicated node, or -1 if there are
+				no such contacts.			*/
+
+extern int		rfx_graph_vertex(IonCGraph *graph,
+				IonCXref *contact);
+			/*	Returns the index of the vertex of
+				the contact graph for the indicated
+				contact, or -1 if the contact is not
+				in the graph.				*/
+
+extern void		rfx_contacts_revised();
+			/*	Must be called, within a transaction,
+				by any function that revises IonCXref
+				objects in place rather than through
+				rfx_insert_contact and rfx_remove_contact
+				(contact discovery, for example), so
+				that the contact graph is rebuilt from
+				the revised contacts and forwarding
+				decisions based on the prior contact
+				plan are no longer reused.		*/
+
 /*	*	Functions for inserting and removing alarms.		*/
 
 extern PsmAddress	rfx_insert_alarm(unsigned int term,
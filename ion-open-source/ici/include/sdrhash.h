@@ -23,6 +23,15 @@
 			declared length will have unpredictable
 			results.
 
+			A hash table grows one row at a time as
+			entries are inserted (linear hashing), so
+			the mean search length declared at creation
+			time is maintained however many entries the
+			table comes to hold.  The entry handles
+			returned by sdr_hash_insert and
+			sdr_hash_retrieve remain valid as the table
+			grows, until the entry is deleted.
+
 	Author: Scott Burleigh, JPL
 	
 	Copyright (c) 2008 California Institute of Technology.
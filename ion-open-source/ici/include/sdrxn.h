@@ -36,6 +36,9 @@ typedef struct sdrv_str	*Sdr;	/*	Local view of an SDR.		*/
 #define	SDR_IN_FILE	2	/*	Write file; read file if nec.	*/
 #define	SDR_REVERSIBLE	4	/*	Transactions may be reversed.	*/
 #define	SDR_BOUNDED	8	/*	Object boundaries defended.	*/
+#define	SDR_DEFER_WRITES 16	/*	Write file at end of xn.	*/
+#define	SDR_SHARED_READS 32	/*	Concurrent read-only xns.	*/
+#define	SDR_MAP_FILE	64	/*	DRAM copy is the mapped file.	*/
 
 /*		SDR system administration functions.			*/
 
@@ -159,6 +162,36 @@ extern int		sdr_load_profile(char *name, int configFlags,
 				by total data space size will be
 				created and filled with zeros.
 
+				SDR_DEFER_WRITES may be selected
+				only in combination with both
+				SDR_IN_DRAM and SDR_IN_FILE.  It
+				causes the file copy of the data
+				space to be updated only when each
+				transaction ends, with one write per
+				contiguous range of modified data,
+				rather than once per sdr_write.
+
+				SDR_SHARED_READS may be selected
+				only in combination with SDR_IN_DRAM.
+				It enables sdr_begin_read_xn() to
+				begin read-only transactions that
+				run concurrently with one another;
+				without it, sdr_begin_read_xn() is
+				identical to sdr_begin_xn().
+
+				SDR_MAP_FILE may be selected only
+				in combination with both SDR_IN_DRAM
+				and SDR_IN_FILE.  Instead of keeping
+				a separate copy of the data space in
+				shared memory, every task maps the
+				data space file itself into memory,
+				so the file is never restaged into
+				memory on restart and sdr_write
+				modifies only the one copy of the
+				data.  Modified ranges of the file
+				are msync'd when each transaction
+				ends.
+
 				If a cleanup task must be run whenever
 				a transaction is reversed, the command
 				to execute this task must be provided
@@ -212,6 +245,7 @@ extern void		sdr_destroy(Sdr sdr);
 /*		Basic, low-level SDR transaction functions.		*/
 
 extern int		sdr_begin_xn(Sdr sdr);
+extern int		sdr_begin_read_xn(Sdr sdr);
 extern int		sdr_in_xn(Sdr sdr);		/*	Boolean	*/
 extern int		sdr_heap_is_halted(Sdr sdr);	/*	Boolean	*/
 extern void		sdr_exit_xn(Sdr sdr);
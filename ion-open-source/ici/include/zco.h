@@ -91,8 +91,26 @@ typedef struct
 	vast	sourceLengthCopied;		/*	within extents	*/
 	vast	trailersLengthCopied;		/*	within extents	*/
 	vast	lengthCopied;			/*	incl. capsules	*/
+
+	/*	Transmission cursor: the capsule or extent in which
+	 *	the last transmitted byte resides, so that the next
+	 *	transmission resumes there rather than rescanning
+	 *	the ZCO from its first byte.  Valid only while
+	 *	cursorPosition equals lengthCopied.			*/
+
+	int	cursorList;			/*	hdr/ext/trlr	*/
+	Object	cursorObj;			/*	Capsule/extent	*/
+	vast	cursorOffset;			/*	within object	*/
+	vast	cursorPosition;			/*	lengthCopied	*/
 } ZcoReader;
 
+typedef struct
+{
+	int	fd;		/*	-1 if span was copied to buffer	*/
+	vast	offset;		/*	Start of span within file.	*/
+	vast	length;
+} ZcoSpan;
+
 /*	Commonly used functions for building, accessing, managing,
  	and destroying a ZCO.						*/
 
@@ -536,6 +554,32 @@ extern vast	zco_transmit(	Sdr sdr,
 			 *	this ZCO.  Returns the number of bytes
 			 *	copied, or -1 on any error.		*/
 
+extern vast	zco_transmit_span(Sdr sdr,
+				ZcoReader *reader,
+				vast length,
+				char *buffer,
+				ZcoSpan *span);
+			/*	Like zco_transmit, but stops at the
+			 *	boundary between memory-resident ZCO
+			 *	content (capsules, heap objects, bulk
+			 *	items) and source data extents that
+			 *	reside in files.  Memory-resident
+			 *	bytes are copied into "buffer" as
+			 *	by zco_transmit, and span->fd is -1.
+			 *	Otherwise nothing is copied: the next
+			 *	as-yet-uncopied bytes (not more than
+			 *	"length") of the ZCO lie in a file,
+			 *	which is opened read-only; span->fd
+			 *	is the file descriptor and span->offset
+			 *	is the offset of the bytes within the
+			 *	file, so they can be sent directly
+			 *	from the file (e.g., by sendfile) with
+			 *	no intermediate copy.  The caller must
+			 *	close span->fd.  Returns the length
+			 *	of the span, 0 if the source file for
+			 *	a file span can't be read, or -1 on
+			 *	any error.				*/
+
 extern void	zco_start_receiving(Object zco,
 				ZcoReader *reader);
 			/*	Used by overlying protocol layer to
@@ -589,6 +633,29 @@ extern vast	zco_receive_source(Sdr sdr,
 			 *	source data.  Returns number of bytes
 			 *	copied, or -1 on any error.		*/
 
+typedef int	(*ZcoScanner)(char *text, vast length, void *arg);
+
+extern vast	zco_scan_source(Sdr sdr,
+				ZcoReader *reader,
+				vast length,
+				ZcoScanner scan,
+				void *arg);
+			/*	Passes "length" as-yet-uncopied bytes
+			 *	of source data from ZCO extents, in
+			 *	order, to the "scan" function, which
+			 *	is invoked once for each contiguous
+			 *	run of source data and must return
+			 *	-1 on any error, 0 otherwise.  Where
+			 *	possible the data are presented in
+			 *	place (heap objects, when the SDR
+			 *	heap resides in memory; file extents,
+			 *	mapped into memory) rather than copied
+			 *	into a buffer.  Advances the reader
+			 *	exactly as zco_receive_source would.
+			 *	Returns number of bytes scanned, 0 on
+			 *	any file access error, or -1 on any
+			 *	other error.				*/
+
 extern vast	zco_receive_trailers(Sdr sdr,
 				ZcoReader *reader,
 				vast length,
@@ -1610,6 +1610,20 @@ time_t	getCtime()
 	return ctime - delta;
 }
 
+vast	getCtimeMsec()
+{
+#if defined(FSWCLOCK)
+	return ((vast) getCtime()) * 1000;
+#else
+	IonVdb		*ionvdb = _ionvdb(NULL);
+	int		delta = ionvdb ? ionvdb->deltaFromUTC : 0;
+	struct timeval	now;
+
+	getCurrentTime(&now);
+	return (((vast) (now.tv_sec - delta)) * 1000) + (now.tv_usec / 1000);
+#endif
+}
+
 static time_t	readTimestamp(char *timestampBuffer, time_t referenceTime,
 			int timestampIsUTC)
 {
@@ -2704,6 +2718,7 @@ int	ionSendZcoByTCP(int *sock, Object zco, char *buffer, int buflen)
 	Sdr		sdr = getIonsdr();
 	int		totalBytesSent = 0;
 	ZcoReader	reader;
+	ZcoSpan		span;
 	uvast		bytesRemaining;
 	uvast		bytesToLoad;
 	int		bytesToSend;
@@ -2725,14 +2740,33 @@ int	ionSendZcoByTCP(int *sock, Object zco, char *buffer, int buflen)
 			bytesToLoad = buflen;
 		}
 
-		bytesToSend = zco_transmit(sdr, &reader, bytesToLoad, buffer);
-		if (sdr_end_xn(sdr) < 0 || bytesToSend != bytesToLoad)
+		/*	Content that resides in a file is sent from
+		 *	the file rather than copied into the buffer.	*/
+
+		bytesToSend = zco_transmit_span(sdr, &reader, bytesToLoad,
+				buffer, &span);
+		if (sdr_end_xn(sdr) < 0 || bytesToSend <= 0)
 		{
+			if (span.fd >= 0)
+			{
+				close(span.fd);
+			}
+
 			putErrmsg("Incomplete zco_transmit.", NULL);
 			return -1;
 		}
 
-		bytesSent = itcp_send(sock, buffer, bytesToSend);
+		if (span.fd >= 0)
+		{
+			bytesSent = itcp_sendfile(sock, span.fd, span.offset,
+					bytesToSend);
+			close(span.fd);
+		}
+		else
+		{
+			bytesSent = itcp_send(sock, buffer, bytesToSend);
+		}
+
 		switch (bytesSent)
 		{
 		case -1:
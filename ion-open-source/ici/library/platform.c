@@ -12,6 +12,10 @@
 /*	Ioannis Alexiadis, Democritus University of Thrace, 2011.	*/
 /*									*/
 #include "platform.h"
+#if defined (linux) && !defined (bionic)
+#include <sys/sendfile.h>
+#define	HAVE_SENDFILE
+#endif
 
 #define	ABORT_AS_REQD		if (_coreFileNeeded(NULL)) sm_Abort()
 
@@ -3579,6 +3583,99 @@ int	itcp_send(int *sock, char *from, int length)
 	return totalBytesSent;
 }
 
+int	itcp_sendfile(int *sock, int fd, vast offset, int length)
+{
+	int	totalBytesSent = 0;
+	int	bytesToSend = length;
+	int	bytesSent;
+#ifdef HAVE_SENDFILE
+	off_t	fileOffset = offset;
+#else
+	char	buffer[4096];
+	int	bytesToRead;
+#endif
+
+	CHKERR(sock);
+	CHKERR(fd >= 0);
+	CHKERR(offset >= 0);
+	CHKERR(length > 0);
+#ifdef HAVE_SENDFILE
+	/*	The kernel copies the file data to the socket
+	 *	directly, without staging it in a user buffer.		*/
+
+	while (bytesToSend > 0)
+	{
+		if (*sock == -1)	/*	Socket has been closed.	*/
+		{
+			return 0;
+		}
+
+		bytesSent = sendfile(*sock, fd, &fileOffset, bytesToSend);
+		if (bytesSent < 0)
+		{
+			switch (errno)
+			{
+			case EINTR:	/*	Interrupted; retry.	*/
+				continue;
+
+			case EPIPE:	/*	Lost connection.	*/
+			case EBADF:
+			case ETIMEDOUT:
+			case ECONNRESET:
+			case EHOSTUNREACH:
+				return 0;
+			}
+
+			putSysErrmsg("sendfile error on TCP socket",
+					itoa(*sock));
+			return -1;
+		}
+
+		if (bytesSent == 0)	/*	File is truncated.	*/
+		{
+			putErrmsg("File ended before sendfile completed.",
+					itoa(bytesToSend));
+			return -1;
+		}
+
+		totalBytesSent += bytesSent;
+		bytesToSend -= bytesSent;
+	}
+#else
+	if (lseek(fd, offset, SEEK_SET) < 0)
+	{
+		putSysErrmsg("Can't seek to file data to send", itoa(length));
+		return -1;
+	}
+
+	while (bytesToSend > 0)
+	{
+		bytesToRead = bytesToSend;
+		if (bytesToRead > sizeof buffer)
+		{
+			bytesToRead = sizeof buffer;
+		}
+
+		if (read(fd, buffer, bytesToRead) < bytesToRead)
+		{
+			putSysErrmsg("Can't read file data to send",
+					itoa(bytesToRead));
+			return -1;
+		}
+
+		bytesSent = itcp_send(sock, buffer, bytesToRead);
+		if (bytesSent < 1)
+		{
+			return bytesSent;
+		}
+
+		totalBytesSent += bytesSent;
+		bytesToSend -= bytesSent;
+	}
+#endif
+	return totalBytesSent;
+}
+
 int	itcp_recv(int *sock, char *into, int length)
 {
 	int	totalBytesReceived = 0;
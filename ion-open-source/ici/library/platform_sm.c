@@ -1592,6 +1592,25 @@ int	sm_SemUnwedge(sm_SemId i, int timeoutSeconds)
 #define SM_SEMBASEKEY	(0xee02)
 #endif
 
+#ifdef FUTEX_SEMAPHORES
+
+/*	With futex semaphores, the SVR4 semaphore table is still used
+ *	for allocating semaphores, but the state of each semaphore
+ *	is a word in the table itself that is updated atomically;
+ *	a system call is needed only when a task must block on a
+ *	taken semaphore or wake a task that is blocked.  The state
+ *	word is SEM_GIVEN when the semaphore is available, SEM_TAKEN
+ *	when it is taken and no task is blocked on it, SEM_CONTENDED
+ *	when it is taken and tasks may be blocked on it.		*/
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define	SEM_GIVEN	(0)
+#define	SEM_TAKEN	(1)
+#define	SEM_CONTENDED	(2)
+#endif
+
 /*	Note: one semaphore set is consumed by the ipcSemaphore.	*/
 #define MAX_SEM_SETS	(SEMMNI - 1)
 
@@ -1614,6 +1633,9 @@ typedef struct
 	int		semNbr;
 	int		inUse;
 	int		ended;
+#ifdef FUTEX_SEMAPHORES
+	int		state;		/*	Futex word.		*/
+#endif
 } IciSemaphore;
 
 typedef struct
@@ -1893,6 +1915,157 @@ void	sm_SemDelete(sm_SemId i)
 	giveIpcLock();
 }
 
+#ifdef FUTEX_SEMAPHORES
+static int	futexWait(int *word, struct timespec *timeout)
+{
+	return syscall(SYS_futex, word, FUTEX_WAIT, SEM_CONTENDED, timeout,
+			NULL, 0);
+}
+
+static void	futexWake(int *word)
+{
+	oK(syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0));
+}
+
+static int	takeFutex(IciSemaphore *sem, int timeoutSeconds)
+{
+	int		*word = &(sem->state);
+	int		state = SEM_GIVEN;
+	struct timespec	deadline;
+	struct timespec	now;
+	struct timespec	interval;
+	struct timespec	*timeout = NULL;
+
+	if (__atomic_compare_exchange_n(word, &state, SEM_TAKEN, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		return 0;		/*	Uncontended.		*/
+	}
+
+	if (timeoutSeconds > 0)
+	{
+		oK(clock_gettime(CLOCK_MONOTONIC, &deadline));
+		deadline.tv_sec += timeoutSeconds;
+		timeout = &interval;
+	}
+
+	/*	Note that the semaphore may have waiters, then block
+	 *	until it is given.  When the semaphore is taken after
+	 *	blocking, it's left in the contended state since other
+	 *	tasks may still be blocked on it.			*/
+
+	if (state != SEM_CONTENDED)
+	{
+		state = __atomic_exchange_n(word, SEM_CONTENDED,
+				__ATOMIC_ACQUIRE);
+	}
+
+	while (state != SEM_GIVEN)
+	{
+		if (timeout)
+		{
+			oK(clock_gettime(CLOCK_MONOTONIC, &now));
+			interval.tv_sec = deadline.tv_sec - now.tv_sec;
+			interval.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+			if (interval.tv_nsec < 0)
+			{
+				interval.tv_sec -= 1;
+				interval.tv_nsec += 1000000000;
+			}
+
+			if (interval.tv_sec < 0)
+			{
+				return 1;	/*	Timed out.	*/
+			}
+		}
+
+		if (futexWait(word, timeout) < 0)
+		{
+			switch (errno)
+			{
+			case EAGAIN:	/*	No longer contended.	*/
+			case EINTR:	/*	Retry on signal.	*/
+			case ETIMEDOUT:	/*	Checked above.		*/
+				break;
+
+			default:
+				putSysErrmsg("Can't wait for semaphore", NULL);
+				return -1;
+			}
+		}
+
+		state = __atomic_exchange_n(word, SEM_CONTENDED,
+				__ATOMIC_ACQUIRE);
+	}
+
+	return 0;
+}
+
+static void	giveFutex(IciSemaphore *sem)
+{
+	int	*word = &(sem->state);
+	int	state;
+
+	/*	Giving a semaphore that is not taken has no effect,
+	 *	as for an SVR4 semaphore.				*/
+
+	state = __atomic_load_n(word, __ATOMIC_RELAXED);
+	do
+	{
+		if (state == SEM_GIVEN)
+		{
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(word, &state, SEM_GIVEN, 0,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	if (state == SEM_CONTENDED)
+	{
+		futexWake(word);
+	}
+}
+
+int	sm_SemTake(sm_SemId i)
+{
+	SemaphoreBase	*sembase = _sembase(0);
+	IciSemaphore	*sem;
+
+	CHKERR(sembase);
+	CHKERR(i >= 0);
+	CHKERR(i < sembase->idsAllocated);
+	sem = sembase->semaphores + i;
+	if (sem->key == -1)	/*	semaphore deleted		*/
+	{
+		putErrmsg("Can't take deleted semaphore.", itoa(i));
+		return -1;
+	}
+
+	if (takeFutex(sem, 0) < 0)
+	{
+		putErrmsg("Can't take semaphore.", itoa(i));
+		return -1;
+	}
+
+	return 0;
+}
+
+void	sm_SemGive(sm_SemId i)
+{
+	SemaphoreBase	*sembase = _sembase(0);
+	IciSemaphore	*sem;
+
+	CHKVOID(sembase);
+	CHKVOID(i >= 0);
+	CHKVOID(i < sembase->idsAllocated);
+	sem = sembase->semaphores + i;
+	if (sem->key == -1)	/*	semaphore deleted		*/
+	{
+		return;
+	}
+
+	giveFutex(sem);
+}
+#else
 int	sm_SemTake(sm_SemId i)
 {
 	SemaphoreBase	*sembase = _sembase(0);
@@ -1953,6 +2126,7 @@ void	sm_SemGive(sm_SemId i)
 		}
 	}
 }
+#endif
 
 void	sm_SemEnd(sm_SemId i)
 {
@@ -1998,6 +2172,36 @@ void	sm_SemUnend(sm_SemId i)
 	sem->ended = 0;
 }
 
+#ifdef FUTEX_SEMAPHORES
+int	sm_SemUnwedge(sm_SemId i, int timeoutSeconds)
+{
+	SemaphoreBase	*sembase = _sembase(0);
+	IciSemaphore	*sem;
+
+	CHKERR(sembase);
+	CHKERR(i >= 0);
+	CHKERR(i < sembase->idsAllocated);
+	sem = sembase->semaphores + i;
+	if (sem->key == -1)	/*	semaphore deleted		*/
+	{
+		putErrmsg("Can't unwedge deleted semaphore.", itoa(i));
+		return -1;
+	}
+
+	/*	Whether or not the semaphore could be taken within
+	 *	the timeout interval, give it.				*/
+
+	if (timeoutSeconds < 1) timeoutSeconds = 1;
+	if (takeFutex(sem, timeoutSeconds) < 0)
+	{
+		putErrmsg("Can't take semaphore.", itoa(i));
+		return -1;
+	}
+
+	giveFutex(sem);
+	return 0;
+}
+#else
 static void	handleTimeout(int signum)
 {
 	return;
@@ -2049,6 +2253,7 @@ int	sm_SemUnwedge(sm_SemId i, int timeoutSeconds)
 
 	return 0;
 }
+#endif
 
 #endif			/*	End of #ifdef SVR4_SEMAPHORES		*/
 
@@ -525,6 +525,316 @@ PsmAddress	postProbeEvent(IonNode *node, Embargo *embargo)
 	return sm_list_insert_first(ionwm, ionvdb->probes, addr);
 }
 
+/*	*	RFX contact graph management functions	*	*	*/
+
+static void	discardContactGraph(PsmPartition ionwm, IonVdb *vdb)
+{
+	IonCGraph	*graph;
+
+	if (vdb->contactGraph == 0)
+	{
+		return;
+	}
+
+	graph = (IonCGraph *) psp(ionwm, vdb->contactGraph);
+	if (graph->vertices)
+	{
+		psm_free(ionwm, graph->vertices);
+	}
+
+	if (graph->rows)
+	{
+		psm_free(ionwm, graph->rows);
+	}
+
+	psm_free(ionwm, vdb->contactGraph);
+	vdb->contactGraph = 0;
+}
+
+static void	noteContactPlanChange(PsmPartition ionwm, IonVdb *vdb)
+{
+	vdb->planVersion++;
+	discardContactGraph(ionwm, vdb);
+}
+
+static void	noteApplicableRange(PsmPartition ionwm, IonCVertex *vertex,
+			IonCXref *contact, PsmAddress *rangeElt)
+{
+	PsmAddress	elt;
+	IonRXref	*range;
+
+	vertex->owlt = 0;	/*	Default.			*/
+	vertex->ranged = 0;
+	if (contact->type == CtHypothetical || contact->type == CtDiscovered)
+	{
+		vertex->ranged = 1;	/*	Physically adjacent.	*/
+		return;
+	}
+
+	/*	Ranges are ordered like contacts, so the range index
+	 *	is traversed only once for the whole contact index:
+	 *	*rangeElt is advanced past all ranges between nodes
+	 *	that precede this contact's nodes, and past all
+	 *	ranges between the same nodes that ended before the
+	 *	start of this contact (and therefore also before the
+	 *	start of every later contact between these nodes).	*/
+
+	for (; *rangeElt; *rangeElt = sm_rbt_next(ionwm, *rangeElt))
+	{
+		range = (IonRXref *) psp(ionwm, sm_rbt_data(ionwm, *rangeElt));
+		if (range->fromNode < contact->fromNode
+		|| (range->fromNode == contact->fromNode
+			&& range->toNode < contact->toNode))
+		{
+			continue;	/*	Other nodes.		*/
+		}
+
+		if (range->fromNode == contact->fromNode
+		&& range->toNode == contact->toNode
+		&& range->toTime < contact->fromTime)
+		{
+			continue;	/*	Range is in the past.	*/
+		}
+
+		break;
+	}
+
+	/*	The applicable range is the first range between the
+	 *	same nodes that is not in the past, provided it is
+	 *	known at the start time of the contact.			*/
+
+	for (elt = *rangeElt; elt; elt = sm_rbt_next(ionwm, elt))
+	{
+		range = (IonRXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
+		if (range->fromNode != contact->fromNode
+		|| range->toNode != contact->toNode)
+		{
+			return;
+		}
+
+		if (range->toTime < contact->fromTime)
+		{
+			continue;	/*	Range is in the past.	*/
+		}
+
+		if (range->fromTime > contact->fromTime)
+		{
+			return;	/*	Unknown at contact start time.	*/
+		}
+
+		vertex->owlt = range->owlt;
+		vertex->ranged = 1;
+		return;
+	}
+}
+
+static int	buildContactGraph(PsmPartition ionwm, IonVdb *vdb)
+{
+	PsmAddress	graphAddr;
+	IonCGraph	*graph;
+	IonCVertex	*vertices;
+	IonCVertex	*vertex;
+	IonCRow		*rows;
+	IonCRow		*row;
+	PsmAddress	elt;
+	PsmAddress	rangeElt;
+	PsmAddress	cxaddr;
+	IonCXref	*contact;
+	uvast		priorNode = 0;
+	int		i;
+
+	graphAddr = psm_zalloc(ionwm, sizeof(IonCGraph));
+	if (graphAddr == 0)
+	{
+		return -1;
+	}
+
+	graph = (IonCGraph *) psp(ionwm, graphAddr);
+	memset((char *) graph, 0, sizeof(IonCGraph));
+	vdb->contactGraph = graphAddr;
+
+	/*	Count the vertices and the rows.			*/
+
+	for (elt = sm_rbt_first(ionwm, vdb->contactIndex); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		contact = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
+		if (graph->vertexCount == 0 || contact->fromNode != priorNode)
+		{
+			graph->rowCount++;
+		}
+
+		graph->vertexCount++;
+		priorNode = contact->fromNode;
+	}
+
+	if (graph->vertexCount == 0)
+	{
+		return 0;
+	}
+
+	graph->vertices = psm_zalloc(ionwm, graph->vertexCount
+			* sizeof(IonCVertex));
+	graph->rows = psm_zalloc(ionwm, graph->rowCount * sizeof(IonCRow));
+	if (graph->vertices == 0 || graph->rows == 0)
+	{
+		discardContactGraph(ionwm, vdb);
+		return -1;
+	}
+
+	/*	Load the vertices and rows.				*/
+
+	vertices = (IonCVertex *) psp(ionwm, graph->vertices);
+	rows = (IonCRow *) psp(ionwm, graph->rows);
+	row = NULL;
+	vertex = vertices;
+	rangeElt = sm_rbt_first(ionwm, vdb->rangeIndex);
+	for (elt = sm_rbt_first(ionwm, vdb->contactIndex); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		cxaddr = sm_rbt_data(ionwm, elt);
+		contact = (IonCXref *) psp(ionwm, cxaddr);
+		if (row == NULL || contact->fromNode != row->nodeNbr)
+		{
+			row = (row == NULL ? rows : row + 1);
+			row->nodeNbr = contact->fromNode;
+			row->firstVertex = vertex - vertices;
+			row->vertexCount = 0;
+		}
+
+		row->vertexCount++;
+		vertex->contact = cxaddr;
+		vertex->fromNode = contact->fromNode;
+		vertex->toNode = contact->toNode;
+		vertex->fromTime = contact->fromTime;
+		vertex->toTime = contact->toTime;
+		noteApplicableRange(ionwm, vertex, contact, &rangeElt);
+		vertex++;
+	}
+
+	/*	Link each vertex to the row of its successors.		*/
+
+	for (i = 0, vertex = vertices; i < graph->vertexCount; i++, vertex++)
+	{
+		vertex->successors = rfx_graph_row(graph, vertex->toNode);
+	}
+
+	return 0;
+}
+
+IonCGraph	*rfx_contact_graph()
+{
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*vdb = getIonVdb();
+
+	CHKNULL(sdr_in_xn(getIonsdr()));
+	if (vdb->contactGraph == 0)
+	{
+		if (buildContactGraph(ionwm, vdb) < 0)
+		{
+			putErrmsg("Can't build contact graph.", NULL);
+			return NULL;
+		}
+	}
+
+	return (IonCGraph *) psp(ionwm, vdb->contactGraph);
+}
+
+int	rfx_graph_row(IonCGraph *graph, uvast nodeNbr)
+{
+	IonCRow	*rows = (IonCRow *) psp(getIonwm(), graph->rows);
+	int	low = 0;
+	int	high = graph->rowCount;
+	int	mid;
+
+	while (low < high)
+	{
+		mid = low + ((high - low) / 2);
+		if (rows[mid].nodeNbr < nodeNbr)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if (low < graph->rowCount && rows[low].nodeNbr == nodeNbr)
+	{
+		return low;
+	}
+
+	return -1;
+}
+
+int	rfx_graph_vertex(IonCGraph *graph, IonCXref *contact)
+{
+	PsmPartition	ionwm = getIonwm();
+	IonCVertex	*vertices;
+	IonCRow		*row;
+	IonCVertex	*vertex;
+	PsmAddress	contactAddr;
+	int		rowNbr;
+	int		low;
+	int		high;
+	int		mid;
+
+	rowNbr = rfx_graph_row(graph, contact->fromNode);
+	if (rowNbr < 0)
+	{
+		return -1;
+	}
+
+	vertices = (IonCVertex *) psp(ionwm, graph->vertices);
+	row = ((IonCRow *) psp(ionwm, graph->rows)) + rowNbr;
+	low = row->firstVertex;
+	high = row->firstVertex + row->vertexCount;
+	while (low < high)
+	{
+		mid = low + ((high - low) / 2);
+		vertex = vertices + mid;
+		if (vertex->toNode < contact->toNode
+		|| (vertex->toNode == contact->toNode
+			&& vertex->fromTime < contact->fromTime))
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	contactAddr = psa(ionwm, contact);
+	if (low < row->firstVertex + row->vertexCount
+	&& vertices[low].contact == contactAddr)
+	{
+		return low;
+	}
+
+	/*	The contact's times may have been revised in place
+	 *	(as by contact discovery) since the graph was built,
+	 *	so fall back to finding its vertex by address.		*/
+
+	for (low = row->firstVertex;
+			low < row->firstVertex + row->vertexCount; low++)
+	{
+		if (vertices[low].contact == contactAddr)
+		{
+			return low;
+		}
+	}
+
+	return -1;
+}
+
+void	rfx_contacts_revised()
+{
+	CHKVOID(sdr_in_xn(getIonsdr()));
+	noteContactPlanChange(getIonwm(), getIonVdb());
+}
+
 /*	*	RFX contact list management functions	*	*	*/
 
 static PsmAddress	insertCXref(IonCXref *cxref)
@@ -609,6 +919,8 @@ static PsmAddress	insertCXref(IonCXref *cxref)
 		return 0;
 	}
 
+	noteContactPlanChange(ionwm, vdb);
+
 	/*	Insert relevant timeline events.			*/
 
 	if (cxref->startXmit)
@@ -1189,7 +1501,10 @@ int	rfx_revise_contact(time_t fromTime, uvast fromNode, uvast toNode,
 	}
 
 	/*	Contact has been updated.  No change to contact graph,
-	 *	no need to recompute routes.				*/
+	 *	no need to recompute routes, but forwarding decisions
+	 *	based on the contact's rate and confidence are stale.	*/
+
+	vdb->planVersion++;
 
 	if (sdr_end_xn(sdr) < 0)
 	{
@@ -1350,6 +1665,7 @@ static void	deleteContact(PsmAddress cxaddr)
 		getCurrentTime(&(vdb->lastEditTime));
 	}
 
+	noteContactPlanChange(ionwm, vdb);
 	sm_rbt_delete(ionwm, vdb->contactIndex, rfx_order_contacts, cxref,
 			rfx_erase_data, NULL);
 }
@@ -1562,6 +1878,8 @@ static int	insertRXref(IonRXref *rxref)
 		return 0;
 	}
 
+	noteContactPlanChange(ionwm, vdb);
+
 	/*	Insert relevant asserted timeline events.		*/
 
 	addr = psm_zalloc(ionwm, sizeof(IonEvent));
@@ -1652,6 +1970,8 @@ static int	insertRXref(IonRXref *rxref)
 		return 0;
 	}
 
+	noteContactPlanChange(ionwm, vdb);
+
 	/*	Then insert relevant imputed timeline events.		*/
 
 	addr = psm_zalloc(ionwm, sizeof(IonEvent));
@@ -1770,6 +2090,7 @@ int	rfx_insert_range(time_t fromTime, time_t toTime, uvast fromNode,
 			 *	associated events, after which there
 			 *	is no duplication.			*/
 
+			noteContactPlanChange(ionwm, vdb);
 			sm_rbt_delete(ionwm, vdb->rangeIndex, rfx_order_ranges,
 					&arg1, rfx_erase_data, NULL);
 			arg2.ref = *rxaddr;
@@ -1980,6 +2301,7 @@ static void	deleteRange(PsmAddress rxaddr, int retainIfAsserted)
 		getCurrentTime(&(vdb->lastEditTime));
 	}
 
+	noteContactPlanChange(ionwm, vdb);
 	sm_rbt_delete(ionwm, vdb->rangeIndex, rfx_order_ranges, rxref,
 			rfx_erase_data, NULL);
 }
@@ -2316,6 +2638,7 @@ int	rfx_start()
 	 *	databases.  This prevents contact/range duplication
 	 *	as a result of adds before starting ION.		*/
 
+	discardContactGraph(ionwm, vdb);
 	sm_rbt_destroy(ionwm, vdb->contactIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->rangeIndex, rfx_erase_data, NULL);
 	vdb->contactIndex = sm_rbt_create(ionwm);
@@ -2416,6 +2739,7 @@ void	rfx_stop()
 	/*	Wipe out all red-black trees involved in routing,
 	 *	for reconstruction on restart.				*/
 
+	discardContactGraph(ionwm, vdb);
 	sm_rbt_destroy(ionwm, vdb->contactIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->rangeIndex, rfx_erase_data, NULL);
 	sm_rbt_destroy(ionwm, vdb->timeline, rfx_erase_data, NULL);
@@ -18,6 +18,29 @@
 #define ZCODEBUG	0
 #endif
 
+/*	Size of the buffer through which zco_scan_source passes ZCO
+ *	source data that can't be presented to the scanner in place.	*/
+
+#ifndef ZCO_SCAN_BUFSZ
+#define ZCO_SCAN_BUFSZ	(8192)
+#endif
+
+#ifdef unix
+#include <sys/mman.h>
+#define	ZCO_CAN_MAP_FILE	1
+#define	ZCO_CAN_PREAD		1
+#else
+#define	ZCO_CAN_MAP_FILE	0
+#define	ZCO_CAN_PREAD		0
+#endif
+
+/*	Number of open file descriptors each process retains for
+ *	reading the source data of file-resident ZCO extents.		*/
+
+#ifndef ZCO_FD_CACHE_SIZE
+#define ZCO_FD_CACHE_SIZE	(8)
+#endif
+
 static const char	*bookNames[] = { "inbound ", "outbound" };
 
 /*	The INBOUND and OUTBOUND "books" control ZCOs' occupancy of
@@ -148,6 +171,28 @@ typedef struct
 	ZcoAcct		acct;
 } Zco;
 
+typedef struct
+{
+	Object		fileRefObj;	/*	0 if entry is vacant.	*/
+	unsigned long	inode;		/*	Of the open file.	*/
+	int		fd;
+	unsigned int	passNbr;	/*	When last checked.	*/
+	unsigned int	lastUse;	/*	For LRU replacement.	*/
+} ZcoFdCacheEntry;
+
+/*	A ZcoFilePass is the state of a single zco_transmit or
+ *	zco_receive call's access to file-resident source data: the
+ *	pass number that limits re-checking of cached descriptors to
+ *	once per call, and the transmission progress noted for a
+ *	file but not yet written to its FileRef.			*/
+
+typedef struct
+{
+	unsigned int	passNbr;	/*	0 until first file read	*/
+	Object		fileRefObj;	/*	0 if none pending.	*/
+	unsigned long	xmitProgress;
+} ZcoFilePass;
+
 static char	*_badArgsMemo()
 {
 	return "Missing/invalid argument(s).";
@@ -819,12 +864,292 @@ int	zco_file_ref_xmit_eof(Sdr sdr, Object fileRefObj)
 	return (fileRef->xmitProgress == fileRef->fileLength);
 }
 
+static int	openSourceFile(FileRef *fileRef)
+{
+	int		fd;
+	struct stat	statbuf;
+
+	fd = iopen(fileRef->pathName, O_RDONLY, 0);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	if (fstat(fd, &statbuf) < 0)
+	{
+		close(fd);		/*	Can't check.		*/
+		return -1;
+	}
+
+	if (statbuf.st_ino != fileRef->inode)
+	{
+		close(fd);		/*	File changed.		*/
+		return -1;
+	}
+
+	return fd;
+}
+
+/*	Each process keeps a small cache of descriptors open on the
+ *	files in which the source data of ZCO file extents reside, so
+ *	that reading a file-resident extent in many chunks doesn't
+ *	open, check, and close the file for every chunk.  Entries are
+ *	keyed by FileRef address and are valid only while the inode
+ *	of the open file is the inode noted in the FileRef; the open
+ *	file itself is re-checked (it may have been replaced or
+ *	unlinked) at most once per ZcoFilePass.  At the start of each
+ *	pass that reads a file and at the end of every pass, whether
+ *	or not it read a file, every cached descriptor on a file that
+ *	has since been unlinked (typically by the cleanup of the
+ *	FileRef in some other process) is closed, so that a long-lived
+ *	process can't keep the file's disk space from being reclaimed
+ *	beyond its next zco_transmit or zco_receive call.		*/
+
+static ResourceLock	fdCacheLock;
+static ZcoFdCacheEntry	fdCache[ZCO_FD_CACHE_SIZE];
+static unsigned int	fdCachePassCount = 0;
+static unsigned int	fdCacheUseCount = 0;
+
+static void	vacateFdCacheEntry(ZcoFdCacheEntry *entry)
+{
+	close(entry->fd);
+	entry->fileRefObj = 0;
+	entry->fd = -1;
+}
+
+static void	closeUnlinkedFiles(unsigned int passNbr)
+{
+	int		i;
+	ZcoFdCacheEntry	*entry;
+	struct stat	statbuf;
+
+	for (i = 0, entry = fdCache; i < ZCO_FD_CACHE_SIZE; i++, entry++)
+	{
+		if (entry->fileRefObj == 0)
+		{
+			continue;
+		}
+
+		if (fstat(entry->fd, &statbuf) < 0
+		|| statbuf.st_ino != entry->inode
+		|| statbuf.st_nlink == 0)
+		{
+			vacateFdCacheEntry(entry);
+			continue;
+		}
+
+		if (passNbr)
+		{
+			entry->passNbr = passNbr;
+		}
+	}
+}
+
+static void	sweepFdCache()
+{
+	if (fdCacheUseCount == 0)
+	{
+		return;		/*	Cache has never been used.	*/
+	}
+
+	lockResource(&fdCacheLock);
+	closeUnlinkedFiles(0);
+	unlockResource(&fdCacheLock);
+}
+
+static int	fdCacheEntryIsValid(ZcoFdCacheEntry *entry, FileRef *fileRef,
+			ZcoFilePass *pass)
+{
+	struct stat	statbuf;
+
+	if (entry->inode != fileRef->inode)
+	{
+		return 0;	/*	FileRef has been revised.	*/
+	}
+
+	if (entry->passNbr != pass->passNbr)
+	{
+		if (fstat(entry->fd, &statbuf) < 0
+		|| statbuf.st_ino != entry->inode
+		|| statbuf.st_nlink == 0)
+		{
+			return 0;	/*	File gone or replaced.	*/
+		}
+
+		entry->passNbr = pass->passNbr;
+	}
+
+	return 1;
+}
+
+/*	getSourceFile returns a cached descriptor for the file cited
+ *	by fileRef, with the cache locked; the caller must call
+ *	releaseSourceFile when done using the descriptor.  On failure
+ *	returns -1 with the cache unlocked.				*/
+
+static int	getSourceFile(Object fileRefObj, FileRef *fileRef,
+			ZcoFilePass *pass)
+{
+	int		i;
+	ZcoFdCacheEntry	*entry;
+	ZcoFdCacheEntry	*victim = NULL;
+	int		fd;
+
+	if (initResourceLock(&fdCacheLock) < 0)
+	{
+		putErrmsg("Can't initialize ZCO file cache lock.", NULL);
+		return -1;
+	}
+
+	lockResource(&fdCacheLock);
+	if (pass->passNbr == 0)
+	{
+		fdCachePassCount++;
+		if (fdCachePassCount == 0)
+		{
+			fdCachePassCount = 1;	/*	Wrapped.	*/
+		}
+
+		pass->passNbr = fdCachePassCount;
+		closeUnlinkedFiles(pass->passNbr);
+	}
+
+	fdCacheUseCount++;
+	for (i = 0, entry = fdCache; i < ZCO_FD_CACHE_SIZE; i++, entry++)
+	{
+		if (entry->fileRefObj == fileRefObj)
+		{
+			if (fdCacheEntryIsValid(entry, fileRef, pass))
+			{
+				entry->lastUse = fdCacheUseCount;
+				return entry->fd;
+			}
+
+			vacateFdCacheEntry(entry);
+		}
+
+		if (victim == NULL || entry->fileRefObj == 0
+		|| (victim->fileRefObj != 0
+			&& entry->lastUse < victim->lastUse))
+		{
+			victim = entry;
+		}
+	}
+
+	fd = openSourceFile(fileRef);
+	if (fd < 0)
+	{
+		unlockResource(&fdCacheLock);
+		return -1;
+	}
+
+	if (victim->fileRefObj)
+	{
+		vacateFdCacheEntry(victim);
+	}
+
+	victim->fileRefObj = fileRefObj;
+	victim->inode = fileRef->inode;
+	victim->fd = fd;
+	victim->passNbr = pass->passNbr;
+	victim->lastUse = fdCacheUseCount;
+	return fd;
+}
+
+static void	releaseSourceFile()
+{
+	unlockResource(&fdCacheLock);
+}
+
+static void	forgetSourceFile(Object fileRefObj)
+{
+	int		i;
+	ZcoFdCacheEntry	*entry;
+
+	if (initResourceLock(&fdCacheLock) < 0)
+	{
+		return;
+	}
+
+	lockResource(&fdCacheLock);
+	for (i = 0, entry = fdCache; i < ZCO_FD_CACHE_SIZE; i++, entry++)
+	{
+		if (entry->fileRefObj == fileRefObj)
+		{
+			vacateFdCacheEntry(entry);
+		}
+	}
+
+	unlockResource(&fdCacheLock);
+}
+
+static int	readSourceFile(int fd, char *buffer, vast offset, vast length)
+{
+#if ZCO_CAN_PREAD
+	return pread(fd, buffer, length, offset);
+#else
+	if (lseek(fd, offset, SEEK_SET) < 0)
+	{
+		return -1;
+	}
+
+	return read(fd, buffer, length);
+#endif
+}
+
+/*	Transmission progress through a file is noted in the pass
+ *	and written to the file's FileRef only when the pass moves
+ *	on to a different file or ends, rather than once per chunk.	*/
+
+static void	flushXmitProgress(Sdr sdr, ZcoFilePass *pass)
+{
+	FileRef	fileRef;
+
+	if (pass->fileRefObj == 0)
+	{
+		return;
+	}
+
+	sdr_stage(sdr, (char *) &fileRef, pass->fileRefObj, sizeof(FileRef));
+	if (pass->xmitProgress > fileRef.xmitProgress)
+	{
+		fileRef.xmitProgress = pass->xmitProgress;
+		sdr_write(sdr, pass->fileRefObj, (char *) &fileRef,
+				sizeof(FileRef));
+	}
+
+	pass->fileRefObj = 0;
+}
+
+static void	noteXmitProgress(Sdr sdr, ZcoFilePass *pass, Object fileRefObj,
+			unsigned long xmitProgress)
+{
+	if (pass->fileRefObj != fileRefObj)
+	{
+		flushXmitProgress(sdr, pass);
+		pass->fileRefObj = fileRefObj;
+		pass->xmitProgress = 0;
+	}
+
+	if (xmitProgress > pass->xmitProgress)
+	{
+		pass->xmitProgress = xmitProgress;
+	}
+}
+
+static void	endFilePass(Sdr sdr, ZcoFilePass *pass)
+{
+	flushXmitProgress(sdr, pass);
+	sweepFdCache();
+}
+
 static void	destroyFileReference(Sdr sdr, FileRef *fileRef,
 			Object fileRefObj)
 {
 	/*	Destroy the file reference.  Invoke file cleanup
 	 *	script if provided.					*/
 
+	forgetSourceFile(fileRefObj);
 	sdr_free(sdr, fileRefObj);
 	if (fileRef->unlinkOnDestroy)
 	{
@@ -2844,7 +3169,8 @@ ZcoAcct	zco_acct(Sdr sdr, Object zcoObj)
 }
 
 static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
-			vast bytesToSkip, vast bytesAvbl, ZcoReader *reader)
+			vast bytesToSkip, vast bytesAvbl, ZcoReader *reader,
+			ZcoFilePass *pass)
 {
 	ZcoObjLien	objLien;
 	ObjRef		objRef;
@@ -2854,8 +3180,6 @@ static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 	FileRef		fileRef;
 	int		fd;
 	int		bytesRead;
-	struct stat	statbuf;
-	unsigned long	xmitProgress = 0;
 
 	switch (extent->sourceMedium)
 	{
@@ -2877,51 +3201,28 @@ static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 				extent->offset + bytesToSkip, bytesAvbl);
 
 	default:	/*	Source text of extent is a file.	*/
-		if (reader->trackFileOffset)
-		{
-			xmitProgress = extent->offset + bytesToSkip + bytesAvbl;
-		}
-
 		sdr_read(sdr, (char *) &fileLien, extent->location,
 				sizeof(ZcoFileLien));
-		sdr_stage(sdr, (char *) &fileRef, fileLien.location,
+		sdr_read(sdr, (char *) &fileRef, fileLien.location,
 				sizeof(FileRef));
-		fd = iopen(fileRef.pathName, O_RDONLY, 0);
+		fd = getSourceFile(fileLien.location, &fileRef, pass);
 		if (fd >= 0)
 		{
-			if (fstat(fd, &statbuf) < 0)
-			{
-				close(fd);	/*	Can't check.	*/
-			}
-			else if (statbuf.st_ino != fileRef.inode)
-			{
-				close(fd);	/*	File changed.	*/
-			}
-			else if (lseek(fd, extent->offset + bytesToSkip,
-					SEEK_SET) < 0)
-			{
-				close(fd);	/*	Can't position.	*/
-			}
-			else
+			bytesRead = readSourceFile(fd, buffer,
+					extent->offset + bytesToSkip,
+					bytesAvbl);
+			releaseSourceFile();
+			if (bytesRead == bytesAvbl)
 			{
-				bytesRead = read(fd, buffer, bytesAvbl);
-				close(fd);
-				if (bytesRead == bytesAvbl)
+				if (reader->trackFileOffset)
 				{
-					/*	Update xmit progress.	*/
-
-					if (xmitProgress > fileRef.xmitProgress)
-					{
-						fileRef.xmitProgress
-							= xmitProgress;
-						sdr_write(sdr,
-							fileLien.location,
-							(char *) &fileRef,
-							sizeof(FileRef));
-					}
-
-					return bytesAvbl;
+					noteXmitProgress(sdr, pass,
+						fileLien.location,
+						extent->offset + bytesToSkip
+						+ bytesAvbl);
 				}
+
+				return bytesAvbl;
 			}
 		}
 
@@ -2933,6 +3234,38 @@ static int	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 	}
 }
 
+static int	openFileSpan(Sdr sdr, ZcoSpan *span, SourceExtent *extent,
+			vast bytesToSkip, vast bytesAvbl, ZcoReader *reader,
+			ZcoFilePass *pass)
+{
+	ZcoFileLien	fileLien;
+	FileRef		fileRef;
+
+	/*	The span's descriptor is the caller's to position and
+	 *	close, so it is opened afresh rather than cached.	*/
+
+	sdr_read(sdr, (char *) &fileLien, extent->location,
+			sizeof(ZcoFileLien));
+	sdr_read(sdr, (char *) &fileRef, fileLien.location, sizeof(FileRef));
+	span->fd = openSourceFile(&fileRef);
+	if (span->fd < 0)
+	{
+		return -1;
+	}
+
+	span->offset = extent->offset + bytesToSkip;
+	if (reader->trackFileOffset)
+	{
+		/*	The span is as good as transmitted: the caller
+		 *	will send it straight from the file.		*/
+
+		noteXmitProgress(sdr, pass, fileLien.location,
+				span->offset + bytesAvbl);
+	}
+
+	return 0;
+}
+
 /*	Functions for transmission via underlying protocol layer.	*/
 
 void	zco_start_transmitting(Object zco, ZcoReader *reader)
@@ -2951,34 +3284,79 @@ void	zco_track_file_offset(ZcoReader *reader)
 	}
 }
 
-vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
+#define	ZCO_CURSOR_HEADERS	1
+#define	ZCO_CURSOR_EXTENTS	2
+#define	ZCO_CURSOR_TRAILERS	3
+
+static void	setCursor(ZcoReader *reader, int list, Object obj, vast offset)
+{
+	reader->cursorList = list;
+	reader->cursorObj = obj;
+	reader->cursorOffset = offset;
+	reader->cursorPosition = reader->lengthCopied;
+}
+
+static vast	transmitZco(Sdr sdr, ZcoReader *reader, vast length,
+			char *buffer, ZcoSpan *span)
 {
 	Zco		zco;
 	vast		bytesToSkip;
 	vast		bytesToTransmit;
 	vast		bytesTransmitted;
+	Object		firstHeader;
+	Object		firstExtent;
+	Object		firstTrailer;
 	Object		obj;
 	Capsule		capsule;
 	vast		bytesAvbl;
 	SourceExtent	extent;
 	int		failed = 0;
+	ZcoFilePass	pass;
 
-	CHKERR(sdr);
-	CHKERR(reader);
-	CHKERR(length >= 0);
 	if (length == 0)
 	{
 		return 0;
 	}
 
 	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
-	bytesToSkip = reader->lengthCopied;
+	memset((char *) &pass, 0, sizeof(ZcoFilePass));
+	firstHeader = zco.firstHeader;
+	firstExtent = zco.firstExtent;
+	firstTrailer = zco.firstTrailer;
+	if (reader->cursorObj && reader->cursorPosition == reader->lengthCopied)
+	{
+		/*	Resume at the cursor, bypassing all capsules
+		 *	and extents that have already been transmitted.	*/
+
+		bytesToSkip = reader->cursorOffset;
+		switch (reader->cursorList)
+		{
+		case ZCO_CURSOR_TRAILERS:
+			firstHeader = 0;
+			firstExtent = 0;
+			firstTrailer = reader->cursorObj;
+			break;
+
+		case ZCO_CURSOR_EXTENTS:
+			firstHeader = 0;
+			firstExtent = reader->cursorObj;
+			break;
+
+		default:
+			firstHeader = reader->cursorObj;
+		}
+	}
+	else
+	{
+		bytesToSkip = reader->lengthCopied;
+	}
+
 	bytesToTransmit = length;
 	bytesTransmitted = 0;
 
 	/*	Transmit any untransmitted header data.			*/
 
-	for (obj = zco.firstHeader; obj; obj = capsule.nextCapsule)
+	for (obj = firstHeader; obj; obj = capsule.nextCapsule)
 	{
 		if (bytesToTransmit == 0)	/*	Done.		*/
 		{
@@ -3006,15 +3384,17 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
 		reader->lengthCopied += bytesAvbl;
+		setCursor(reader, ZCO_CURSOR_HEADERS, obj,
+				bytesToSkip + bytesAvbl);
+		bytesToSkip = 0;
 		bytesToTransmit -= bytesAvbl;
 		bytesTransmitted += bytesAvbl;
 	}
 
 	/*	Transmit any untransmitted source data.			*/
 
-	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	for (obj = firstExtent; obj; obj = extent.nextExtent)
 	{
 		if (bytesToTransmit == 0)	/*	Done.		*/
 		{
@@ -3035,10 +3415,34 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			bytesAvbl = bytesToTransmit;
 		}
 
+		if (span && extent.sourceMedium == ZcoFileSource)
+		{
+			if (bytesTransmitted > 0)
+			{
+				/*	End span before the file.	*/
+
+				bytesToTransmit = 0;
+				break;
+			}
+
+			if (openFileSpan(sdr, span, &extent, bytesToSkip,
+					bytesAvbl, reader, &pass) < 0)
+			{
+				failed = 1;	/*	Source problem.	*/
+			}
+
+			reader->lengthCopied += bytesAvbl;
+			setCursor(reader, ZCO_CURSOR_EXTENTS, obj,
+					bytesToSkip + bytesAvbl);
+			bytesTransmitted = bytesAvbl;
+			bytesToTransmit = 0;
+			break;
+		}
+
 		if (buffer)
 		{
 			if (copyFromSource(sdr, buffer, &extent, bytesToSkip,
-					bytesAvbl, reader) < bytesAvbl)
+					bytesAvbl, reader, &pass) < bytesAvbl)
 			{
 				failed = 1;	/*	Source problem.	*/
 			}
@@ -3046,15 +3450,17 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
 		reader->lengthCopied += bytesAvbl;
+		setCursor(reader, ZCO_CURSOR_EXTENTS, obj,
+				bytesToSkip + bytesAvbl);
+		bytesToSkip = 0;
 		bytesToTransmit -= bytesAvbl;
 		bytesTransmitted += bytesAvbl;
 	}
 
 	/*	Transmit any untransmitted trailer data.		*/
 
-	for (obj = zco.firstTrailer; obj; obj = capsule.nextCapsule)
+	for (obj = firstTrailer; obj; obj = capsule.nextCapsule)
 	{
 		if (bytesToTransmit == 0)	/*	Done.		*/
 		{
@@ -3082,12 +3488,15 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
 		reader->lengthCopied += bytesAvbl;
+		setCursor(reader, ZCO_CURSOR_TRAILERS, obj,
+				bytesToSkip + bytesAvbl);
+		bytesToSkip = 0;
 		bytesToTransmit -= bytesAvbl;
 		bytesTransmitted += bytesAvbl;
 	}
 
+	endFilePass(sdr, &pass);
 	if (failed)
 	{
 		return 0;
@@ -3096,6 +3505,28 @@ vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
 	return bytesTransmitted;
 }
 
+vast	zco_transmit(Sdr sdr, ZcoReader *reader, vast length, char *buffer)
+{
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length >= 0);
+	return transmitZco(sdr, reader, length, buffer, NULL);
+}
+
+vast	zco_transmit_span(Sdr sdr, ZcoReader *reader, vast length,
+		char *buffer, ZcoSpan *span)
+{
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length >= 0);
+	CHKERR(buffer);
+	CHKERR(span);
+	span->fd = -1;
+	span->offset = 0;
+	span->length = transmitZco(sdr, reader, length, buffer, span);
+	return span->length;
+}
+
 /*	Functions for delivery to overlying protocol or application
  *	layer.								*/
 
@@ -3118,6 +3549,7 @@ vast	zco_receive_headers(Sdr sdr, ZcoReader *reader, vast length,
 	Object		obj;
 	SourceExtent	extent;
 	int		failed = 0;
+	ZcoFilePass	pass;
 
 	CHKERR(sdr);
 	CHKERR(reader);
@@ -3128,6 +3560,7 @@ vast	zco_receive_headers(Sdr sdr, ZcoReader *reader, vast length,
 	}
 
 	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
+	memset((char *) &pass, 0, sizeof(ZcoFilePass));
 	bytesToSkip = reader->headersLengthCopied;
 	bytesToReceive = length;
 	bytesReceived = 0;
@@ -3150,7 +3583,7 @@ vast	zco_receive_headers(Sdr sdr, ZcoReader *reader, vast length,
 		if (buffer)
 		{
 			if (copyFromSource(sdr, buffer, &extent, bytesToSkip,
-					bytesAvbl, reader) < bytesAvbl)
+					bytesAvbl, reader, &pass) < bytesAvbl)
 			{
 				failed = 1;	/*	Source problem.	*/
 			}
@@ -3171,6 +3604,7 @@ vast	zco_receive_headers(Sdr sdr, ZcoReader *reader, vast length,
 		}
 	}
 
+	endFilePass(sdr, &pass);
 	if (failed)
 	{
 		return 0;
@@ -3215,6 +3649,7 @@ vast	zco_receive_source(Sdr sdr, ZcoReader *reader, vast length,
 	Object		obj;
 	SourceExtent	extent;
 	int		failed = 0;
+	ZcoFilePass	pass;
 
 	CHKERR(sdr);
 	CHKERR(reader);
@@ -3225,6 +3660,7 @@ vast	zco_receive_source(Sdr sdr, ZcoReader *reader, vast length,
 	}
 
 	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
+	memset((char *) &pass, 0, sizeof(ZcoFilePass));
 	bytesToSkip = zco.headersLength + reader->sourceLengthCopied;
 	bytesToReceive = length;
 	bytesReceived = 0;
@@ -3247,7 +3683,7 @@ vast	zco_receive_source(Sdr sdr, ZcoReader *reader, vast length,
 		if (buffer)
 		{
 			if (copyFromSource(sdr, buffer, &extent, bytesToSkip,
-					bytesAvbl, reader) < bytesAvbl)
+					bytesAvbl, reader, &pass) < bytesAvbl)
 			{
 				failed = 1;	/*	Source problem.	*/
 			}
@@ -3268,6 +3704,224 @@ vast	zco_receive_source(Sdr sdr, ZcoReader *reader, vast length,
 		}
 	}
 
+	endFilePass(sdr, &pass);
+	if (failed)
+	{
+		return 0;
+	}
+
+	return bytesReceived;
+}
+
+static int	scanBuffered(Sdr sdr, SourceExtent *extent, vast bytesToSkip,
+			vast bytesAvbl, ZcoReader *reader, ZcoFilePass *pass,
+			char *buffer, ZcoScanner scan, void *arg)
+{
+	vast	bytesToCopy;
+
+	while (bytesAvbl > 0)
+	{
+		bytesToCopy = bytesAvbl;
+		if (bytesToCopy > ZCO_SCAN_BUFSZ)
+		{
+			bytesToCopy = ZCO_SCAN_BUFSZ;
+		}
+
+		if (copyFromSource(sdr, buffer, extent, bytesToSkip,
+				bytesToCopy, reader, pass) < bytesToCopy)
+		{
+			return 0;		/*	Source problem.	*/
+		}
+
+		if (scan(buffer, bytesToCopy, arg) < 0)
+		{
+			return -1;
+		}
+
+		bytesToSkip += bytesToCopy;
+		bytesAvbl -= bytesToCopy;
+	}
+
+	return 1;
+}
+
+static int	scanFile(Sdr sdr, SourceExtent *extent, vast bytesToSkip,
+			vast bytesAvbl, ZcoReader *reader, ZcoFilePass *pass,
+			char *buffer, ZcoScanner scan, void *arg)
+{
+#if ZCO_CAN_MAP_FILE
+	ZcoFileLien	fileLien;
+	FileRef		fileRef;
+	int		fd;
+	struct stat	statbuf;
+	vast		fileOffset;
+	vast		mapOffset;
+	size_t		mapLength;
+	char		*map;
+	int		result;
+
+	/*	Map the file's source data into memory and scan it in
+	 *	place, rather than copying it through the buffer.	*/
+
+	sdr_read(sdr, (char *) &fileLien, extent->location,
+			sizeof(ZcoFileLien));
+	sdr_read(sdr, (char *) &fileRef, fileLien.location, sizeof(FileRef));
+	fd = getSourceFile(fileLien.location, &fileRef, pass);
+	if (fd < 0)
+	{
+		return 0;			/*	Source problem.	*/
+	}
+
+	fileOffset = extent->offset + bytesToSkip;
+	if (fstat(fd, &statbuf) < 0
+	|| statbuf.st_size < fileOffset + bytesAvbl)
+	{
+		/*	Access to a mapped page beyond end of file
+		 *	would raise SIGBUS; copy through buffer.	*/
+
+		releaseSourceFile();
+		return scanBuffered(sdr, extent, bytesToSkip, bytesAvbl,
+				reader, pass, buffer, scan, arg);
+	}
+
+	mapOffset = fileOffset - (fileOffset % sysconf(_SC_PAGESIZE));
+	mapLength = (fileOffset - mapOffset) + bytesAvbl;
+	map = (char *) mmap(NULL, mapLength, PROT_READ, MAP_SHARED, fd,
+			mapOffset);
+	releaseSourceFile();
+	if (map != (char *) MAP_FAILED)
+	{
+		result = scan(map + (fileOffset - mapOffset), bytesAvbl, arg);
+		oK(munmap(map, mapLength));
+		if (result < 0)
+		{
+			return -1;
+		}
+
+		if (reader->trackFileOffset)
+		{
+			noteXmitProgress(sdr, pass, fileLien.location,
+					fileOffset + bytesAvbl);
+		}
+
+		return 1;
+	}
+#endif
+	return scanBuffered(sdr, extent, bytesToSkip, bytesAvbl, reader,
+			pass, buffer, scan, arg);
+}
+
+vast	zco_scan_source(Sdr sdr, ZcoReader *reader, vast length,
+		ZcoScanner scan, void *arg)
+{
+	Zco		zco;
+	vast		bytesToSkip;
+	vast		bytesToReceive;
+	vast		bytesReceived;
+	vast		bytesAvbl;
+	Object		obj;
+	SourceExtent	extent;
+	ZcoObjLien	objLien;
+	ObjRef		objRef;
+	char		*text;
+	char		buffer[ZCO_SCAN_BUFSZ];
+	int		result;
+	int		failed = 0;
+	ZcoFilePass	pass;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(scan);
+	CHKERR(length >= 0);
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
+	memset((char *) &pass, 0, sizeof(ZcoFilePass));
+	bytesToSkip = zco.headersLength + reader->sourceLengthCopied;
+	bytesToReceive = length;
+	bytesReceived = 0;
+	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	{
+		sdr_read(sdr, (char *) &extent, obj, sizeof(SourceExtent));
+		bytesAvbl = extent.length;
+		if (bytesToSkip >= bytesAvbl)
+		{
+			bytesToSkip -= bytesAvbl;
+			continue;	/*	Take none of this one.	*/
+		}
+
+		bytesAvbl -= bytesToSkip;
+		if (bytesToReceive < bytesAvbl)
+		{
+			bytesAvbl = bytesToReceive;
+		}
+
+		switch (extent.sourceMedium)
+		{
+		case ZcoObjSource:
+
+			/*	If the SDR heap is in memory, the
+			 *	object can be scanned in place.		*/
+
+			sdr_read(sdr, (char *) &objLien, extent.location,
+					sizeof(ZcoObjLien));
+			sdr_read(sdr, (char *) &objRef, objLien.location,
+					sizeof(ObjRef));
+			text = (char *) sdr_pointer(sdr, objRef.object
+					+ extent.offset + bytesToSkip);
+			if (text)
+			{
+				result = (scan(text, bytesAvbl, arg) < 0
+						? -1 : 1);
+				break;
+			}
+
+			result = scanBuffered(sdr, &extent, bytesToSkip,
+					bytesAvbl, reader, &pass, buffer, scan,
+					arg);
+			break;
+
+		case ZcoBulkSource:
+			result = scanBuffered(sdr, &extent, bytesToSkip,
+					bytesAvbl, reader, &pass, buffer, scan,
+					arg);
+			break;
+
+		default:	/*	Source text of extent is a file.	*/
+			result = scanFile(sdr, &extent, bytesToSkip,
+					bytesAvbl, reader, &pass, buffer, scan,
+					arg);
+		}
+
+		if (result < 0)
+		{
+			endFilePass(sdr, &pass);
+			putErrmsg("Can't scan ZCO source data.", NULL);
+			return -1;
+		}
+
+		if (result == 0)
+		{
+			failed = 1;	/*	Source problem.		*/
+		}
+
+		bytesToSkip = 0;
+
+		/*	Note bytes scanned.				*/
+
+		reader->sourceLengthCopied += bytesAvbl;
+		bytesToReceive -= bytesAvbl;
+		bytesReceived += bytesAvbl;
+		if (bytesToReceive == 0)	/*	Done.		*/
+		{
+			break;
+		}
+	}
+
+	endFilePass(sdr, &pass);
 	if (failed)
 	{
 		return 0;
@@ -3287,6 +3941,7 @@ vast	zco_receive_trailers(Sdr sdr, ZcoReader *reader, vast length,
 	Object		obj;
 	SourceExtent	extent;
 	int		failed = 0;
+	ZcoFilePass	pass;
 
 	CHKERR(sdr);
 	CHKERR(reader);
@@ -3297,6 +3952,7 @@ vast	zco_receive_trailers(Sdr sdr, ZcoReader *reader, vast length,
 	}
 
 	sdr_read(sdr, (char *) &zco, reader->zco, sizeof(Zco));
+	memset((char *) &pass, 0, sizeof(ZcoFilePass));
 	bytesToSkip = zco.headersLength + zco.sourceLength
 			+ reader->trailersLengthCopied;
 	bytesToReceive = length;
@@ -3320,7 +3976,7 @@ vast	zco_receive_trailers(Sdr sdr, ZcoReader *reader, vast length,
 		if (buffer)
 		{
 			if (copyFromSource(sdr, buffer, &extent, bytesToSkip,
-					bytesAvbl, reader) == 0)
+					bytesAvbl, reader, &pass) == 0)
 			{
 				failed = 1;	/*	File problem.	*/
 			}
@@ -3341,6 +3997,7 @@ vast	zco_receive_trailers(Sdr sdr, ZcoReader *reader, vast length,
 		}
 	}
 
+	endFilePass(sdr, &pass);
 	if (failed)
 	{
 		return 0;
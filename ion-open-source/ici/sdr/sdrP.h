@@ -62,6 +62,21 @@ typedef struct
 	PsmAddress	sdrs;	/*	An SmList of (SdrState *).	*/
 } SdrControlHeader;
 
+/*	When SDR_SHARED_READS is configured, each task (thread) that
+ *	currently holds a shared read-only transaction occupies one
+ *	SdrReader slot in the SdrState.					*/
+
+#ifndef SDR_MAX_READERS
+#define SDR_MAX_READERS	(32)
+#endif
+
+typedef struct
+{
+	int		task;			/*	Task ID.	*/
+	pthread_t	thread;			/*	Thread ID.	*/
+	int		depth;			/*	0 = unused.	*/
+} SdrReader;
+
 /*	SdrState is an object that encapsulates the volatile state of
  *	a single SDR.  It resides in SDR working memory (a shared
  *	memory partition), in the control header's list of sdrs.	*/
@@ -91,6 +106,13 @@ typedef struct sdr_str
 	int		maxLogLength;		/*	Max Log Length  */
 	PsmAddress	logEntries;		/*	Offsets in log.	*/
 
+		/*	Shared read-only transactions.		*/
+
+	sm_SemId	readersSemaphore;	/*	Guards readers.	*/
+	sm_SemId	updateTurnstile;	/*	Update priority.*/
+	int		readerCount;		/*	Active readers.	*/
+	SdrReader	readers[SDR_MAX_READERS];
+
 		/*	SDR trace data access.			*/
 
 	int		traceKey;		/*	trace shmKey	*/
@@ -170,6 +192,7 @@ typedef struct sdrv_str
 	uaddr		logsmId;	/*	Log shmId if applicable.*/
 
 	Lyst		knownObjects;	/*	ObjectExtents.		*/
+	Lyst		dirtyExtents;	/*	DirtyExtents.		*/
 	int		modified;	/*	Boolean.		*/
 
 	PsmView		traceArea;	/*	local access to trace	*/
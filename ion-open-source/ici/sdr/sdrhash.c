@@ -12,17 +12,193 @@
 
 #include "sdrP.h"
 #include "sdrlist.h"
-#include "sdrtable.h"
 #include "sdrhash.h"
 
+/*	An SDR hash table is a linear hash: the array of rows grows
+ *	by one row at a time, splitting the row at the "split"
+ *	cursor into itself and a new row at the end of the array,
+ *	whenever the mean list length exceeds the mean search
+ *	length requested at creation time.  Rows are kept in
+ *	fixed-size segments located through a directory, so no
+ *	single allocation ever grows with the population of the
+ *	table and no existing row ever moves.			*/
+
+#define	SEGMENT_ROWS_LOG2	(8)
+#define	SEGMENT_ROWS		(1 << SEGMENT_ROWS_LOG2)
+#define	SEGMENT_ROWS_MASK	(SEGMENT_ROWS - 1)
+
+#ifndef SDR_HASH_MAX_ROWS
+#define	SDR_HASH_MAX_ROWS	(1 << 24)
+#endif
+
+typedef struct
+{
+	int	keyLength;
+	int	meanSearchLength;
+	int	baseRowCount;	/*	Row count at creation time.	*/
+	int	level;		/*	Nbr of times row count doubled.	*/
+	int	splitRow;	/*	Next row to split.		*/
+	int	entryCount;
+	int	directorySize;	/*	Number of segments.		*/
+	Object	directory;	/*	Array of segment addresses.	*/
+} SdrHash;
+
+/*	Each entry is a variable-length record: only as many key
+ *	bytes as the table's key length are allocated and read.
+ *	The record's address is the entry handle returned to the
+ *	application, so it must not change when a row is split;
+ *	the record instead notes the list element that currently
+ *	refers to it, which is revised when the entry moves.	*/
+
 typedef struct
 {
+	Object	elt;
 	Address	value;
 	char	key[255];
-} KvPair;
+} HashEntry;
+
+#define	ENTRY_LENGTH(keyLength)	\
+	(sizeof(Object) + sizeof(Address) + (keyLength))
 
 /*	*	*	Table management functions	*	*	*/
 
+static unsigned int	hashKey(int keyLength, char *key)
+{
+	unsigned char	*cursor = (unsigned char *) key;
+	unsigned int	h = 2166136261U;	/*	FNV-1a		*/
+	int		i;
+
+	for (i = 0; i < keyLength; i++, cursor++)
+	{
+		h ^= *cursor;
+		h *= 16777619U;
+	}
+
+	return h;
+}
+
+static int	computeRowNbr(SdrHash *hash, unsigned int h)
+{
+	unsigned int	rowNbr;
+
+	rowNbr = h % (((unsigned int) (hash->baseRowCount)) << hash->level);
+	if (rowNbr < (unsigned int) (hash->splitRow))
+	{
+		/*	This row has already been split in the
+		 *	current round, so use the next round's
+		 *	modulus.					*/
+
+		rowNbr = h % (((unsigned int) (hash->baseRowCount))
+				<< (hash->level + 1));
+	}
+
+	return rowNbr;
+}
+
+static int	rowCount(SdrHash *hash)
+{
+	return (hash->baseRowCount << hash->level) + hash->splitRow;
+}
+
+static Address	rowAddress(Sdr sdrv, SdrHash *hash, int rowNbr)
+{
+	Object	segment;
+
+	sdr_read(sdrv, (char *) &segment, hash->directory
+			+ ((rowNbr >> SEGMENT_ROWS_LOG2) * sizeof(Object)),
+			sizeof(Object));
+	return segment + ((rowNbr & SEGMENT_ROWS_MASK) * sizeof(Object));
+}
+
+static Object	rowList(Sdr sdrv, SdrHash *hash, int rowNbr)
+{
+	Object	listAddr;
+
+	sdr_read(sdrv, (char *) &listAddr, rowAddress(sdrv, hash, rowNbr),
+			sizeof(Object));
+	return listAddr;
+}
+
+static int	addRow(const char *file, int line, Sdr sdrv, Object hashObj,
+			SdrHash *hash, int rowNbr, Object *listAddr)
+{
+	int	segmentNbr = rowNbr >> SEGMENT_ROWS_LOG2;
+	int	directorySize;
+	Object	directory;
+	Object	segments[SEGMENT_ROWS];
+	int	i;
+	int	j;
+	Object	segment;
+
+	if ((rowNbr & SEGMENT_ROWS_MASK) == 0)
+	{
+		/*	First row of a new segment.		*/
+
+		if (segmentNbr == hash->directorySize)
+		{
+			/*	Directory is full; double it.	*/
+
+			directorySize = hash->directorySize << 1;
+			directory = Sdr_malloc(file, line, sdrv,
+					directorySize * sizeof(Object));
+			if (directory == 0)
+			{
+				oK(_iEnd(file, line, "directory"));
+				return -1;
+			}
+
+			for (i = 0; i < hash->directorySize; i += j)
+			{
+				j = hash->directorySize - i;
+				if (j > SEGMENT_ROWS)
+				{
+					j = SEGMENT_ROWS;
+				}
+
+				sdr_read(sdrv, (char *) segments,
+					hash->directory + (i * sizeof(Object)),
+					j * sizeof(Object));
+				_sdrput(file, line, sdrv, directory
+					+ (i * sizeof(Object)),
+					(char *) segments, j * sizeof(Object),
+					SystemPut);
+			}
+
+			Sdr_free(file, line, sdrv, hash->directory);
+			hash->directory = directory;
+			hash->directorySize = directorySize;
+		}
+
+		segment = Sdr_malloc(file, line, sdrv,
+				SEGMENT_ROWS * sizeof(Object));
+		if (segment == 0)
+		{
+			oK(_iEnd(file, line, "segment"));
+			return -1;
+		}
+
+		_sdrput(file, line, sdrv, hash->directory
+				+ (segmentNbr * sizeof(Object)),
+				(char *) &segment, sizeof(Object), SystemPut);
+	}
+
+	*listAddr = Sdr_list_create(file, line, sdrv);
+	if (*listAddr == 0)
+	{
+		oK(_iEnd(file, line, "listAddr"));
+		return -1;
+	}
+
+	/*	The row's list notes the hash table it belongs to,
+	 *	so that an entry can be deleted given only the
+	 *	entry itself.					*/
+
+	Sdr_list_user_data_set(file, line, sdrv, *listAddr, hashObj);
+	_sdrput(file, line, sdrv, rowAddress(sdrv, hash, rowNbr),
+			(char *) listAddr, sizeof(Object), SystemPut);
+	return 0;
+}
+
 Object	Sdr_hash_create(const char *file, int line, Sdr sdrv, int keyLength,
 		int estNbrOfEntries, int meanSearchLength)
 {
@@ -30,38 +206,33 @@ Object	Sdr_hash_create(const char *file, int line, Sdr sdrv, int keyLength,
  	*	key/value pairs.  Given a key, we look up the corresponding
  	*	value by hashing from the key to a row number and then
  	*	searching through the key/value pairs in the linked list at
- 	*	that row.  Minimizing the lengths of the lists in the table
- 	*	minimizes lookup time, but in so doing it either increases
- 	*	the number of rows in the table (increasing the table's fixed
- 	*	size) or limits the number of entries.  We try to strike a
- 	*	balance by computing the number of rows automatically from
+ 	*	that row.  The table grows as entries are inserted, so the
+	*	initial row count matters only to the extent that it spares
+	*	the table some splitting early on.  We compute it from
  	*	A = the estimated total number of entries in the table and
  	*	B = the desired mean list length:
  	*
  	*		1.	Raw preferred row count C = A / B.
  	*
- 	*		2.	Actual row count must be a prime number
- 	*			in order for the hash function to work
- 	*			properly, so search the hash dimensions
- 	*			table for the smallest row count that is
- 	*			greater than or equal to C.		*/
+ 	*		2.	Search the hash dimensions table for the
+	*			smallest row count that is greater than
+	*			or equal to C.				*/
 
 	static const int	hashDimensions[] =
 			{ 71, 131, 257, 521, 1031, 2053, 4099, 8209, 16411 };
 
-	/*	Each of the predefined possible hash table dimensions is the
- 	*	smallest prime number greater than some power of 2, starting
- 	*	with 2**6 = 64.  16411 is the maximum hash table dimension,
- 	*	used for any value of C that is greater than 8209; on a 32-bit
- 	*	machine, this limit assures that the table itself (excluding
- 	*	the lists at its rows) will occupy no more than 65644 bytes
- 	*	plus the table header size.				*/
+	/*	Each of the predefined possible initial hash table
+	 *	dimensions is the smallest prime number greater than some
+	 *	power of 2, starting with 2**6 = 64; a prime base row
+	 *	count spreads keys evenly across rows even when the hash
+	 *	values of the keys have structure of their own.  16411
+	 *	is the maximum initial dimension, used for any value of
+	 *	C that is greater than 8209.				*/
 
 	int	rawRowCount;
 	int	i;
-	int	rowCount;
-	Object	table;
-	Address	rowAddr;
+	SdrHash	hash;
+	Object	hashObj;
 	Object	listAddr;
 
 	if (!(sdr_in_xn(sdrv)))
@@ -81,9 +252,9 @@ Object	Sdr_hash_create(const char *file, int line, Sdr sdrv, int keyLength,
 	i = 0;
 	while (1)
 	{
-		rowCount = hashDimensions[i];
+		hash.baseRowCount = hashDimensions[i];
 		i++;
-		if (rowCount <= rawRowCount
+		if (hash.baseRowCount <= rawRowCount
 		&& i < (sizeof hashDimensions / sizeof(int)))
 		{
 			continue;
@@ -92,72 +263,147 @@ Object	Sdr_hash_create(const char *file, int line, Sdr sdrv, int keyLength,
 		break;
 	}
 
-	table = Sdr_table_create(file, line, sdrv, sizeof(Object), rowCount);
-	if (table == 0)
+	hash.keyLength = keyLength;
+	hash.meanSearchLength = meanSearchLength;
+	hash.level = 0;
+	hash.splitRow = 0;
+	hash.entryCount = 0;
+	hash.directorySize = 1;
+	while ((hash.directorySize << SEGMENT_ROWS_LOG2) < hash.baseRowCount)
 	{
-		oK(_iEnd(file, line, itoa(rowCount)));
-		return 0;
+		hash.directorySize <<= 1;
 	}
 
-	/*	Save key length for hash function.			*/
-
-	Sdr_table_user_data_set(file, line, sdrv, table, (Address) keyLength);
+	hash.directory = Sdr_malloc(file, line, sdrv,
+			hash.directorySize * sizeof(Object));
+	hashObj = Sdr_malloc(file, line, sdrv, sizeof(SdrHash));
+	if (hash.directory == 0 || hashObj == 0)
+	{
+		oK(_iEnd(file, line, "hash"));
+		return 0;
+	}
 
 	/*	Create linked lists for all rows of the hash table.	*/
 
-	for (i = 0; i < rowCount; i++)
+	for (i = 0; i < hash.baseRowCount; i++)
 	{
-		rowAddr = sdr_table_row(sdrv, table, i);
-		listAddr = Sdr_list_create(file, line, sdrv);
-		if (listAddr == 0)
+		if (addRow(file, line, sdrv, hashObj, &hash, i, &listAddr) < 0)
 		{
-			oK(_iEnd(file, line, "listAddr"));
 			return 0;
 		}
+	}
+
+	_sdrput(file, line, sdrv, hashObj, (char *) &hash, sizeof(SdrHash),
+			SystemPut);
+	return hashObj;
+}
+
+static int	splitRow(const char *file, int line, Sdr sdrv, Object hashObj,
+			SdrHash *hash)
+{
+	int		newRowNbr;
+	unsigned int	newModulus;
+	Object		oldList;
+	Object		newList;
+	Object		elt;
+	Object		nextElt;
+	Object		entryAddr;
+	HashEntry	entry;
+
+	/*	Split the row at the split cursor, moving to a new row
+	 *	at the end of the array every entry whose key hashes
+	 *	to that new row under the next round's modulus.  Entry
+	 *	order within each row is preserved, so both rows stay
+	 *	sorted by key.						*/
+
+	newRowNbr = (hash->baseRowCount << hash->level) + hash->splitRow;
+	newModulus = ((unsigned int) (hash->baseRowCount)) << (hash->level + 1);
+	oldList = rowList(sdrv, hash, hash->splitRow);
+	if (addRow(file, line, sdrv, hashObj, hash, newRowNbr, &newList) < 0)
+	{
+		return -1;
+	}
+
+	for (elt = sdr_list_first(sdrv, oldList); elt; elt = nextElt)
+	{
+		nextElt = sdr_list_next(sdrv, elt);
+		entryAddr = sdr_list_data(sdrv, elt);
+		sdr_read(sdrv, (char *) &entry, entryAddr,
+				ENTRY_LENGTH(hash->keyLength));
+		if (hashKey(hash->keyLength, entry.key) % newModulus
+				!= (unsigned int) newRowNbr)
+		{
+			continue;
+		}
+
+		entry.elt = Sdr_list_insert_last(file, line, sdrv, newList,
+				entryAddr);
+		if (entry.elt == 0)
+		{
+			oK(_iEnd(file, line, "elt"));
+			return -1;
+		}
 
-		_sdrput(file, line, sdrv, rowAddr, (char *) &listAddr,
+		_sdrput(file, line, sdrv, entryAddr, (char *) &entry.elt,
 				sizeof(Object), SystemPut);
+		Sdr_list_delete(file, line, sdrv, elt, NULL, NULL);
+	}
+
+	hash->splitRow++;
+	if (hash->splitRow == (hash->baseRowCount << hash->level))
+	{
+		hash->level++;
+		hash->splitRow = 0;
 	}
 
-	return table;
+	return 0;
 }
 
-static int	computeRowNbr(int rowCount, int keyLength, char *key)
+static int	locateEntry(Sdr sdrv, SdrHash *hash, char *key,
+			Object *listAddr, Object *elt, HashEntry *entry)
 {
-	int		i;
-	unsigned int	h = 0;
-	unsigned int	g;
+	Object	entryAddr;
+	int	result;
 
-	for (i = 0; i < keyLength; i++, key++)
+	/*	Returns 1 if the entry was found, in which case *elt
+	 *	is its list element and *entry its content.  Otherwise
+	 *	returns 0 and *elt is the element before which an
+	 *	entry with this key would be inserted, or 0 if such
+	 *	an entry would be appended to the list.		*/
+
+	*listAddr = rowList(sdrv, hash, computeRowNbr(hash,
+			hashKey(hash->keyLength, key)));
+	for (*elt = sdr_list_first(sdrv, *listAddr); *elt;
+			*elt = sdr_list_next(sdrv, *elt))
 	{
-		h = (h << 4) + *key;
-		g = h & 0xf0000000;
-		if (g)
+		entryAddr = sdr_list_data(sdrv, *elt);
+		sdr_read(sdrv, (char *) entry, entryAddr,
+				ENTRY_LENGTH(hash->keyLength));
+		result = memcmp(entry->key, key, hash->keyLength);
+		if (result < 0)
+		{
+			continue;
+		}
+
+		if (result > 0)
 		{
-			h ^= g >> 24;
+			break;	/*	Not found.			*/
 		}
 
-		h &= ~g;
+		return 1;
 	}
 
-	return h % rowCount;
+	return 0;
 }
 
-int	Sdr_hash_insert(const char *file, int line, Sdr sdrv, Object hash,
+int	Sdr_hash_insert(const char *file, int line, Sdr sdrv, Object hashObj,
 		char *key, Address value, Object *entry)
 {
-	int	keyLength;
-	int	kvpairLength;
-	int	rowSize;
-	int	rowCount;
-	int	rowNbr;
-	Address	rowAddr;
-	Object	listAddr;
-	Object	elt;
-	Object	kvpairAddr;
-	KvPair	kvpair;
-	int	result;
-	Object	hashElt;
+	SdrHash		hash;
+	Object		listAddr;
+	Object		elt;
+	Object		entryAddr;
+	HashEntry	hashEntry;
 
 	if (entry)
 	{
@@ -171,77 +417,88 @@ int	Sdr_hash_insert(const char *file, int line, Sdr sdrv, Object hash,
 	}
 
 	joinTrace(sdrv, file, line);
-	if (hash == 0 || key == NULL)
+	if (hashObj == 0 || key == NULL)
 	{
 		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
 		return -1;
 	}
 
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	rowNbr = computeRowNbr(rowCount, keyLength, key);
-	rowAddr = sdr_table_row(sdrv, hash, rowNbr);
-	sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-	for (elt = sdr_list_first(sdrv, listAddr); elt;
-			elt = sdr_list_next(sdrv, elt))
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	if (locateEntry(sdrv, &hash, key, &listAddr, &elt, &hashEntry))
 	{
-		kvpairAddr = sdr_list_data(sdrv, elt);
-		sdr_read(sdrv, (char *) &kvpair, kvpairAddr, kvpairLength);
-		result = memcmp(kvpair.key, key, keyLength);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)
-		{
-			break;	/*	Insert before this entry.	*/
-		}
-
 		return 0;	/*	Duplicate key, can't insert.	*/
 	}
 
-	kvpairAddr = Sdr_malloc(file, line, sdrv, kvpairLength);
-	if (kvpairAddr == 0)
+	entryAddr = Sdr_malloc(file, line, sdrv, ENTRY_LENGTH(hash.keyLength));
+	if (entryAddr == 0)
 	{
-		oK(_iEnd(file, line, "kvpairAddr"));
+		oK(_iEnd(file, line, "entryAddr"));
 		return -1;
 	}
 
-	kvpair.value = value;
-	memcpy(kvpair.key, key, keyLength);
-	_sdrput(file, line, sdrv, kvpairAddr, (char *) &kvpair, kvpairLength,
-			SystemPut);
 	if (elt)
 	{
-		hashElt = Sdr_list_insert_before(file, line, sdrv, elt,
-				kvpairAddr);
+		hashEntry.elt = Sdr_list_insert_before(file, line, sdrv, elt,
+				entryAddr);
 	}
 	else
 	{
-		hashElt = Sdr_list_insert_last(file, line, sdrv, listAddr,
-				kvpairAddr);
+		hashEntry.elt = Sdr_list_insert_last(file, line, sdrv,
+				listAddr, entryAddr);
 	}
 
-	if (hashElt == 0)
+	if (hashEntry.elt == 0)
 	{
 		oK(_iEnd(file, line, "elt"));
 		return -1;
 	}
 
+	hashEntry.value = value;
+	memcpy(hashEntry.key, key, hash.keyLength);
+	_sdrput(file, line, sdrv, entryAddr, (char *) &hashEntry,
+			ENTRY_LENGTH(hash.keyLength), SystemPut);
+
+	/*	Grow the table by one row if the mean list length now
+	 *	exceeds the length requested at creation time.		*/
+
+	hash.entryCount++;
+	if ((uvast) hash.entryCount
+			> (uvast) rowCount(&hash) * hash.meanSearchLength
+	&& (hash.baseRowCount << hash.level) < SDR_HASH_MAX_ROWS)
+	{
+		if (splitRow(file, line, sdrv, hashObj, &hash) < 0)
+		{
+			return -1;
+		}
+	}
+
+	_sdrput(file, line, sdrv, hashObj, (char *) &hash, sizeof(SdrHash),
+			SystemPut);
 	if (entry)
 	{
-		*entry = hashElt;
+		*entry = entryAddr;
 	}
 
 	return 1;		/*	Succeeded.			*/
 }
 
+static void	deleteEntry(const char *file, int line, Sdr sdrv,
+			Object hashObj, Object elt, Object entryAddr)
+{
+	SdrHash	hash;
+
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	hash.entryCount--;
+	_sdrput(file, line, sdrv, hashObj, (char *) &hash, sizeof(SdrHash),
+			SystemPut);
+	Sdr_free(file, line, sdrv, entryAddr);
+	Sdr_list_delete(file, line, sdrv, elt, NULL, NULL);
+}
+
 int	Sdr_hash_delete_entry(const char *file, int line, Sdr sdrv,
 		Object entry)
 {
-	Object	kvpairAddr;
+	Object	elt;
 
 	if (!(sdr_in_xn(sdrv)))
 	{
@@ -256,42 +513,30 @@ int	Sdr_hash_delete_entry(const char *file, int line, Sdr sdrv,
 		return -1;
 	}
 
-	kvpairAddr = sdr_list_data(sdrv, entry);
-	Sdr_free(file, line, sdrv, kvpairAddr);
-	Sdr_list_delete(file, line, sdrv, entry, NULL, NULL);
+	sdr_read(sdrv, (char *) &elt, entry, sizeof(Object));
+	deleteEntry(file, line, sdrv, sdr_list_user_data(sdrv,
+			sdr_list_list(sdrv, elt)), elt, entry);
 	return 1;
 }
 
 Address	sdr_hash_entry_value(Sdr sdrv, Object hash, Object entry)
 {
-	int	keyLength;
-	int	kvpairLength;
-	Object	kvpairAddr;
-	KvPair	kvpair;
+	Address	value;
 
 	CHKERR(sdrFetchSafe(sdrv));
 	CHKERR(entry);
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	kvpairAddr = sdr_list_data(sdrv, entry);
-	sdr_read(sdrv, (char *) &kvpair, kvpairAddr, kvpairLength);
-	return kvpair.value;
+	sdr_read(sdrv, (char *) &value, entry + sizeof(Object),
+			sizeof(Address));
+	return value;
 }
 
-int	sdr_hash_retrieve(Sdr sdrv, Object hash, char *key, Address *value,
+int	sdr_hash_retrieve(Sdr sdrv, Object hashObj, char *key, Address *value,
 		Object *entry)
 {
-	int		keyLength;
-	int		kvpairLength;
-	int		rowSize;
-	int		rowCount;
-	int		rowNbr;
-	Address		rowAddr;
+	SdrHash		hash;
 	Object		listAddr;
 	Object		elt;
-	Address		kvpairAddr;
-	KvPair		kvpair;
-	int		result;
+	HashEntry	hashEntry;
 
 	if (entry)
 	{
@@ -299,128 +544,84 @@ int	sdr_hash_retrieve(Sdr sdrv, Object hash, char *key, Address *value,
 	}
 
 	CHKERR(sdrFetchSafe(sdrv));
-	CHKERR(hash);
+	CHKERR(hashObj);
 	CHKERR(key);
 	CHKERR(value);
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	rowNbr = computeRowNbr(rowCount, keyLength, key);
-	rowAddr = sdr_table_row(sdrv, hash, rowNbr);
-	sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-	for (elt = sdr_list_first(sdrv, listAddr); elt;
-			elt = sdr_list_next(sdrv, elt))
-	{
-		kvpairAddr = sdr_list_data(sdrv, elt);
-		sdr_read(sdrv, (char *) &kvpair, kvpairAddr, kvpairLength);
-		result = memcmp(kvpair.key, key, keyLength);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)
-		{
-			break;	/*	Not found.			*/
-		}
-
-		*value = kvpair.value;
-		if (entry)
-		{
-			*entry = elt;
-		}
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	if (locateEntry(sdrv, &hash, key, &listAddr, &elt, &hashEntry) == 0)
+	{
+		return 0;	/*	Unable to retrieve value.	*/
+	}
 
-		return 1;	/*	Got it.				*/
+	*value = hashEntry.value;
+	if (entry)
+	{
+		*entry = sdr_list_data(sdrv, elt);
 	}
 
-	return 0;		/*	Unable to retrieve value.	*/
+	return 1;		/*	Got it.				*/
 }
 
-int	sdr_hash_count(Sdr sdrv, Object hash)
+int	sdr_hash_count(Sdr sdrv, Object hashObj)
 {
-	int	count = 0;
-	int	rowSize;
-	int	rowCount;
-	int	i;
-	Address	rowAddr;
-	Object	listAddr;
+	SdrHash	hash;
 
 	CHKERR(sdrv);
-	CHKERR(hash);
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	for (i = 0; i < rowCount; i++)
-	{
-		rowAddr = sdr_table_row(sdrv, hash, i);
-		sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-		count += sdr_list_length(sdrv, listAddr);
-	}
-
-	return count;
+	CHKERR(hashObj);
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	return hash.entryCount;
 }
 
-int	sdr_hash_foreach(Sdr sdrv, Object hash, sdr_hash_callback callback,
+int	sdr_hash_foreach(Sdr sdrv, Object hashObj, sdr_hash_callback callback,
 		void *args)
 {
-	int		keyLength;
-	int		kvpairLength;
-	int		rowSize;
-	int		rowCount;
+	SdrHash		hash;
 	int		rowNbr;
-	Address		rowAddr;
 	Object		listAddr;
 	Object		elt;
-	Object		kvpairAddr;
-	KvPair		kvpair;
+	Object		entryAddr;
+	HashEntry	hashEntry;
 
 	CHKERR(sdrFetchSafe(sdrv));
-	CHKERR(hash);
+	CHKERR(hashObj);
 	CHKERR(callback);
 	//Passing NULL args is OK (passed through to callback)
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
 
 	/*	Iterate over each row/bucket, loading the sdrlist
 	 *	of members of each.					*/
 
-	for (rowNbr = 0; rowNbr < rowCount; rowNbr++)
+	for (rowNbr = 0; rowNbr < rowCount(&hash); rowNbr++)
 	{
-		rowAddr = sdr_table_row(sdrv, hash, rowNbr);
-		sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
+		listAddr = rowList(sdrv, &hash, rowNbr);
 
 		/*	Iterate over each member of this bucket.	*/
 
 		for (elt = sdr_list_first(sdrv, listAddr); elt;
 				elt = sdr_list_next(sdrv, elt))
 		{
-			kvpairAddr = sdr_list_data(sdrv, elt);
-			sdr_read(sdrv, (char *) &kvpair, kvpairAddr,
-					kvpairLength);
+			entryAddr = sdr_list_data(sdrv, elt);
+			sdr_read(sdrv, (char *) &hashEntry, entryAddr,
+					ENTRY_LENGTH(hash.keyLength));
 
 			/*	Call the callback passed to us with
 			 *	the key, value pair.			*/
 
-			callback(sdrv, hash, kvpair.key, kvpair.value, args);
+			callback(sdrv, hashObj, hashEntry.key, hashEntry.value,
+					args);
 		}
 	}
 
 	return 0;
 }
 
-int	Sdr_hash_revise(const char *file, int line, Sdr sdrv, Object hash,
+int	Sdr_hash_revise(const char *file, int line, Sdr sdrv, Object hashObj,
 		char *key, Address value)
 {
-	int	keyLength;
-	int	kvpairLength;
-	int	rowSize;
-	int	rowCount;
-	int	rowNbr;
-	Address	rowAddr;
-	Object	listAddr;
-	Object	elt;
-	Object	kvpairAddr;
-	KvPair	kvpair;
-	int	result;
+	SdrHash		hash;
+	Object		listAddr;
+	Object		elt;
+	HashEntry	hashEntry;
 
 	if (!(sdr_in_xn(sdrv)))
 	{
@@ -429,57 +630,30 @@ int	Sdr_hash_revise(const char *file, int line, Sdr sdrv, Object hash,
 	}
 
 	joinTrace(sdrv, file, line);
-	if (hash == 0 || key == NULL)
+	if (hashObj == 0 || key == NULL)
 	{
 		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
 		return -1;
 	}
 
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	rowNbr = computeRowNbr(rowCount, keyLength, key);
-	rowAddr = sdr_table_row(sdrv, hash, rowNbr);
-	sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-	for (elt = sdr_list_first(sdrv, listAddr); elt;
-			elt = sdr_list_next(sdrv, elt))
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	if (locateEntry(sdrv, &hash, key, &listAddr, &elt, &hashEntry) == 0)
 	{
-		kvpairAddr = sdr_list_data(sdrv, elt);
-		sdr_read(sdrv, (char *) &kvpair, kvpairAddr, kvpairLength);
-		result = memcmp(kvpair.key, key, keyLength);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)
-		{
-			break;	/*	Not found.			*/
-		}
-
-		kvpair.value = value;
-		_sdrput(file, line, sdrv, kvpairAddr, (char *) &kvpair,
-				kvpairLength, SystemPut);
-		return 1;	/*	Succeeded.			*/
+		return 0;	/*	Unable to revise value.		*/
 	}
 
-	return 0;		/*	Unable to revise value.		*/
+	_sdrput(file, line, sdrv, sdr_list_data(sdrv, elt) + sizeof(Object),
+			(char *) &value, sizeof(Address), SystemPut);
+	return 1;		/*	Succeeded.			*/
 }
 
-int	Sdr_hash_remove(const char *file, int line, Sdr sdrv, Object hash,
+int	Sdr_hash_remove(const char *file, int line, Sdr sdrv, Object hashObj,
 		char *key, Address *value)
 {
-	int	keyLength;
-	int	kvpairLength;
-	int	rowSize;
-	int	rowCount;
-	int	rowNbr;
-	Address	rowAddr;
-	Object	listAddr;
-	Object	elt;
-	Object	kvpairAddr;
-	KvPair	kvpair;
-	int	result;
+	SdrHash		hash;
+	Object		listAddr;
+	Object		elt;
+	HashEntry	hashEntry;
 
 	if (!(sdr_in_xn(sdrv)))
 	{
@@ -488,59 +662,37 @@ int	Sdr_hash_remove(const char *file, int line, Sdr sdrv, Object hash,
 	}
 
 	joinTrace(sdrv, file, line);
-	if (hash == 0 || key == NULL)
+	if (hashObj == 0 || key == NULL)
 	{
 		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
 		return -1;
 	}
 
-	keyLength = sdr_table_user_data(sdrv, hash);
-	kvpairLength = sizeof(Address) + keyLength;
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	rowNbr = computeRowNbr(rowCount, keyLength, key);
-	rowAddr = sdr_table_row(sdrv, hash, rowNbr);
-	sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-	for (elt = sdr_list_first(sdrv, listAddr); elt;
-			elt = sdr_list_next(sdrv, elt))
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	if (locateEntry(sdrv, &hash, key, &listAddr, &elt, &hashEntry) == 0)
 	{
-		kvpairAddr = sdr_list_data(sdrv, elt);
-		sdr_read(sdrv, (char *) &kvpair, kvpairAddr, kvpairLength);
-		result = memcmp(kvpair.key, key, keyLength);
-		if (result < 0)
-		{
-			continue;
-		}
-
-		if (result > 0)
-		{
-			break;	/*	Not found.			*/
-		}
-
-		if (value)
-		{
-			*value = kvpair.value;
-		}
+		return 0;	/*	Unable to remove entry.		*/
+	}
 
-		Sdr_free(file, line, sdrv, kvpairAddr);
-		Sdr_list_delete(file, line, sdrv, elt, NULL, NULL);
-		return 1;	/*	Succeeded.			*/
+	if (value)
+	{
+		*value = hashEntry.value;
 	}
 
-	return 0;		/*	Unable to remove entry.		*/
+	deleteEntry(file, line, sdrv, hashObj, elt, sdr_list_data(sdrv, elt));
+	return 1;		/*	Succeeded.			*/
 }
 
-static void	deleteHashEntry(Sdr sdrv, Object eltData, void *arg)
+static void	deleteHashEntry(Sdr sdrv, Object elt, void *arg)
 {
-	sdr_free(sdrv, eltData);
+	sdr_free(sdrv, sdr_list_data(sdrv, elt));
 }
 
-void	Sdr_hash_destroy(const char *file, int line, Sdr sdrv, Object hash)
+void	Sdr_hash_destroy(const char *file, int line, Sdr sdrv, Object hashObj)
 {
-	int	rowSize;
-	int	rowCount;
+	SdrHash	hash;
 	int	i;
-	Address	rowAddr;
-	Object	listAddr;
+	Object	segment;
 
 	if (!(sdr_in_xn(sdrv)))
 	{
@@ -549,20 +701,27 @@ void	Sdr_hash_destroy(const char *file, int line, Sdr sdrv, Object hash)
 	}
 
 	joinTrace(sdrv, file, line);
-	if (hash == 0)
+	if (hashObj == 0)
 	{
 		oK(_xniEnd(file, line, "hash", sdrv));
 		return;
 	}
 
-	sdr_table_dimensions(sdrv, hash, &rowSize, &rowCount);
-	for (i = 0; i < rowCount; i++)
+	sdr_read(sdrv, (char *) &hash, hashObj, sizeof(SdrHash));
+	for (i = 0; i < rowCount(&hash); i++)
+	{
+		Sdr_list_destroy(file, line, sdrv, rowList(sdrv, &hash, i),
+				deleteHashEntry, NULL);
+	}
+
+	for (i = 0; i < rowCount(&hash); i += SEGMENT_ROWS)
 	{
-		rowAddr = sdr_table_row(sdrv, hash, i);
-		sdr_read(sdrv, (char *) &listAddr, rowAddr, sizeof(Object));
-		Sdr_list_destroy(file, line, sdrv, listAddr, deleteHashEntry,
-				NULL);
+		sdr_read(sdrv, (char *) &segment, hash.directory
+				+ ((i >> SEGMENT_ROWS_LOG2) * sizeof(Object)),
+				sizeof(Object));
+		Sdr_free(file, line, sdrv, segment);
 	}
 
-	Sdr_table_destroy(file, line, sdrv, hash);
+	Sdr_free(file, line, sdrv, hash.directory);
+	Sdr_free(file, line, sdrv, hashObj);
 }
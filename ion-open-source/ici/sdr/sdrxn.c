@@ -26,7 +26,41 @@
 #define SDR_SEMKEY	(0xeee0)
 #endif
 
+/*	When SDR_DEFER_WRITES is in effect, modified ranges of the
+ *	dataspace that are separated by no more than this many
+ *	unmodified bytes are written to the file as a single range;
+ *	the unmodified bytes are simply rewritten from the DRAM copy
+ *	of the dataspace, which is identical to the file copy.		*/
+
+#ifndef SDR_WRITE_COALESCE_GAP
+#define SDR_WRITE_COALESCE_GAP	(512)
+#endif
+
+/*	When SDR_MAP_FILE is in effect, the ranges of the mapped
+ *	dataspace file that were modified in a transaction are
+ *	msync'd with these flags when the transaction ends.  The
+ *	default only schedules the writes, which is as durable as
+ *	the write() calls used for an unmapped dataspace file;
+ *	compile with -DSDR_MSYNC_FLAGS=MS_SYNC to wait for them.	*/
+
+#ifdef unix
+#include <sys/mman.h>
+#define	SDR_CAN_MAP_FILE	1
+#ifndef SDR_MSYNC_FLAGS
+#define	SDR_MSYNC_FLAGS		(MS_ASYNC)
+#endif
+#else
+#define	SDR_CAN_MAP_FILE	0
+#endif
+
+typedef struct
+{
+	Address		from;	/*	1st byte modified		*/
+	Address		to;	/*	1st byte beyond modified range	*/
+} DirtyExtent;
+
 static PsmPartition	_sdrwm(sm_WmParms *parms);
+static void		endSharedReads(SdrState *sdr);
 
 #ifndef SDR_TRACE
 char	*_noTraceMsg()
@@ -191,6 +225,8 @@ static SdrControlHeader	*_sch(SdrControlHeader **schp)
 					sm_SemDelete(sdr->sdrSemaphore);
 					sdr->sdrSemaphore = SM_SEM_NONE;
 				}
+
+				endSharedReads(sdr);
 			}
 
 			sm_SemGive(lock);
@@ -394,11 +430,107 @@ SdrMap	*_mapImage(Sdr sdrv)
 
 /*	*	Mutual exclusion functions	*	*	*	*/
 
+static void	endSharedReads(SdrState *sdr)
+{
+	if (sdr->readersSemaphore == SM_SEM_NONE)
+	{
+		return;		/*	Shared reads not configured.	*/
+	}
+
+	sm_SemEnd(sdr->readersSemaphore);
+	sm_SemEnd(sdr->updateTurnstile);
+	microsnooze(50000);
+	sm_SemDelete(sdr->readersSemaphore);
+	sm_SemDelete(sdr->updateTurnstile);
+	sdr->readersSemaphore = SM_SEM_NONE;
+	sdr->updateTurnstile = SM_SEM_NONE;
+}
+
+static int	clearStaleReaders(SdrState *sdr)
+{
+	int		i;
+	SdrReader	*reader;
+	int		readerCount;
+
+	/*	A reader that was killed in mid-transaction leaves
+	 *	its slot occupied.  Returns the number of readers
+	 *	that are still active; if there are none, the SDR
+	 *	semaphore must be unwedged in case the dead readers
+	 *	were holding it.					*/
+
+	if (sdr->readersSemaphore == SM_SEM_NONE)
+	{
+		return 0;	/*	Shared reads not configured.	*/
+	}
+
+	sm_SemUnwedge(sdr->readersSemaphore, 3);
+	sm_SemUnwedge(sdr->updateTurnstile, 3);
+	if (sm_SemTake(sdr->readersSemaphore) < 0)
+	{
+		return 0;
+	}
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->depth > 0 && !sm_TaskExists(reader->task))
+		{
+			reader->depth = 0;
+			sdr->readerCount--;
+		}
+	}
+
+	readerCount = sdr->readerCount;
+	sm_SemGive(sdr->readersSemaphore);
+	return readerCount;
+}
+
+static int	findReader(SdrState *sdr)
+{
+	int		task = sm_TaskIdSelf();
+	pthread_t	thread = pthread_self();
+	int		i;
+	SdrReader	*reader;
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->depth > 0 && reader->task == task
+		&& pthread_equal(reader->thread, thread))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 static int	lockSdr(SdrState *sdr)
 {
-	if (sm_SemTake(sdr->sdrSemaphore) < 0)
+	if (sdr->updateTurnstile != SM_SEM_NONE)
 	{
-		return -1;
+		/*	Holding the turnstile while waiting for the
+		 *	SDR keeps new readers from starting, so that
+		 *	a steady stream of overlapping read-only
+		 *	transactions can't lock out updates.		*/
+
+		if (sm_SemTake(sdr->updateTurnstile) < 0)
+		{
+			return -1;
+		}
+
+		if (sm_SemTake(sdr->sdrSemaphore) < 0)
+		{
+			sm_SemGive(sdr->updateTurnstile);
+			return -1;
+		}
+
+		sm_SemGive(sdr->updateTurnstile);
+	}
+	else
+	{
+		if (sm_SemTake(sdr->sdrSemaphore) < 0)
+		{
+			return -1;
+		}
 	}
 
 	sdr->sdrOwnerThread = pthread_self();
@@ -422,9 +554,121 @@ int	takeSdr(SdrState *sdr)
 		return 0;		/*	Already taken.		*/
 	}
 
+	if (sdr->readersSemaphore != SM_SEM_NONE && findReader(sdr) >= 0)
+	{
+		/*	Would wait forever for our own read lock.	*/
+
+		putErrmsg("Can't start update within read-only transaction.",
+				NULL);
+		return -1;
+	}
+
 	return lockSdr(sdr);
 }
 
+static int	takeSdrForReading(SdrState *sdr)
+{
+	int	slot;
+	int	i;
+
+	if (sdr->sdrSemaphore == SM_SEM_NONE || sm_SemEnded(sdr->sdrSemaphore)
+	|| sm_SemTake(sdr->readersSemaphore) < 0)
+	{
+		return -1;		/*	Can't be taken.		*/
+	}
+
+	slot = findReader(sdr);
+	if (slot >= 0)
+	{
+		sdr->readers[slot].depth++;
+		sm_SemGive(sdr->readersSemaphore);
+		return 0;		/*	Already reading.	*/
+	}
+
+	sm_SemGive(sdr->readersSemaphore);
+
+	/*	Wait behind any update that is waiting for the SDR.	*/
+
+	if (sm_SemTake(sdr->updateTurnstile) < 0)
+	{
+		return -1;
+	}
+
+	sm_SemGive(sdr->updateTurnstile);
+	if (sm_SemTake(sdr->readersSemaphore) < 0)
+	{
+		return -1;
+	}
+
+	for (i = 0, slot = -1; i < SDR_MAX_READERS; i++)
+	{
+		if (sdr->readers[i].depth == 0)
+		{
+			slot = i;
+			break;
+		}
+	}
+
+	if (slot < 0)
+	{
+		/*	Too many concurrent readers; just take the
+		 *	SDR exclusively instead.			*/
+
+		sm_SemGive(sdr->readersSemaphore);
+		return takeSdr(sdr);
+	}
+
+	/*	The first reader locks the SDR on behalf of all
+	 *	readers; the last reader out will unlock it.		*/
+
+	if (sdr->readerCount == 0)
+	{
+		if (sm_SemTake(sdr->sdrSemaphore) < 0)
+		{
+			sm_SemGive(sdr->readersSemaphore);
+			return -1;
+		}
+	}
+
+	sdr->readerCount++;
+	sdr->readers[slot].task = sm_TaskIdSelf();
+	sdr->readers[slot].thread = pthread_self();
+	sdr->readers[slot].depth = 1;
+	sm_SemGive(sdr->readersSemaphore);
+	return 0;
+}
+
+static int	releaseSdrForReading(SdrState *sdr)
+{
+	int	slot;
+
+	if (sdr->readersSemaphore == SM_SEM_NONE
+	|| sm_SemTake(sdr->readersSemaphore) < 0)
+	{
+		return 0;
+	}
+
+	slot = findReader(sdr);
+	if (slot < 0)
+	{
+		sm_SemGive(sdr->readersSemaphore);
+		return 0;		/*	Not a reader.		*/
+	}
+
+	sdr->readers[slot].depth--;
+	if (sdr->readers[slot].depth == 0)
+	{
+		sdr->readerCount--;
+		if (sdr->readerCount == 0)
+		{
+			sm_SemGive(sdr->sdrSemaphore);
+		}
+	}
+
+	sm_SemGive(sdr->readersSemaphore);
+	return 1;
+}
+
 static void	unlockSdr(SdrState *sdr)
 {
 	sdr->sdrOwnerTask = -1;
@@ -729,10 +973,185 @@ static void	clearTransaction(Sdr sdrv)
 		lyst_clear(sdrv->knownObjects);
 	}
 
+	if (sdrv->dirtyExtents)
+	{
+		lyst_clear(sdrv->dirtyExtents);
+	}
+
 	sdrv->sdr->logLength = 0;
 	sm_list_clear(_sdrwm(NULL), sdrv->sdr->logEntries, NULL, NULL);
 }
 
+static int	noteDirtyExtent(Sdr sdrv, Address from, Address to)
+{
+	LystElt		elt;
+	DirtyExtent	*extent;
+
+	/*	Successive writes very often extend or overlap the
+	 *	range written just before, so try to fold the new
+	 *	range into the most recently noted one.			*/
+
+	elt = lyst_last(sdrv->dirtyExtents);
+	if (elt)
+	{
+		extent = (DirtyExtent *) lyst_data(elt);
+		if (from <= extent->to && to >= extent->from)
+		{
+			if (from < extent->from)
+			{
+				extent->from = from;
+			}
+
+			if (to > extent->to)
+			{
+				extent->to = to;
+			}
+
+			return 0;
+		}
+	}
+
+	extent = (DirtyExtent *) MTAKE(sizeof(DirtyExtent));
+	if (extent == NULL)
+	{
+		return -1;
+	}
+
+	extent->from = from;
+	extent->to = to;
+	if (lyst_insert_last(sdrv->dirtyExtents, extent) == NULL)
+	{
+		MRELEASE(extent);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	compareDirtyExtents(const void *a, const void *b)
+{
+	Address	fromA = ((DirtyExtent *) a)->from;
+	Address	fromB = ((DirtyExtent *) b)->from;
+
+	if (fromA < fromB)
+	{
+		return -1;
+	}
+
+	return (fromA > fromB ? 1 : 0);
+}
+
+static int	writeDirtyRange(Sdr sdrv, Address from, Address to)
+{
+	size_t	length = to - from;
+#if SDR_CAN_MAP_FILE
+	static long	pageSize = 0;
+
+	if (sdrv->sdr->configFlags & SDR_MAP_FILE)
+	{
+		/*	The DRAM copy is the file; just make sure the
+		 *	modified pages get written back to it.		*/
+
+		if (pageSize == 0)
+		{
+			pageSize = sysconf(_SC_PAGESIZE);
+		}
+
+		from -= (from % pageSize);
+		length = to - from;
+		if (msync(sdrv->dssm + from, length, SDR_MSYNC_FLAGS) < 0)
+		{
+			putSysErrmsg("Can't sync dataspace", itoa(length));
+			return -1;
+		}
+
+		return 0;
+	}
+#endif
+	if (lseek(sdrv->dsfile, from, SEEK_SET) < 0
+	|| write(sdrv->dsfile, sdrv->dssm + from, length) < length)
+	{
+		putSysErrmsg("Can't write to dataspace", itoa(length));
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	flushDirtyExtents(Sdr sdrv)
+{
+	int		count;
+	DirtyExtent	*extents;
+	DirtyExtent	*extent;
+	LystElt		elt;
+	int		i;
+	Address		from;
+	Address		to;
+
+	if (sdrv->dirtyExtents == NULL)
+	{
+		return 0;	/*	Writes are not deferred.	*/
+	}
+
+	count = lyst_length(sdrv->dirtyExtents);
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	if (count == 1)
+	{
+		extent = (DirtyExtent *)
+				lyst_data(lyst_first(sdrv->dirtyExtents));
+		return writeDirtyRange(sdrv, extent->from, extent->to);
+	}
+
+	/*	Sort the noted ranges by dataspace offset, then write
+	 *	each run of overlapping or nearly adjacent ranges to
+	 *	the file from the DRAM copy of the dataspace.		*/
+
+	extents = (DirtyExtent *) MTAKE(count * sizeof(DirtyExtent));
+	if (extents == NULL)
+	{
+		putErrmsg(_noMemoryMsg(), itoa(count));
+		return -1;
+	}
+
+	for (i = 0, elt = lyst_first(sdrv->dirtyExtents); elt;
+			i++, elt = lyst_next(elt))
+	{
+		extents[i] = *((DirtyExtent *) lyst_data(elt));
+	}
+
+	qsort(extents, count, sizeof(DirtyExtent), compareDirtyExtents);
+	from = extents[0].from;
+	to = extents[0].to;
+	for (i = 1; i < count; i++)
+	{
+		if (extents[i].from <= to + SDR_WRITE_COALESCE_GAP)
+		{
+			if (extents[i].to > to)
+			{
+				to = extents[i].to;
+			}
+
+			continue;
+		}
+
+		if (writeDirtyRange(sdrv, from, to) < 0)
+		{
+			MRELEASE(extents);
+			return -1;
+		}
+
+		from = extents[i].from;
+		to = extents[i].to;
+	}
+
+	MRELEASE(extents);
+	return writeDirtyRange(sdrv, from, to);
+}
+
 static void	handleUnrecoverableError(Sdr sdrv)
 {
 	putErrmsg("Unrecoverable SDR error.", NULL);
@@ -1023,6 +1442,7 @@ static int	createDsFile(SdrState *sdr, char *dsfilename)
 	}
 
 	MRELEASE(buffer);
+	memset((char *) &map, 0, sizeof map);	/*	Clear padding.	*/
 	initSdrMap(&map, sdr);
 	if (lseek(dsfile, 0, SEEK_SET) < 0
 	|| write(dsfile, (char *) &map, sizeof map) < sizeof map
@@ -1036,6 +1456,51 @@ static int	createDsFile(SdrState *sdr, char *dsfilename)
 	return dsfile;
 }
 
+static char	*mapDsFile(SdrState *sdr, int dsfile)
+{
+#if SDR_CAN_MAP_FILE
+	struct stat	statbuf;
+	char		*dssm;
+
+	/*	Make sure the file spans the entire dataspace, as
+	 *	access to a mapped page beyond end of file would
+	 *	raise SIGBUS.						*/
+
+	if (fstat(dsfile, &statbuf) < 0)
+	{
+		putSysErrmsg("Can't stat dataspace file", NULL);
+		return NULL;
+	}
+
+	if (statbuf.st_size < sdr->dsSize
+	&& ftruncate(dsfile, sdr->dsSize) < 0)
+	{
+		putSysErrmsg("Can't extend dataspace file", utoa(sdr->dsSize));
+		return NULL;
+	}
+
+	dssm = (char *) mmap(NULL, sdr->dsSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED, dsfile, 0);
+	if (dssm == (char *) MAP_FAILED)
+	{
+		putSysErrmsg("Can't map dataspace file", utoa(sdr->dsSize));
+		return NULL;
+	}
+
+	return dssm;
+#else
+	putErrmsg("Can't map dataspace file on this platform.", NULL);
+	return NULL;
+#endif
+}
+
+static void	unmapDsFile(SdrState *sdr, char *dssm)
+{
+#if SDR_CAN_MAP_FILE
+	oK(munmap(dssm, sdr->dsSize));
+#endif
+}
+
 static int	restageDsFromFile(SdrState *sdr, int dsfile, char *dssm)
 {
 	size_t	bytesRemaining = sdr->dsSize;
@@ -1084,6 +1549,8 @@ static void	destroySdr(SdrState *sdr)
 		sm_SemDelete(sdr->sdrSemaphore);
 	}
 
+	endSharedReads(sdr);
+
 	/*	Destroy file copy of dataspace if any.			*/
 
 	if (sdr->configFlags & SDR_IN_FILE)
@@ -1095,7 +1562,8 @@ static void	destroySdr(SdrState *sdr)
 
 	/*	Destroy memory copy of dataspace if any.		*/
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if ((sdr->configFlags & SDR_IN_DRAM)
+	&& !(sdr->configFlags & SDR_MAP_FILE))
 	{
 		switch (sm_ShmAttach(sdr->dsKey, sdr->dsSize, &dssm, &dssmId))
 		{
@@ -1184,6 +1652,29 @@ int	sdr_load_profile(char *name, int configFlags, size_t heapWords,
 				itoa(configFlags));
 		return -1;
 	}
+	if ((configFlags & SDR_DEFER_WRITES)
+	&& !((configFlags & SDR_IN_DRAM) && (configFlags & SDR_IN_FILE)))
+	{
+		putErrmsg("SDR_DEFER_WRITES requires both SDR_IN_DRAM and \
+SDR_IN_FILE.", itoa(configFlags));
+		return -1;
+	}
+
+	if ((configFlags & SDR_MAP_FILE)
+	&& !((configFlags & SDR_IN_DRAM) && (configFlags & SDR_IN_FILE)))
+	{
+		putErrmsg("SDR_MAP_FILE requires both SDR_IN_DRAM and \
+SDR_IN_FILE.", itoa(configFlags));
+		return -1;
+	}
+
+	if ((configFlags & SDR_SHARED_READS) && !(configFlags & SDR_IN_DRAM))
+	{
+		putErrmsg("SDR_SHARED_READS requires SDR_IN_DRAM.",
+				itoa(configFlags));
+		return -1;
+	}
+
 #if (HEAP_PTRS)
 	if (!(configFlags & SDR_IN_DRAM))
 	{
@@ -1219,7 +1710,11 @@ SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
 			&& (sdr->logKey == logKey || logKey == SM_NO_KEY)
 			&& strcmp(sdr->pathName, pathName) == 0)
 			{
-				sm_SemUnwedge(sdr->sdrSemaphore, 3);
+				if (clearStaleReaders(sdr) == 0)
+				{
+					sm_SemUnwedge(sdr->sdrSemaphore, 3);
+				}
+
 				return 0;	/*	Profile loaded.	*/
 			}
 
@@ -1267,6 +1762,21 @@ SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
 		return -1;
 	}
 
+	sdr->readersSemaphore = SM_SEM_NONE;
+	sdr->updateTurnstile = SM_SEM_NONE;
+	if (configFlags & SDR_SHARED_READS)
+	{
+		sdr->readersSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		sdr->updateTurnstile = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		if (sdr->readersSemaphore == SM_SEM_NONE
+		|| sdr->updateTurnstile == SM_SEM_NONE)
+		{
+			putErrmsg("Can't create read semaphores for SDR.", NULL);
+			destroySdr(sdr);	/*	Releases lock.	*/
+			return -1;
+		}
+	}
+
 	sdr->sdrOwnerTask = -1;
 	sdr->logEntries = sm_list_create(sdrwm);
 	if (sdr->logEntries == 0)
@@ -1287,6 +1797,8 @@ SDR heap data, the heap MUST be resident in memory.", itoa(configFlags));
 in file and transaction reversibility", sdr->pathName);
 		sdr->configFlags &= (~SDR_IN_FILE);
 		sdr->configFlags &= (~SDR_REVERSIBLE);
+		sdr->configFlags &= (~SDR_DEFER_WRITES);
+		sdr->configFlags &= (~SDR_MAP_FILE);
 	}
 
 	if (restartCmd == NULL)
@@ -1383,7 +1895,27 @@ in file and transaction reversibility", sdr->pathName);
 		}
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (sdr->configFlags & SDR_MAP_FILE)
+	{
+		/*	The file, already recovered, is the DRAM copy
+		 *	of the dataspace; nothing to restage.  Just
+		 *	make sure that it can be mapped.		*/
+
+		dssm = mapDsFile(sdr, dsfile);
+		if (dssm == NULL)
+		{
+			close(dsfile);
+			if (logfile != -1) close(logfile);
+			if (logsm) sm_ShmDetach(logsm);
+			putErrmsg("Can't map dataspace file.", NULL);
+			destroySdr(sdr);	/*	Releases lock.	*/
+			return -1;
+		}
+
+		unmapDsFile(sdr, dssm);
+		dssm = NULL;
+	}
+	else if (sdr->configFlags & SDR_IN_DRAM)
 	{
 		dssm = NULL;
 		switch (sm_ShmAttach(sdr->dsKey, sdr->dsSize, &dssm, &dssmId))
@@ -1523,6 +2055,7 @@ int	sdr_reload_profile(char *name, int configFlags, size_t heapWords,
 		sm_SemEnd(sdr->sdrSemaphore);
 		microsnooze(50000);
 		sm_SemDelete(sdr->sdrSemaphore);
+		endSharedReads(sdr);
 		psm_free(sdrwm, sdrAddress);
 		oK(sm_list_delete(sdrwm, elt, NULL, NULL));
 	}
@@ -1608,7 +2141,22 @@ Sdr	Sdr_start_using(char *name)
 		sdrv->dsfile = -1;
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (sdr->configFlags & SDR_MAP_FILE)
+	{
+		sdrv->dssm = mapDsFile(sdr, sdrv->dsfile);
+		if (sdrv->dssm == NULL)
+		{
+			sm_SemGive(lock);
+			putErrmsg("Can't map dataspace file.", dsfilename);
+			return NULL;
+		}
+
+		/*	All access is now through the mapping.		*/
+
+		close(sdrv->dsfile);
+		sdrv->dsfile = -1;
+	}
+	else if (sdr->configFlags & SDR_IN_DRAM)
 	{
 		sdrv->dssm = NULL;
 		if (sm_ShmAttach(sdr->dsKey, sdr->dsSize, &(sdrv->dssm),
@@ -1670,6 +2218,19 @@ Sdr	Sdr_start_using(char *name)
 		lyst_delete_set(sdrv->knownObjects, deleteObjectExtent, NULL);
 	}
 
+	if (sdr->configFlags & (SDR_DEFER_WRITES | SDR_MAP_FILE))
+	{
+		sdrv->dirtyExtents = lyst_create_using(_sdrMemory(NULL));
+		if (sdrv->dirtyExtents == 0)
+		{
+			sm_SemGive(lock);
+			putErrmsg(_noMemoryMsg(), NULL);
+			return NULL;
+		}
+
+		lyst_delete_set(sdrv->dirtyExtents, deleteObjectExtent, NULL);
+	}
+
 	sdrv->trace = NULL;
 	sdrv->currentSourceFileName = NULL;
 	sdrv->currentSourceFileLine = 0;
@@ -1713,7 +2274,14 @@ void	sdr_stop_using(Sdr sdrv)
 
 	if (sdrv->dssm)
 	{
-		sm_ShmDetach(sdrv->dssm);
+		if (sdrv->sdr->configFlags & SDR_MAP_FILE)
+		{
+			unmapDsFile(sdrv->sdr, sdrv->dssm);
+		}
+		else
+		{
+			sm_ShmDetach(sdrv->dssm);
+		}
 	}
 
 	if (sdrv->logfile != -1)
@@ -1731,6 +2299,11 @@ void	sdr_stop_using(Sdr sdrv)
 		lyst_destroy(sdrv->knownObjects);
 	}
 
+	if (sdrv->dirtyExtents)
+	{
+		lyst_destroy(sdrv->dirtyExtents);
+	}
+
 	/*	Erase content of SdrView, in case space is re-used
 	 *	for another SdrView; then delete it.			*/
 
@@ -1745,6 +2318,7 @@ void	sdr_abort(Sdr sdrv)
 	microsnooze(50000);
 	sm_SemDelete(sdrv->sdr->sdrSemaphore);
 	sdrv->sdr->sdrSemaphore = -1;
+	endSharedReads(sdrv->sdr);
 	sdr_shutdown();
 }
 
@@ -1772,6 +2346,7 @@ void	sdr_destroy(Sdr sdrv)
 	microsnooze(50000);
 	sm_SemDelete(sdr->sdrSemaphore);
 	sdr->sdrSemaphore = SM_SEM_NONE;
+	endSharedReads(sdr);
 	sdr_stop_using(sdrv);
 
 	/*	Now destroy the SDR itself.				*/
@@ -1795,7 +2370,34 @@ int	sdr_begin_xn(Sdr sdrv)
 		return 0;	/*	Failed to begin transaction.	*/
 	}
 
-	sdrv->modified = 0;
+	/*	A nested transaction must not forget that the
+	 *	enclosing transaction has already modified data.	*/
+
+	if (sdrv->sdr->xnDepth == 1)
+	{
+		sdrv->modified = 0;
+	}
+
+	return 1;		/*	Began transaction.		*/
+}
+
+int	sdr_begin_read_xn(Sdr sdrv)
+{
+	CHKZERO(sdrv);
+	if (sdrv->sdr->readersSemaphore == SM_SEM_NONE || sdr_in_xn(sdrv))
+	{
+		/*	Shared reads aren't configured, or this is
+		 *	nested in an update transaction: the read is
+		 *	simply part of an ordinary transaction.		*/
+
+		return sdr_begin_xn(sdrv);
+	}
+
+	if (takeSdrForReading(sdrv->sdr) < 0)
+	{
+		return 0;	/*	Failed to begin transaction.	*/
+	}
+
 	return 1;		/*	Began transaction.		*/
 }
 
@@ -1815,7 +2417,9 @@ int	sdr_heap_is_halted(Sdr sdrv)
 
 int	sdrFetchSafe(Sdr sdrv)
 {
-	return (sdr_in_xn(sdrv) || sdr_heap_is_halted(sdrv));
+	return (sdr_in_xn(sdrv) || sdr_heap_is_halted(sdrv)
+		|| (sdrv->sdr->readersSemaphore != SM_SEM_NONE
+			&& findReader(sdrv->sdr) >= 0));
 }
 
 void	sdr_exit_xn(Sdr sdrv)
@@ -1844,6 +2448,10 @@ void	sdr_exit_xn(Sdr sdrv)
 			unlockSdr(sdr);
 		}
 	}
+	else
+	{
+		oK(releaseSdrForReading(sdr));
+	}
 }
 
 void	sdr_cancel_xn(Sdr sdrv)
@@ -1861,6 +2469,10 @@ void	sdr_cancel_xn(Sdr sdrv)
 			terminateXn(sdrv);
 		}
 	}
+	else
+	{
+		oK(releaseSdrForReading(sdr));
+	}
 }
 
 int	sdr_end_xn(Sdr sdrv)
@@ -1874,12 +2486,30 @@ int	sdr_end_xn(Sdr sdrv)
 		sdr->xnDepth--;
 		if (sdr->xnDepth == 0)
 		{
+			if (sdr->xnCanceled == 0
+			&& flushDirtyExtents(sdrv) < 0)
+			{
+				/*	File copy of dataspace may now
+				 *	be partly updated; reverse the
+				 *	transaction to restore it.	*/
+
+				putErrmsg("Can't flush transaction.", NULL);
+				sdr->xnCanceled = 1;
+				terminateXn(sdrv);
+				return -1;
+			}
+
 			terminateXn(sdrv);
 		}
 
 		return 0;
 	}
 
+	if (releaseSdrForReading(sdr))
+	{
+		return 0;	/*	Ended a read-only transaction.	*/
+	}
+
 	return -1;
 }
 
@@ -2098,7 +2728,19 @@ entry.", NULL);
 		}
 	}
 
-	if (sdr->configFlags & SDR_IN_FILE)
+	if (sdrv->dirtyExtents)
+	{
+		/*	File is updated from DRAM at end of xn.		*/
+
+		if (noteDirtyExtent(sdrv, into, to) < 0)
+		{
+			_putErrmsg(file, line, "Can't note dirty extent.",
+					itoa(length));
+			crashXn(sdrv);
+			return;
+		}
+	}
+	else if (sdr->configFlags & SDR_IN_FILE)
 	{
 		if (lseek(sdrv->dsfile, into, SEEK_SET) < 0
 		|| write(sdrv->dsfile, from, length) < length)
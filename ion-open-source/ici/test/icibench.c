@@ -0,0 +1,1578 @@
+/*
+	icibench.c:	micro-benchmarks for the ICI core primitives:
+			PSM allocation, shared-memory lists and
+			red-black trees, SDR transactions, SDR heap
+			allocation, SDR lists and hash tables, and
+			zero-copy objects.
+
+	Each primitive is run "ops" times by each of "procs"
+	concurrent worker processes; every individual operation
+	is timed, and for each primitive a single line of results
+	is printed: aggregate throughput in operations per second
+	and the 50th, 90th, and 99th percentile and maximum
+	latencies in nanoseconds.  Results may be printed as a
+	table (the default), as CSV, or as JSON lines.
+
+									*/
+/*									*/
+/*	Copyright (c) 2026, California Institute of Technology.		*/
+/*	All rights reserved.						*/
+/*									*/
+
+#include "platform.h"
+#include "psm.h"
+#include "smlist.h"
+#include "smrbt.h"
+#include "sdr.h"
+#include "sdrhash.h"
+#include "zco.h"
+
+#define	BENCH_SDR_NAME		"icibench"
+#define	BENCH_SDR_WM_SIZE	(4000000)
+#define	BENCH_DEFAULT_OPS	(10000)
+#define	BENCH_DEFAULT_SIZE	(64)
+#define	BENCH_DEFAULT_FLAGS	(SDR_IN_DRAM)
+#define	BENCH_MAX_PROCS		(64)
+#define	BENCH_MAX_PRIMS		(32)
+#define	BENCH_MAX_REGION	(1 << 30)
+#define	BENCH_NODE_OVERHEAD	(128)
+#define	BENCH_XN_BATCH		(64)
+#define	BENCH_HASH_KEYLEN	(2 * sizeof(unsigned int))
+
+#ifndef BENCH_PATH_NAME
+#ifdef mingw
+#define	BENCH_PATH_NAME		"."
+#else
+#define	BENCH_PATH_NAME		"/tmp"
+#endif
+#endif
+
+/*	SDR usage classes of benchmarked primitives.			*/
+
+#define	BENCH_NO_SDR		(0)
+#define	BENCH_SDR_XN		(1)	/*	Setup in xn only.	*/
+#define	BENCH_SDR_BATCH		(2)	/*	Timed ops in xn, too.	*/
+
+typedef enum
+{
+	BenchTable = 0,
+	BenchCsv,
+	BenchJson
+} BenchFormat;
+
+typedef struct
+{
+	char		*programName;
+	int		ops;
+	int		size;
+	int		procs;
+	int		configFlags;
+	char		*pathName;
+	BenchFormat	format;
+	int		selCount;
+	char		**selections;
+} BenchParms;
+
+/*	Shared results board, followed in the results region by the
+ *	array of per-worker spans and then the array of latencies.
+ *	Worker processes learn all run parameters from the board.	*/
+
+typedef struct
+{
+	int		ops;
+	int		size;
+	int		procs;
+	unsigned int	selections;	/*	Bit mask of primitives.	*/
+	int		wmKey;
+	vast		wmSize;
+	sm_SemId	lock;
+	Object		hash;
+	int		aborted;	/*	Boolean.		*/
+	int		done[BENCH_MAX_PROCS];
+	int		arrivals[BENCH_MAX_PRIMS];
+} BenchBoard;
+
+typedef struct
+{
+	uvast		start;
+	uvast		end;
+	int		opsDone;
+	int		failed;
+} BenchSpan;
+
+typedef struct
+{
+	/*	Run parameters, common to all workers.			*/
+
+	int		ops;
+	int		size;
+	int		procs;
+	PsmPartition	wm;
+	sm_SemId	lock;
+	Sdr		sdr;
+	Object		hash;
+	BenchBoard	*board;
+	BenchSpan	*spans;
+	unsigned int	*latencies;
+
+	/*	Per-worker state.					*/
+
+	int		workerNbr;
+	PsmAddress	smList;
+	PsmAddress	rbt;
+	Object		sdrList;
+	Object		sdrObj;
+	PsmAddress	*addrs;
+	Object		*objs;
+	Object		*zcos;
+	unsigned int	*keys;
+	char		*buffer;
+} Bench;
+
+typedef struct
+{
+	char		*name;
+	int		sdrUsage;
+	int		(*setup)(Bench *);
+	int		(*op)(Bench *, int);
+	void		(*teardown)(Bench *);
+} BenchPrimitive;
+
+static uvast	nowNsec()
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec	ts;
+
+	oK(clock_gettime(CLOCK_MONOTONIC, &ts));
+	return (((uvast) ts.tv_sec) * 1000000000) + ts.tv_nsec;
+#else
+	struct timeval	tv;
+
+	getCurrentTime(&tv);
+	return (((uvast) tv.tv_sec) * 1000000000)
+			+ (((uvast) tv.tv_usec) * 1000);
+#endif
+}
+
+/*	*	*	PSM and shared-memory structures	*	*	*/
+
+static int	compareKeys(PsmPartition partition, PsmAddress nodeData,
+			void *dataBuffer)
+{
+	unsigned int	key = (unsigned int) nodeData;
+	unsigned int	argKey = *((unsigned int *) dataBuffer);
+
+	if (key < argKey)
+	{
+		return -1;
+	}
+
+	return (key > argKey);
+}
+
+static void	freeAddrs(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		if (b->addrs[i])
+		{
+			psm_free(b->wm, b->addrs[i]);
+			b->addrs[i] = 0;
+		}
+	}
+}
+
+static int	mallocAddrs(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		b->addrs[i] = psm_malloc(b->wm, b->size);
+		if (b->addrs[i] == 0)
+		{
+			putErrmsg("PSM partition is full.", itoa(i));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int	clearAddrs(Bench *b)
+{
+	memset((char *) b->addrs, 0, b->ops * sizeof(PsmAddress));
+	return 0;
+}
+
+static int	opPsmMalloc(Bench *b, int i)
+{
+	b->addrs[i] = psm_malloc(b->wm, b->size);
+	return (b->addrs[i] == 0 ? -1 : 0);
+}
+
+static int	opPsmFree(Bench *b, int i)
+{
+	psm_free(b->wm, b->addrs[i]);
+	b->addrs[i] = 0;
+	return 0;
+}
+
+static int	createSmList(Bench *b)
+{
+	b->smList = sm_list_create(b->wm);
+	return (b->smList == 0 ? -1 : 0);
+}
+
+static int	fillSmList(Bench *b)
+{
+	int	i;
+
+	CHKERR(createSmList(b) == 0);
+	for (i = 0; i < b->ops; i++)
+	{
+		b->addrs[i] = sm_list_insert_last(b->wm, b->smList, i + 1);
+		CHKERR(b->addrs[i]);
+	}
+
+	return 0;
+}
+
+static void	destroySmList(Bench *b)
+{
+	if (b->smList)
+	{
+		sm_list_destroy(b->wm, b->smList, NULL, NULL);
+		b->smList = 0;
+	}
+
+	clearAddrs(b);
+}
+
+static int	opSmListInsert(Bench *b, int i)
+{
+	b->addrs[i] = sm_list_insert_last(b->wm, b->smList, i + 1);
+	return (b->addrs[i] == 0 ? -1 : 0);
+}
+
+static int	opSmListDelete(Bench *b, int i)
+{
+	sm_list_delete(b->wm, b->addrs[i], NULL, NULL);
+	b->addrs[i] = 0;
+	return 0;
+}
+
+static int	createRbt(Bench *b)
+{
+	b->rbt = sm_rbt_create(b->wm);
+	return (b->rbt == 0 ? -1 : 0);
+}
+
+static int	fillRbt(Bench *b)
+{
+	int	i;
+
+	CHKERR(createRbt(b) == 0);
+	for (i = 0; i < b->ops; i++)
+	{
+		CHKERR(sm_rbt_insert(b->wm, b->rbt, b->keys[i], compareKeys,
+				&(b->keys[i])));
+	}
+
+	return 0;
+}
+
+static void	destroyRbt(Bench *b)
+{
+	if (b->rbt)
+	{
+		sm_rbt_destroy(b->wm, b->rbt, NULL, NULL);
+		b->rbt = 0;
+	}
+}
+
+static int	opRbtInsert(Bench *b, int i)
+{
+	return (sm_rbt_insert(b->wm, b->rbt, b->keys[i], compareKeys,
+			&(b->keys[i])) == 0 ? -1 : 0);
+}
+
+static int	opRbtSearch(Bench *b, int i)
+{
+	return (sm_rbt_search(b->wm, b->rbt, compareKeys, &(b->keys[i]),
+			NULL) == 0 ? -1 : 0);
+}
+
+static int	opRbtDelete(Bench *b, int i)
+{
+	sm_rbt_delete(b->wm, b->rbt, compareKeys, &(b->keys[i]), NULL, NULL);
+	return 0;
+}
+
+/*	*	*	SDR transactions, heap, lists, hashes	*	*	*/
+
+static int	noSetup(Bench *b)
+{
+	return 0;
+}
+
+static void	noTeardown(Bench *b)
+{
+	return;
+}
+
+static int	renewXn(Bench *b, int i)
+{
+	/*	Untimed setup and teardown of SDR primitives is done
+	 *	in transactions of limited size, so that the log of
+	 *	a reversible SDR doesn't overflow working memory.	*/
+
+	if (i > 0 && (i % BENCH_XN_BATCH) == 0)
+	{
+		if (sdr_end_xn(b->sdr) < 0)
+		{
+			putErrmsg("Benchmark setup transaction failed.", NULL);
+			return -1;
+		}
+
+		CHKERR(sdr_begin_xn(b->sdr));
+	}
+
+	return 0;
+}
+
+static int	opXn(Bench *b, int i)
+{
+	CHKERR(sdr_begin_xn(b->sdr));
+	return sdr_end_xn(b->sdr);
+}
+
+static int	mallocObj(Bench *b)
+{
+	b->sdrObj = sdr_malloc(b->sdr, b->size);
+	return (b->sdrObj == 0 ? -1 : 0);
+}
+
+static void	freeObj(Bench *b)
+{
+	if (b->sdrObj)
+	{
+		sdr_free(b->sdr, b->sdrObj);
+		b->sdrObj = 0;
+	}
+}
+
+static int	opWriteXn(Bench *b, int i)
+{
+	CHKERR(sdr_begin_xn(b->sdr));
+	b->buffer[0] = (char) i;
+	sdr_stage(b->sdr, NULL, b->sdrObj, 0);
+	sdr_write(b->sdr, b->sdrObj, b->buffer, b->size);
+	return sdr_end_xn(b->sdr);
+}
+
+static int	clearObjs(Bench *b)
+{
+	memset((char *) b->objs, 0, b->ops * sizeof(Object));
+	return 0;
+}
+
+static int	mallocObjs(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		CHKERR(renewXn(b, i) == 0);
+		b->objs[i] = sdr_malloc(b->sdr, b->size);
+		if (b->objs[i] == 0)
+		{
+			putErrmsg("SDR heap is full.", itoa(i));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void	freeObjs(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		if (renewXn(b, i) < 0)
+		{
+			return;
+		}
+
+		if (b->objs[i])
+		{
+			sdr_free(b->sdr, b->objs[i]);
+			b->objs[i] = 0;
+		}
+	}
+}
+
+static int	opSdrMalloc(Bench *b, int i)
+{
+	b->objs[i] = sdr_malloc(b->sdr, b->size);
+	return (b->objs[i] == 0 ? -1 : 0);
+}
+
+static int	opSdrFree(Bench *b, int i)
+{
+	sdr_free(b->sdr, b->objs[i]);
+	b->objs[i] = 0;
+	return 0;
+}
+
+static int	createSdrList(Bench *b)
+{
+	b->sdrList = sdr_list_create(b->sdr);
+	return (b->sdrList == 0 ? -1 : 0);
+}
+
+static int	fillSdrList(Bench *b)
+{
+	int	i;
+
+	CHKERR(createSdrList(b) == 0);
+	for (i = 0; i < b->ops; i++)
+	{
+		CHKERR(renewXn(b, i) == 0);
+		b->objs[i] = sdr_list_insert_last(b->sdr, b->sdrList, i + 1);
+		CHKERR(b->objs[i]);
+	}
+
+	return 0;
+}
+
+static void	destroySdrList(Bench *b)
+{
+	Object	elt;
+	int	i = 0;
+
+	if (b->sdrList)
+	{
+		while ((elt = sdr_list_first(b->sdr, b->sdrList)) != 0)
+		{
+			sdr_list_delete(b->sdr, elt, NULL, NULL);
+			if (renewXn(b, ++i) < 0)
+			{
+				return;
+			}
+		}
+
+		sdr_list_destroy(b->sdr, b->sdrList, NULL, NULL);
+		b->sdrList = 0;
+	}
+
+	clearObjs(b);
+}
+
+static int	opSdrListInsert(Bench *b, int i)
+{
+	b->objs[i] = sdr_list_insert_last(b->sdr, b->sdrList, i + 1);
+	return (b->objs[i] == 0 ? -1 : 0);
+}
+
+static int	opSdrListDelete(Bench *b, int i)
+{
+	sdr_list_delete(b->sdr, b->objs[i], NULL, NULL);
+	b->objs[i] = 0;
+	return 0;
+}
+
+static void	makeHashKey(Bench *b, int i, char *key)
+{
+	unsigned int	words[2];
+
+	words[0] = b->workerNbr;
+	words[1] = b->keys[i];
+	memcpy(key, (char *) words, BENCH_HASH_KEYLEN);
+}
+
+static int	insertHashKey(Bench *b, int i)
+{
+	char	key[BENCH_HASH_KEYLEN];
+
+	makeHashKey(b, i, key);
+	b->objs[i] = 0;
+	CHKERR(sdr_hash_insert(b->sdr, b->hash, key, i + 1,
+			&(b->objs[i])) == 1);
+	return 0;
+}
+
+static int	fillHash(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		CHKERR(renewXn(b, i) == 0);
+		CHKERR(insertHashKey(b, i) == 0);
+	}
+
+	return 0;
+}
+
+static void	emptyHash(Bench *b)
+{
+	char	key[BENCH_HASH_KEYLEN];
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		if (renewXn(b, i) < 0)
+		{
+			return;
+		}
+
+		if (b->objs[i])
+		{
+			makeHashKey(b, i, key);
+			oK(sdr_hash_remove(b->sdr, b->hash, key, NULL));
+			b->objs[i] = 0;
+		}
+	}
+}
+
+static int	opHashInsert(Bench *b, int i)
+{
+	return insertHashKey(b, i);
+}
+
+static int	opHashRetrieve(Bench *b, int i)
+{
+	char	key[BENCH_HASH_KEYLEN];
+	Address	value;
+	Object	entry;
+
+	makeHashKey(b, i, key);
+	if (sdr_hash_retrieve(b->sdr, b->hash, key, &value, &entry) != 1)
+	{
+		return -1;
+	}
+
+	return (value == i + 1 ? 0 : -1);
+}
+
+static int	opHashRemove(Bench *b, int i)
+{
+	char	key[BENCH_HASH_KEYLEN];
+
+	makeHashKey(b, i, key);
+	CHKERR(sdr_hash_remove(b->sdr, b->hash, key, NULL) == 1);
+	b->objs[i] = 0;
+	return 0;
+}
+
+/*	*	*	Zero-copy objects	*	*	*	*	*/
+
+static int	createZco(Bench *b, int i)
+{
+	b->zcos[i] = zco_create(b->sdr, ZcoSdrSource, b->objs[i], 0,
+			b->size, ZcoOutbound);
+	switch (b->zcos[i])
+	{
+	case (Object) ERROR:
+	case 0:
+		b->zcos[i] = 0;
+		return -1;
+	}
+
+	b->objs[i] = 0;		/*	Now owned by the ZCO.		*/
+	return 0;
+}
+
+static int	clearZcos(Bench *b)
+{
+	memset((char *) b->zcos, 0, b->ops * sizeof(Object));
+	return mallocObjs(b);
+}
+
+static int	fillZcos(Bench *b)
+{
+	int	i;
+
+	CHKERR(clearZcos(b) == 0);
+	for (i = 0; i < b->ops; i++)
+	{
+		CHKERR(renewXn(b, i) == 0);
+		CHKERR(createZco(b, i) == 0);
+	}
+
+	return 0;
+}
+
+static void	destroyZcos(Bench *b)
+{
+	int	i;
+
+	for (i = 0; i < b->ops; i++)
+	{
+		if (renewXn(b, i) < 0)
+		{
+			return;
+		}
+
+		if (b->zcos[i])
+		{
+			zco_destroy(b->sdr, b->zcos[i]);
+			b->zcos[i] = 0;
+		}
+	}
+
+	freeObjs(b);
+}
+
+static int	opZcoCreate(Bench *b, int i)
+{
+	return createZco(b, i);
+}
+
+static int	opZcoTransmit(Bench *b, int i)
+{
+	ZcoReader	reader;
+
+	zco_start_transmitting(b->zcos[i], &reader);
+	return (zco_transmit(b->sdr, &reader, b->size, b->buffer) == b->size
+			? 0 : -1);
+}
+
+static int	opZcoDestroy(Bench *b, int i)
+{
+	zco_destroy(b->sdr, b->zcos[i]);
+	b->zcos[i] = 0;
+	return 0;
+}
+
+static BenchPrimitive	primitives[] =
+{
+	{ "psm_malloc", BENCH_NO_SDR,
+		clearAddrs, opPsmMalloc, freeAddrs },
+	{ "psm_free", BENCH_NO_SDR,
+		mallocAddrs, opPsmFree, freeAddrs },
+	{ "sm_list_insert", BENCH_NO_SDR,
+		createSmList, opSmListInsert, destroySmList },
+	{ "sm_list_delete", BENCH_NO_SDR,
+		fillSmList, opSmListDelete, destroySmList },
+	{ "sm_rbt_insert", BENCH_NO_SDR,
+		createRbt, opRbtInsert, destroyRbt },
+	{ "sm_rbt_search", BENCH_NO_SDR,
+		fillRbt, opRbtSearch, destroyRbt },
+	{ "sm_rbt_delete", BENCH_NO_SDR,
+		fillRbt, opRbtDelete, destroyRbt },
+	{ "sdr_xn", BENCH_SDR_XN,
+		noSetup, opXn, noTeardown },
+	{ "sdr_write_xn", BENCH_SDR_XN,
+		mallocObj, opWriteXn, freeObj },
+	{ "sdr_malloc", BENCH_SDR_BATCH,
+		clearObjs, opSdrMalloc, freeObjs },
+	{ "sdr_free", BENCH_SDR_BATCH,
+		mallocObjs, opSdrFree, freeObjs },
+	{ "sdr_list_insert", BENCH_SDR_BATCH,
+		createSdrList, opSdrListInsert, destroySdrList },
+	{ "sdr_list_delete", BENCH_SDR_BATCH,
+		fillSdrList, opSdrListDelete, destroySdrList },
+	{ "sdr_hash_insert", BENCH_SDR_BATCH,
+		clearObjs, opHashInsert, emptyHash },
+	{ "sdr_hash_retrieve", BENCH_SDR_BATCH,
+		fillHash, opHashRetrieve, emptyHash },
+	{ "sdr_hash_remove", BENCH_SDR_BATCH,
+		fillHash, opHashRemove, emptyHash },
+	{ "zco_create", BENCH_SDR_BATCH,
+		clearZcos, opZcoCreate, destroyZcos },
+	{ "zco_transmit", BENCH_SDR_BATCH,
+		fillZcos, opZcoTransmit, destroyZcos },
+	{ "zco_destroy", BENCH_SDR_BATCH,
+		fillZcos, opZcoDestroy, destroyZcos },
+	{ NULL, 0, NULL, NULL, NULL }
+};
+
+
+/*	*	*	Benchmark driver	*	*	*	*	*/
+
+static int	selectPrimitives(int selCount, char **selections,
+			unsigned int *mask)
+{
+	int	primNbr;
+	int	i;
+
+	*mask = 0;
+	for (primNbr = 0; primitives[primNbr].name; primNbr++)
+	{
+		if (selCount == 0)
+		{
+			*mask |= (1 << primNbr);
+			continue;
+		}
+
+		/*	A selection matches any primitive whose name
+		 *	it prefixes, e.g., "sdr_hash" selects all three
+		 *	SDR hash table primitives.			*/
+
+		for (i = 0; i < selCount; i++)
+		{
+			if (strncmp(primitives[primNbr].name, selections[i],
+					strlen(selections[i])) == 0)
+			{
+				*mask |= (1 << primNbr);
+				break;
+			}
+		}
+	}
+
+	return primNbr;		/*	Total number of primitives.	*/
+}
+
+static int	waitForPeers(Bench *b, int primNbr)
+{
+	int	arrivals;
+	int	aborted;
+
+	if (b->procs == 1)
+	{
+		return 0;
+	}
+
+	oK(sm_SemTake(b->lock));
+	b->board->arrivals[primNbr] += 1;
+	sm_SemGive(b->lock);
+	while (1)
+	{
+		oK(sm_SemTake(b->lock));
+		arrivals = b->board->arrivals[primNbr];
+		aborted = b->board->aborted;
+		sm_SemGive(b->lock);
+		if (aborted)
+		{
+			return -1;	/*	Some worker crashed.	*/
+		}
+
+		if (arrivals >= b->procs)
+		{
+			return 0;
+		}
+
+		microsnooze(100);
+	}
+}
+
+static int	beginSetup(Bench *b, BenchPrimitive *prim)
+{
+	if (prim->sdrUsage == BENCH_NO_SDR)
+	{
+		return 0;
+	}
+
+	CHKERR(sdr_begin_xn(b->sdr));
+	return 0;
+}
+
+static int	endSetup(Bench *b, BenchPrimitive *prim, int result)
+{
+	if (prim->sdrUsage == BENCH_NO_SDR)
+	{
+		return result;
+	}
+
+	if (result < 0)
+	{
+		sdr_cancel_xn(b->sdr);
+		return -1;
+	}
+
+	if (sdr_end_xn(b->sdr) < 0)
+	{
+		putErrmsg("Benchmark setup transaction failed.", prim->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	runOps(Bench *b, BenchPrimitive *prim, unsigned int *latencies,
+			BenchSpan *span)
+{
+	int	batched = (prim->sdrUsage == BENCH_SDR_BATCH);
+	uvast	opStart;
+	uvast	elapsed;
+	int	i;
+
+	span->start = nowNsec();
+	for (i = 0; i < b->ops; i++)
+	{
+		if (batched && (i % BENCH_XN_BATCH) == 0)
+		{
+			CHKERR(sdr_begin_xn(b->sdr));
+		}
+
+		opStart = nowNsec();
+		if (prim->op(b, i) < 0)
+		{
+			if (batched)
+			{
+				sdr_cancel_xn(b->sdr);
+			}
+
+			putErrmsg("Benchmark operation failed.", prim->name);
+			return -1;
+		}
+
+		elapsed = nowNsec() - opStart;
+		latencies[i] = (elapsed > (unsigned int) -1 ?
+				(unsigned int) -1 : elapsed);
+		span->opsDone++;
+		if (batched && ((i + 1) % BENCH_XN_BATCH == 0
+				|| i + 1 == b->ops))
+		{
+			if (sdr_end_xn(b->sdr) < 0)
+			{
+				putErrmsg("Benchmark transaction failed.",
+						prim->name);
+				return -1;
+			}
+		}
+	}
+
+	span->end = nowNsec();
+	return 0;
+}
+
+static int	runWorker(Bench *b)
+{
+	int		result = 0;
+	int		primNbr;
+	BenchPrimitive	*prim;
+	BenchSpan	*span;
+	unsigned int	*latencies;
+
+	for (primNbr = 0; primitives[primNbr].name; primNbr++)
+	{
+		if ((b->board->selections & (1 << primNbr)) == 0)
+		{
+			continue;
+		}
+
+		prim = primitives + primNbr;
+		span = b->spans + ((primNbr * b->procs) + b->workerNbr);
+		latencies = b->latencies + ((((uvast) primNbr * b->procs)
+				+ b->workerNbr) * b->ops);
+		if (endSetup(b, prim, beginSetup(b, prim) < 0 ? -1
+				: prim->setup(b)) < 0)
+		{
+			span->failed = 1;
+		}
+
+		if (waitForPeers(b, primNbr) < 0)
+		{
+			span->failed = 1;
+			result = -1;
+			break;
+		}
+
+		if (span->failed == 0 && runOps(b, prim, latencies, span) < 0)
+		{
+			span->failed = 1;
+		}
+
+		if (beginSetup(b, prim) == 0)
+		{
+			prim->teardown(b);
+			oK(endSetup(b, prim, 0));
+		}
+
+		if (span->failed)
+		{
+			writeErrmsgMemos();
+			result = -1;
+		}
+	}
+
+	return result;
+}
+
+static void	useBoard(Bench *b, char *results, int primCount)
+{
+	b->board = (BenchBoard *) results;
+	b->spans = (BenchSpan *) (results + sizeof(BenchBoard));
+	b->latencies = (unsigned int *) (b->spans + (primCount * b->procs));
+	b->ops = b->board->ops;
+	b->size = b->board->size;
+	b->procs = b->board->procs;
+	b->lock = b->board->lock;
+	b->hash = b->board->hash;
+}
+
+static int	initWorker(Bench *b)
+{
+	unsigned int	seed = b->workerNbr + 1;
+	unsigned int	tmp;
+	int		i;
+	int		j;
+
+	b->addrs = (PsmAddress *) malloc(b->ops * sizeof(PsmAddress));
+	b->objs = (Object *) malloc(b->ops * sizeof(Object));
+	b->zcos = (Object *) malloc(b->ops * sizeof(Object));
+	b->keys = (unsigned int *) malloc(b->ops * sizeof(unsigned int));
+	b->buffer = malloc(b->size);
+	if (b->addrs == NULL || b->objs == NULL || b->zcos == NULL
+	|| b->keys == NULL || b->buffer == NULL)
+	{
+		putErrmsg("Can't allocate benchmark work area.", NULL);
+		return -1;
+	}
+
+	memset((char *) b->addrs, 0, b->ops * sizeof(PsmAddress));
+	memset((char *) b->objs, 0, b->ops * sizeof(Object));
+	memset((char *) b->zcos, 0, b->ops * sizeof(Object));
+	memset(b->buffer, 'x', b->size);
+
+	/*	Red-black tree and hash table keys are distinct per
+	 *	worker and are used in shuffled order, so that the
+	 *	trees aren't built from monotonic insertions.		*/
+
+	for (i = 0; i < b->ops; i++)
+	{
+		b->keys[i] = (b->workerNbr * b->ops) + i + 1;
+	}
+
+	for (i = b->ops - 1; i > 0; i--)
+	{
+		seed = (seed * 1103515245) + 12345;
+		j = (seed >> 8) % (i + 1);
+		tmp = b->keys[i];
+		b->keys[i] = b->keys[j];
+		b->keys[j] = tmp;
+	}
+
+	return 0;
+}
+
+static void	endWorker(Bench *b)
+{
+	if (b->addrs) free(b->addrs);
+	if (b->objs) free(b->objs);
+	if (b->zcos) free(b->zcos);
+	if (b->keys) free(b->keys);
+	if (b->buffer) free(b->buffer);
+}
+
+#if !(defined (ION_LWT) || defined (mingw))
+static int	run_worker(int workerNbr, int resultsKey, vast resultsSize)
+{
+	Bench		bench;
+	Bench		*b = &bench;
+	char		*results = NULL;
+	uaddr		resultsId;
+	char		*wmSpace = NULL;
+	uaddr		wmId;
+	PsmMgtOutcome	outcome;
+	unsigned int	selections;
+	int		result = -1;
+
+	/*	Worker processes are spawned (rather than merely
+	 *	forked) so that each has its own ICI task identity,
+	 *	which SDR transaction ownership depends on.		*/
+
+	memset((char *) b, 0, sizeof(Bench));
+	b->workerNbr = workerNbr;
+	sm_ipc_init();
+	if (sm_ShmAttach(resultsKey, resultsSize, &results, &resultsId) < 0)
+	{
+		putErrmsg("Worker can't attach results region.", NULL);
+		writeErrmsgMemos();
+		return 1;
+	}
+
+	b->procs = ((BenchBoard *) results)->procs;
+	useBoard(b, results, selectPrimitives(0, NULL, &selections));
+	if (sm_ShmAttach(b->board->wmKey, b->board->wmSize, &wmSpace, &wmId)
+			< 0
+	|| psm_manage(wmSpace, b->board->wmSize, "icibench", &(b->wm),
+			&outcome) < 0 || outcome == Refused)
+	{
+		putErrmsg("Worker can't use benchmark partition.", NULL);
+	}
+	else if (sdr_initialize(0, NULL, SM_NO_KEY, NULL) < 0
+	|| (b->sdr = sdr_start_using(BENCH_SDR_NAME)) == NULL)
+	{
+		putErrmsg("Worker can't use benchmark SDR.", NULL);
+	}
+	else
+	{
+		result = initWorker(b);
+		if (result == 0)
+		{
+			result = runWorker(b);
+		}
+
+		endWorker(b);
+		sdr_stop_using(b->sdr);
+	}
+
+	if (result < 0)
+	{
+		writeErrmsgMemos();
+	}
+
+	oK(sm_SemTake(b->lock));
+	b->board->done[workerNbr] = 1;
+	sm_SemGive(b->lock);
+	if (wmSpace)
+	{
+		sm_ShmDetach(wmSpace);
+	}
+
+	sm_ShmDetach(results);
+	return (result < 0 ? 1 : 0);
+}
+
+static int	runWorkers(Bench *b, char *programName, int resultsKey,
+			vast resultsSize)
+{
+	int	workers[BENCH_MAX_PROCS];
+	char	workerNbrText[16];
+	char	keyText[16];
+	char	sizeText[32];
+	int	spawned;
+	int	result = 0;
+	int	finished;
+	int	i;
+
+	isprintf(keyText, sizeof keyText, "%d", resultsKey);
+	isprintf(sizeText, sizeof sizeText, VAST_FIELDSPEC, resultsSize);
+	for (spawned = 0; spawned < b->procs; spawned++)
+	{
+		i = spawned;
+		isprintf(workerNbrText, sizeof workerNbrText, "%d", i);
+		workers[i] = sm_TaskSpawn(programName, "-w", workerNbrText,
+				keyText, sizeText, NULL, NULL, NULL, NULL,
+				NULL, NULL, 0, 0);
+		if (workers[i] < 0)
+		{
+			putErrmsg("Can't spawn benchmark worker.", itoa(i));
+			b->board->aborted = 1;
+			result = -1;
+			break;		/*	Wait for the others.	*/
+		}
+	}
+
+	/*	Wait for all workers to finish.  A worker that has
+	 *	terminated without finishing has crashed, and the
+	 *	others must not wait for it.				*/
+
+	while (1)
+	{
+		finished = 0;
+		oK(sm_SemTake(b->lock));
+		for (i = 0; i < spawned; i++)
+		{
+			if (b->board->done[i])
+			{
+				finished++;
+			}
+			else if (!sm_TaskExists(workers[i]))
+			{
+				putErrmsg("Benchmark worker crashed.", itoa(i));
+				b->board->done[i] = 1;
+				b->board->aborted = 1;
+				result = -1;
+				finished++;
+			}
+		}
+
+		sm_SemGive(b->lock);
+		if (finished == spawned)
+		{
+			return result;
+		}
+
+		microsnooze(100000);
+	}
+}
+#endif
+
+/*	*	*	Results reporting	*	*	*	*	*/
+
+static int	compareLatencies(const void *a, const void *b)
+{
+	unsigned int	la = *((const unsigned int *) a);
+	unsigned int	lb = *((const unsigned int *) b);
+
+	return (la < lb ? -1 : (la > lb));
+}
+
+static void	printHeader(BenchFormat format)
+{
+	switch (format)
+	{
+	case BenchCsv:
+		PUTS("primitive,procs,size,ops,elapsed_ns,ops_per_sec,\
+p50_ns,p90_ns,p99_ns,max_ns");
+		break;
+
+	case BenchJson:
+		break;
+
+	default:
+		PUTS("primitive           procs  size       ops     ops/sec\
+   p50(ns)   p90(ns)   p99(ns)   max(ns)");
+	}
+}
+
+static int	reportPrimitive(Bench *b, int primNbr, BenchFormat format)
+{
+	char		*name = primitives[primNbr].name;
+	BenchSpan	*spans = b->spans + (primNbr * b->procs);
+	unsigned int	*latencies;
+	uvast		start = 0;
+	uvast		end = 0;
+	int		total;
+	uvast		elapsed;
+	double		rate;
+	unsigned int	p50;
+	unsigned int	p90;
+	unsigned int	p99;
+	unsigned int	max;
+	char		line[256];
+	int		i;
+
+	for (i = 0; i < b->procs; i++)
+	{
+		if (spans[i].failed || spans[i].opsDone < b->ops)
+		{
+			PUTMEMO("Primitive not completed, no results", name);
+			return -1;
+		}
+
+		if (i == 0 || spans[i].start < start)
+		{
+			start = spans[i].start;
+		}
+
+		if (spans[i].end > end)
+		{
+			end = spans[i].end;
+		}
+	}
+
+	/*	All workers' latencies for this primitive are
+	 *	contiguous in the results region, so they can be
+	 *	sorted in place.					*/
+
+	latencies = b->latencies + ((uvast) primNbr * b->procs * b->ops);
+	total = b->procs * b->ops;
+	qsort((char *) latencies, total, sizeof(unsigned int),
+			compareLatencies);
+	p50 = latencies[((uvast) (total - 1) * 50) / 100];
+	p90 = latencies[((uvast) (total - 1) * 90) / 100];
+	p99 = latencies[((uvast) (total - 1) * 99) / 100];
+	max = latencies[total - 1];
+	elapsed = end - start;
+	rate = (elapsed == 0 ? 0.0 : (total * 1.0e9) / elapsed);
+	switch (format)
+	{
+	case BenchCsv:
+		isprintf(line, sizeof line, "%s,%d,%d,%d," UVAST_FIELDSPEC
+				",%.0f,%u,%u,%u,%u", name, b->procs, b->size,
+				total, elapsed, rate, p50, p90, p99, max);
+		break;
+
+	case BenchJson:
+		isprintf(line, sizeof line, "{\"primitive\":\"%s\",\
+\"procs\":%d,\"size\":%d,\"ops\":%d,\"elapsed_ns\":" UVAST_FIELDSPEC ",\
+\"ops_per_sec\":%.0f,\"p50_ns\":%u,\"p90_ns\":%u,\"p99_ns\":%u,\
+\"max_ns\":%u}", name, b->procs, b->size, total, elapsed, rate,
+				p50, p90, p99, max);
+		break;
+
+	default:
+		isprintf(line, sizeof line, "%-19s %5d %5d %9d %11.0f %9u \
+%9u %9u %9u", name, b->procs, b->size, total, rate, p50, p90, p99,
+				max);
+	}
+
+	PUTS(line);
+	return 0;
+}
+
+/*	*	*	Main	*	*	*	*	*	*	*/
+
+static void	logToStderr(char *text)
+{
+	/*	Diagnostics go to stderr, keeping stdout fit for
+	 *	machine parsing.  The empty memo written on task
+	 *	spawn (to close any log file) is discarded.		*/
+
+	if (text && *text)
+	{
+		fprintf(stderr, "%s\n", text);
+		fflush(stderr);
+	}
+}
+
+static int	attachRegion(int key, vast size, char **region,
+			uaddr *regionId)
+{
+	if (size > BENCH_MAX_REGION)
+	{
+		putErrmsg("Benchmark region too large; reduce ops or procs.",
+				itoa((int) (size >> 20)));
+		return -1;
+	}
+
+	*region = NULL;
+	if (sm_ShmAttach(key, size, region, regionId) < 0)
+	{
+		putErrmsg("Can't attach benchmark region.", NULL);
+		return -1;
+	}
+
+	memset(*region, 0, size);
+	return 0;
+}
+
+static int	run_icibench(BenchParms *parms)
+{
+	Bench		bench;
+	Bench		*b = &bench;
+	int		primCount;
+	unsigned int	selections;
+	BenchBoard	board;
+	char		*wmSpace;
+	uaddr		wmId;
+	PsmMgtOutcome	outcome;
+	int		resultsKey;
+	vast		resultsSize;
+	char		*results;
+	uaddr		resultsId;
+	vast		heapBytes;
+	char		dsfilename[MAXPATHLEN + 1];
+	int		result = 0;
+	int		i;
+
+	primCount = selectPrimitives(parms->selCount, parms->selections,
+			&selections);
+	if (selections == 0)
+	{
+		PUTS("No benchmarked primitive matches the selection.");
+		return 1;
+	}
+
+	sm_ipc_init();
+	memset((char *) b, 0, sizeof(Bench));
+	memset((char *) &board, 0, sizeof(BenchBoard));
+	board.ops = parms->ops;
+	board.size = parms->size;
+	board.procs = parms->procs;
+	board.selections = selections;
+
+	/*	PSM partition shared by all workers.  Its length must
+	 *	be a multiple of 16 bytes.				*/
+
+	board.wmKey = sm_GetUniqueKey();
+	board.wmSize = ((((vast) parms->procs * parms->ops
+			* (parms->size + BENCH_NODE_OVERHEAD)) + 1000000)
+			/ 16) * 16;
+	if (attachRegion(board.wmKey, board.wmSize, &wmSpace, &wmId) < 0)
+	{
+		writeErrmsgMemos();
+		return 1;
+	}
+
+	if (psm_manage(wmSpace, board.wmSize, "icibench", &(b->wm), &outcome)
+			< 0 || outcome == Refused)
+	{
+		putErrmsg("Can't manage benchmark partition.", NULL);
+		writeErrmsgMemos();
+		sm_ShmDetach(wmSpace);
+		sm_ShmDestroy(wmId);
+		return 1;
+	}
+
+	/*	Results region, written by workers and read by the
+	 *	parent when all workers have finished.			*/
+
+	resultsKey = sm_GetUniqueKey();
+	resultsSize = sizeof(BenchBoard)
+		+ ((vast) primCount * parms->procs * sizeof(BenchSpan))
+		+ ((vast) primCount * parms->procs * parms->ops
+				* sizeof(unsigned int));
+	if (attachRegion(resultsKey, resultsSize, &results, &resultsId) < 0)
+	{
+		writeErrmsgMemos();
+		psm_unmanage(b->wm);
+		sm_ShmDetach(wmSpace);
+		sm_ShmDestroy(wmId);
+		return 1;
+	}
+
+	board.lock = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+
+	/*	Private SDR.  Any dataspace file left over from an
+	 *	earlier run is discarded.				*/
+
+	heapBytes = ((vast) parms->procs * parms->ops * (parms->size
+			+ BENCH_NODE_OVERHEAD) * 2) + 4000000;
+	isprintf(dsfilename, sizeof dsfilename, "%s%c%s.sdr", parms->pathName,
+			ION_PATH_DELIMITER, BENCH_SDR_NAME);
+	oK(unlink(dsfilename));
+	b->sdr = NULL;
+	if (board.lock == SM_SEM_NONE
+	|| sdr_initialize(BENCH_SDR_WM_SIZE, NULL, SM_NO_KEY, NULL) < 0
+	|| sdr_load_profile(BENCH_SDR_NAME, parms->configFlags,
+			heapBytes / sizeof(SdrObject), SM_NO_KEY, 0, SM_NO_KEY,
+			parms->pathName, NULL) < 0
+	|| (b->sdr = sdr_start_using(BENCH_SDR_NAME)) == NULL)
+	{
+		putErrmsg("Can't initialize benchmark SDR.", NULL);
+		writeErrmsgMemos();
+		result = 1;
+	}
+	else
+	{
+		oK(sdr_begin_xn(b->sdr));
+		board.hash = sdr_hash_create(b->sdr, BENCH_HASH_KEYLEN,
+				parms->procs * parms->ops, 4);
+		if (sdr_end_xn(b->sdr) < 0 || board.hash == 0)
+		{
+			putErrmsg("Can't create benchmark hash table.", NULL);
+			writeErrmsgMemos();
+			result = 1;
+		}
+	}
+
+	memcpy(results, (char *) &board, sizeof(BenchBoard));
+	b->procs = parms->procs;
+	useBoard(b, results, primCount);
+	if (result == 0)
+	{
+		printHeader(parms->format);
+		fflush(stdout);
+#if !(defined (ION_LWT) || defined (mingw))
+		if (b->procs > 1)
+		{
+			if (runWorkers(b, parms->programName, resultsKey,
+					resultsSize) < 0)
+			{
+				writeErrmsgMemos();
+				result = 1;
+			}
+		}
+		else
+#endif
+		{
+			b->workerNbr = 0;
+			if (initWorker(b) < 0 || runWorker(b) < 0)
+			{
+				writeErrmsgMemos();
+				result = 1;
+			}
+
+			endWorker(b);
+		}
+
+		for (i = 0; i < primCount; i++)
+		{
+			if ((selections & (1 << i))
+			&& reportPrimitive(b, i, parms->format) < 0)
+			{
+				result = 1;
+			}
+		}
+	}
+
+	if (b->sdr)
+	{
+		sdr_destroy(b->sdr);
+	}
+
+	sdr_shutdown();
+	if (board.lock != SM_SEM_NONE)
+	{
+		sm_SemDelete(board.lock);
+	}
+
+	sm_ShmDetach(results);
+	sm_ShmDestroy(resultsId);
+	psm_unmanage(b->wm);
+	sm_ShmDetach(wmSpace);
+	sm_ShmDestroy(wmId);
+	writeErrmsgMemos();
+	return result;
+}
+
+static void	printUsage()
+{
+	PUTS("Usage: icibench [-n <ops per process>] [-s <object size>] \
+[-p <nbr of processes>] [-c <SDR config flags>] [-d <SDR directory>] \
+[-f table|csv|json] [<primitive name prefix> ...]");
+	PUTS("Primitives:");
+	PUTS("\tpsm_malloc psm_free");
+	PUTS("\tsm_list_insert sm_list_delete");
+	PUTS("\tsm_rbt_insert sm_rbt_search sm_rbt_delete");
+	PUTS("\tsdr_xn sdr_write_xn sdr_malloc sdr_free");
+	PUTS("\tsdr_list_insert sdr_list_delete");
+	PUTS("\tsdr_hash_insert sdr_hash_retrieve sdr_hash_remove");
+	PUTS("\tzco_create zco_transmit zco_destroy");
+}
+
+static int	parseFormat(char *text, BenchFormat *format)
+{
+	if (strcmp(text, "table") == 0)
+	{
+		*format = BenchTable;
+	}
+	else if (strcmp(text, "csv") == 0)
+	{
+		*format = BenchCsv;
+	}
+	else if (strcmp(text, "json") == 0)
+	{
+		*format = BenchJson;
+	}
+	else
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	checkParms(BenchParms *parms)
+{
+	if (parms->ops < 1 || parms->size < 1 || parms->procs < 1
+	|| parms->procs > BENCH_MAX_PROCS)
+	{
+		printUsage();
+		return -1;
+	}
+
+#if defined (ION_LWT) || defined (mingw)
+	if (parms->procs > 1)
+	{
+		PUTS("Multiple worker processes not supported; using 1.");
+		parms->procs = 1;
+	}
+#endif
+	return 0;
+}
+
+static void	initParms(BenchParms *parms)
+{
+	memset((char *) parms, 0, sizeof(BenchParms));
+	parms->ops = BENCH_DEFAULT_OPS;
+	parms->size = BENCH_DEFAULT_SIZE;
+	parms->procs = 1;
+	parms->configFlags = BENCH_DEFAULT_FLAGS;
+	parms->pathName = BENCH_PATH_NAME;
+	parms->format = BenchTable;
+}
+
+#if defined (ION_LWT)
+int	icibench(saddr a1, saddr a2, saddr a3, saddr a4, saddr a5,
+		saddr a6, saddr a7, saddr a8, saddr a9, saddr a10)
+{
+	BenchParms	parms;
+	char		*selection = (char *) a5;
+
+	setLogger(logToStderr);
+	initParms(&parms);
+	if (a1) parms.ops = a1;
+	if (a2) parms.size = a2;
+	if (a3) parms.configFlags = a3;
+	if (a4 && parseFormat((char *) a4, &parms.format) < 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (selection)
+	{
+		parms.selCount = 1;
+		parms.selections = &selection;
+	}
+
+	if (checkParms(&parms) < 0)
+	{
+		return 1;
+	}
+
+	return run_icibench(&parms);
+}
+#else
+int	main(int argc, char **argv)
+{
+	BenchParms	parms;
+	int		i;
+
+	setLogger(logToStderr);
+	initParms(&parms);
+	parms.programName = argv[0];
+#ifndef mingw
+	if (argc == 5 && strcmp(argv[1], "-w") == 0)
+	{
+		return run_worker(atoi(argv[2]), atoi(argv[3]),
+				strtovast(argv[4]));
+	}
+#endif
+	for (i = 1; i < argc && argv[i][0] == '-'; i += 2)
+	{
+		if (i + 1 >= argc || argv[i][2] != '\0')
+		{
+			printUsage();
+			return 1;
+		}
+
+		switch (argv[i][1])
+		{
+		case 'n':
+			parms.ops = atoi(argv[i + 1]);
+			break;
+
+		case 's':
+			parms.size = atoi(argv[i + 1]);
+			break;
+
+		case 'p':
+			parms.procs = atoi(argv[i + 1]);
+			break;
+
+		case 'c':
+			parms.configFlags = atoi(argv[i + 1]);
+			break;
+
+		case 'd':
+			parms.pathName = argv[i + 1];
+			break;
+
+		case 'f':
+			if (parseFormat(argv[i + 1], &parms.format) < 0)
+			{
+				printUsage();
+				return 1;
+			}
+
+			break;
+
+		default:
+			printUsage();
+			return 1;
+		}
+	}
+
+	parms.selCount = argc - i;
+	parms.selections = argv + i;
+	if (checkParms(&parms) < 0)
+	{
+		return 1;
+	}
+
+	return run_icibench(&parms);
+}
+#endif
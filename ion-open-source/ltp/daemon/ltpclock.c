@@ -33,89 +33,244 @@ static void	shutDown(int signum)	/*	Stops ltpclock.		*/
 	uaddr	stop = 0;
 
 	oK(_running(&stop));	/*	Terminates ltpclock.		*/
+	sm_SemEnd((getLtpVdb())->clockSemaphore);
 }
 
-static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
+/*	The clock timer gives the clock semaphore at the time at
+ *	which ltpclock has planned to wake up.  Processes that insert
+ *	earlier events into the timeline give the clock semaphore
+ *	themselves, so ltpclock sleeps until the next event is due
+ *	or the next second begins rather than polling.			*/
+
+typedef struct
 {
-	Object		elt;
-	Object		eventObj;
-	LtpEvent	event;
-	int		result;
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cv;
+	vast		wakeTime;	/*	Msec; 0 if none.	*/
+	int		running;
+	sm_SemId	semaphore;
+} ClockTimer;
+
+static void	*timerMain(void *parm)
+{
+	ClockTimer	*timer = (ClockTimer *) parm;
+	vast		interval;
+	struct timeval	workTime;
+	struct timespec	deadline;
 
-	while (1)
+	pthread_mutex_lock(&timer->mutex);
+	while (timer->running)
 	{
-		CHKERR(sdr_begin_xn(sdr));
-		elt = sdr_list_first(sdr, events);
-		if (elt == 0)	/*	No more events to dispatch.	*/
+		if (timer->wakeTime == 0)	/*	Nothing planned.	*/
 		{
-			sdr_exit_xn(sdr);
-			return 0;
+			oK(pthread_cond_wait(&timer->cv, &timer->mutex));
+			continue;
 		}
 
-		eventObj = sdr_list_data(sdr, elt);
-		sdr_read(sdr, (char *) &event, eventObj, sizeof(LtpEvent));
-		if (event.scheduledTime > currentTime)
+		interval = timer->wakeTime - getCtimeMsec();
+		if (interval > 0)
 		{
-			/*	This is the first future event.		*/
+			getCurrentTime(&workTime);
+			workTime.tv_sec += interval / 1000;
+			workTime.tv_usec += (interval % 1000) * 1000;
+			if (workTime.tv_usec >= 1000000)
+			{
+				workTime.tv_usec -= 1000000;
+				workTime.tv_sec += 1;
+			}
 
-			sdr_exit_xn(sdr);
-			return 0;
+			deadline.tv_sec = workTime.tv_sec;
+			deadline.tv_nsec = workTime.tv_usec * 1000;
+			oK(pthread_cond_timedwait(&timer->cv, &timer->mutex,
+					&deadline));
+			continue;	/*	Wake time may be revised.	*/
 		}
 
-		sdr_free(sdr, eventObj);
-		sdr_list_delete(sdr, elt, NULL, NULL);
-		switch (event.type)
-		{
-		case LtpResendCheckpoint:
-			result = ltpResendCheckpoint(event.refNbr2,
-					event.refNbr3);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendXmitCancel:
-			result = ltpResendXmitCancel(event.refNbr2);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendReport:
-			result = ltpResendReport(event.refNbr1,
-					event.refNbr2, event.refNbr3);
-			break;		/*	Out of switch.		*/
-
-		case LtpResendRecvCancel:
-			result = ltpResendRecvCancel(event.refNbr1,
-					event.refNbr2);
-			break;		/*	Out of switch.		*/
-
-		case LtpForgetImportSession:
-			sdr_list_delete(sdr, event.parm, NULL, NULL);
-			result = 0;
-			break;		/*	Out of switch.		*/
+		timer->wakeTime = 0;
+		sm_SemGive(timer->semaphore);
+	}
+
+	pthread_mutex_unlock(&timer->mutex);
+	return NULL;
+}
+
+static void	setTimer(ClockTimer *timer, vast wakeTime)
+{
+	pthread_mutex_lock(&timer->mutex);
+	timer->wakeTime = wakeTime;
+	pthread_cond_signal(&timer->cv);
+	pthread_mutex_unlock(&timer->mutex);
+}
+
+static int	dispatchEvent(Sdr sdr, LtpEvent *event)
+{
+	switch (event->type)
+	{
+	case LtpResendCheckpoint:
+		return ltpResendCheckpoint(event->refNbr2, event->refNbr3);
+
+	case LtpResendXmitCancel:
+		return ltpResendXmitCancel(event->refNbr2);
+
+	case LtpResendReport:
+		return ltpResendReport(event->refNbr1, event->refNbr2,
+				event->refNbr3);
+
+	case LtpResendRecvCancel:
+		return ltpResendRecvCancel(event->refNbr1, event->refNbr2);
+
+	case LtpForgetImportSession:
+		sdr_list_delete(sdr, event->parm, NULL, NULL);
+		return 0;
 
 #if CLOSED_EXPORTS_ENABLED
-		case LtpForgetExportSession:
-			ltpForgetClosedExport(event.parm);
-			result = 0;
-			break;		/*	Out of switch.		*/
+	case LtpForgetExportSession:
+		ltpForgetClosedExport(event->parm);
+		return 0;
 #endif
-		default:		/*	Spurious event.		*/
-			result = 0;	/*	Event is ignored.	*/
+	default:		/*	Spurious event.			*/
+		return 0;	/*	Event is ignored.		*/
+	}
+}
+
+/*	Dispatches all events in the timeline slots for the ticks
+ *	from the time of the last dispatch through the current time
+ *	that are now due, up to LTP_EVENT_BATCH events per
+ *	transaction.  The slot for the tick of the last dispatch is
+ *	revisited in case events were added to it after it was last
+ *	examined.							*/
+
+static int	dispatchEvents(Sdr sdr, vast currentTime,
+			vast *lastDispatchTick)
+{
+	vast		currentTick = currentTime / LTP_TIMELINE_TICK;
+	vast		tick;
+	Object		slot;
+	Object		elt;
+	LtpEvent	event;
+	int		batchCount = 0;
+
+	if (currentTick < *lastDispatchTick
+	|| currentTick - *lastDispatchTick >= LTP_TIMELINE_SLOTS)
+	{
+		/*	First dispatch, or clock has been reset: the
+		 *	slots to examine are unknown, so examine all.	*/
+
+		tick = currentTick - (LTP_TIMELINE_SLOTS - 1);
+	}
+	else
+	{
+		tick = *lastDispatchTick;
+	}
+
+	*lastDispatchTick = currentTick;
+	CHKERR(sdr_begin_xn(sdr));
+	for (; tick <= currentTick; tick++)
+	{
+		slot = ltpTimelineSlot(tick * LTP_TIMELINE_TICK);
+		while (1)
+		{
+			elt = sdr_list_first(sdr, slot);
+			if (elt == 0)	/*	No more events in slot.	*/
+			{
+				break;
+			}
+
+			sdr_read(sdr, (char *) &event, sdr_list_data(sdr, elt),
+					sizeof(LtpEvent));
+			if (event.scheduledTime > currentTime)
+			{
+				/*	First future event in slot.	*/
+
+				break;
+			}
+
+			ltpRemoveTimelineEvent(elt);
+			if (dispatchEvent(sdr, &event) < 0)
+			{
+				sdr_cancel_xn(sdr);
+				putErrmsg("failed handing LTP event", NULL);
+				return -1;
+			}
+
+			batchCount++;
+			if (batchCount < LTP_EVENT_BATCH)
+			{
+				continue;
+			}
+
+			if (sdr_end_xn(sdr) < 0)
+			{
+				putErrmsg("failed dispatching LTP events",
+						NULL);
+				return -1;
+			}
+
+			batchCount = 0;
+			CHKERR(sdr_begin_xn(sdr));
 		}
+	}
+
+	if (batchCount == 0)
+	{
+		sdr_exit_xn(sdr);
+		return 0;
+	}
+
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("failed dispatching LTP events", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*	Notes in the LTP volatile database the time at which ltpclock
+ *	must next wake up: the scheduled time of the earliest event
+ *	at the start of any slot for the ticks before the deadline,
+ *	else the deadline itself.  Events inserted into the timeline
+ *	later revise this time as necessary.				*/
+
+static int	planWakeTime(Sdr sdr, vast currentTime, vast deadline)
+{
+	LtpVdb		*ltpvdb = getLtpVdb();
+	vast		wakeTime = deadline;
+	vast		tick;
+	vast		lastTick = deadline / LTP_TIMELINE_TICK;
+	Object		elt;
+	LtpEvent	event;
 
-		if (result < 0)		/*	Dispatching failed.	*/
+	if (lastTick - (currentTime / LTP_TIMELINE_TICK) >= LTP_TIMELINE_SLOTS)
+	{
+		lastTick = (currentTime / LTP_TIMELINE_TICK)
+				+ (LTP_TIMELINE_SLOTS - 1);
+	}
+
+	CHKERR(sdr_begin_xn(sdr));
+	for (tick = currentTime / LTP_TIMELINE_TICK; tick <= lastTick; tick++)
+	{
+		elt = sdr_list_first(sdr, ltpTimelineSlot(tick
+				* LTP_TIMELINE_TICK));
+		if (elt == 0)
 		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("failed handing LTP event", NULL);
-			return result;
+			continue;
 		}
 
-		if (sdr_end_xn(sdr) < 0)
+		sdr_read(sdr, (char *) &event, sdr_list_data(sdr, elt),
+				sizeof(LtpEvent));
+		if (event.scheduledTime < wakeTime)
 		{
-			putErrmsg("failed dispatching LTP event", NULL);
-			return -1;
+			wakeTime = event.scheduledTime;
 		}
 	}
+
+	ltpvdb->clockWakeTime = wakeTime;
+	sdr_exit_xn(sdr);
+	return 0;
 }
 
-static int	manageLinks(Sdr sdr, time_t currentTime)
+static int	manageLinks(Sdr sdr, vast currentTime)
 {
 	PsmPartition	ionwm = getIonwm();
 	LtpVdb		*ltpvdb = getLtpVdb();
@@ -229,10 +384,14 @@ int	ltpclock(saddr a1, saddr a2, saddr a3, saddr a4, saddr a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	LtpDB	*ltpConstants;
-	uaddr	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	LtpVdb		*ltpvdb;
+	uaddr		state = 1;
+	vast		currentTime;
+	vast		nextSecond = 0;
+	vast		lastDispatchTick = 0;
+	ClockTimer	timer;
+	pthread_t	timerThread;
 
 	if (ltpInit(0) < 0)
 	{
@@ -241,7 +400,19 @@ int	main(int argc, char *argv[])
 	}
 
 	sdr = getIonsdr();
-	ltpConstants = getLtpConstants();
+	ltpvdb = getLtpVdb();
+	memset((char *) &timer, 0, sizeof(ClockTimer));
+	timer.running = 1;
+	timer.semaphore = ltpvdb->clockSemaphore;
+	if (pthread_mutex_init(&timer.mutex, NULL)
+	|| pthread_cond_init(&timer.cv, NULL)
+	|| pthread_begin(&timerThread, NULL, timerMain, &timer,
+			"ltpclock_timer"))
+	{
+		putSysErrmsg("ltpclock can't start clock timer", NULL);
+		return 1;
+	}
+
 	isignal(SIGTERM, shutDown);
 
 	/*	Main loop: wait for event occurrence time, then
@@ -251,36 +422,56 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] ltpclock is running.");
 	while (_running(NULL))
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose executions times have now been reached.	*/
+		currentTime = getCtimeMsec();
+		if (currentTime >= nextSecond)
+		{
+			/*	Once per second, infer link state
+			 *	changes from rate changes noted in the
+			 *	shared ION database.			*/
+
+			if (manageLinks(sdr, currentTime) < 0)
+			{
+				putErrmsg("Can't manage links.", NULL);
+				state = 0;	/*	Terminate loop.	*/
+				oK(_running(&state));
+				continue;
+			}
 
-		snooze(1);
-		currentTime = getCtime();
+			nextSecond = ((currentTime / 1000) + 1) * 1000;
+		}
 
-		/*	Infer link state changes from rate changes
-		 *	noted in the shared ION database.		*/
+		/*	Then dispatch retransmission events, as
+		 *	constrained by the new link state.		*/
 
-		if (manageLinks(sdr, currentTime) < 0)
+		if (dispatchEvents(sdr, currentTime, &lastDispatchTick) < 0
+		|| planWakeTime(sdr, currentTime, nextSecond) < 0)
 		{
-			putErrmsg("Can't manage links.", NULL);
+			putErrmsg("Can't dispatch events.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
 			continue;
 		}
 
-		/*	Then dispatch retransmission events, as
-		 *	constrained by the new link state.		*/
+		/*	Sleep until the next event is due or the next
+		 *	second begins, whichever is sooner, or until
+		 *	an earlier event is inserted in the meantime.	*/
 
-		if (dispatchEvents(sdr, ltpConstants->timeline, currentTime)
-				< 0)
+		setTimer(&timer, ltpvdb->clockWakeTime);
+		if (sm_SemTake(ltpvdb->clockSemaphore) < 0
+		|| sm_SemEnded(ltpvdb->clockSemaphore))
 		{
-			putErrmsg("Can't dispatch events.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
-			continue;
 		}
 	}
 
+	pthread_mutex_lock(&timer.mutex);
+	timer.running = 0;
+	pthread_cond_signal(&timer.cv);
+	pthread_mutex_unlock(&timer.mutex);
+	pthread_join(timerThread, NULL);
+	pthread_cond_destroy(&timer.cv);
+	pthread_mutex_destroy(&timer.mutex);
 	writeErrmsgMemos();
 	writeMemo("[i] ltpclock has ended.");
 	ionDetach();
@@ -49,7 +49,7 @@ int	main(int argc, char *argv[])
 
 	sdr = getIonsdr();
 	vdb = getLtpVdb();
-	CHKZERO(sdr_begin_xn(sdr));
+	CHKZERO(sdr_begin_read_xn(sdr));
 	findSpan(remoteEngineId, &vspan, &vspanElt);
 	if (vspanElt == 0)
 	{
@@ -69,23 +69,23 @@ int	main(int argc, char *argv[])
 	/*	All command-line arguments are now validated.		*/
 
 	spanObj = sdr_list_data(sdr, vspan->spanElt);
-	sdr_stage(sdr, (char *) &span, spanObj, sizeof(LtpSpan));
+	sdr_read(sdr, (char *) &span, spanObj, sizeof(LtpSpan));
+	sdr_exit_xn(sdr);
 	if (span.currentExportSessionObj == 0)	/*	New span.	*/
 	{
 		/*	Must start span's initial session.		*/
 
-		sdr_exit_xn(sdr);
 		if (startExportSession(sdr, spanObj, vspan) < 0)
 		{
 			putErrmsg("ltpmeter can't start new session.",
 					itoa(remoteEngineId));
 			return 1;
 		}
-
-		CHKZERO(sdr_begin_xn(sdr));
-		sdr_stage(sdr, (char *) &span, spanObj, sizeof(LtpSpan));
 	}
 
+	CHKZERO(sdr_begin_xn(sdr));
+	sdr_stage(sdr, (char *) &span, spanObj, sizeof(LtpSpan));
+
 	writeMemo("[i] ltpmeter is running.");
 	while (returnCode == 0)
 	{
@@ -25,6 +25,12 @@
  *			 from generalized extensions.
  */
 
+#if (defined(linux) && !(defined(bionic)))
+#ifndef _GNU_SOURCE
+#define	_GNU_SOURCE		/*	For fallocate().		*/
+#endif
+#endif
+
 #include "ltpP.h"
 #include "ltpei.h"
 
@@ -62,7 +68,34 @@
 
 #define LTP_VERSION		0;
 
+/*	Timeline index keys are event type and reference numbers,
+ *	serialized so that the key includes no structure padding.	*/
+
+#define	LTP_EVENT_KEY_LEN	(sizeof(uvast) + (3 * sizeof(unsigned int)))
+
+#ifdef unix
+#define	LTP_CAN_PWRITE		1
+#else
+#define	LTP_CAN_PWRITE		0
+#endif
+
+/*	Number of open block file descriptors each process retains
+ *	for writing the file-resident portions of received red parts.	*/
+
+#ifndef LTP_BLOCK_FD_CACHE_SIZE
+#define LTP_BLOCK_FD_CACHE_SIZE	(8)
+#endif
+
+/*	Bytes of block file space preallocated beyond the end of the
+ *	latest write while the length of the red part is not yet
+ *	known.								*/
+
+#ifndef LTP_BLOCK_FILE_EXTENT
+#define LTP_BLOCK_FILE_EXTENT	(1024 * 1024)
+#endif
+
 static Object	insertLtpTimelineEvent(LtpEvent *newEvent);
+static void	forgetBlockFile(Object blockFileRef);
 static int	constructReportAckSegment(LtpSpan *span, Object spanObj,
 			unsigned int sessionNbr, unsigned int reportSerialNbr);
 static Object	enqueueAckSegment(Object spanObj, Object segmentObj);
@@ -176,7 +209,7 @@ static int	noteClosedExport(LtpDB *ltpdb, LtpVspan *vspan, Object spanObj,
 			unsigned int sessionNbr)
 {
 	Sdr		sdr = getIonsdr();
-	time_t		currentTime = getCtime();
+	vast		currentTime = getCtimeMsec();
 	ClosedExport	closedExportBuf;
 	Object 		closedExportObj;
 	Object		elt;
@@ -205,9 +238,9 @@ static int	noteClosedExport(LtpDB *ltpdb, LtpVspan *vspan, Object spanObj,
 
 	memset((char *) &closedExportEvent, 0, sizeof(LtpEvent));
 	closedExportEvent.parm = elt;
-	closedExportEvent.scheduledTime = currentTime + 10 +
+	closedExportEvent.scheduledTime = currentTime + 1000 * (10 +
 			(2 * (vspan->maxTimeouts / SIGNAL_REDUNDANCY)
-			 * (vspan->owltOutbound + vspan->owltInbound));
+			 * (vspan->owltOutbound + vspan->owltInbound)));
 	closedExportEvent.type = LtpForgetExportSession;
 	closedExportBuf.timeout = insertLtpTimelineEvent(&closedExportEvent);
 	if (closedExportBuf.timeout == 0)
@@ -275,8 +308,7 @@ static int	acknowledgeLateReport(unsigned int sessionNbr,
 				writeMemoNote("[i] Forget session, retries \
 exceeded", utoa(closedExportBuf.sessionNbr));
 #endif
-				sdr_list_delete(sdr, closedExportBuf.timeout,
-						NULL, NULL);
+				ltpRemoveTimelineEvent(closedExportBuf.timeout);
 				sdr_free(sdr, closedExportObj);
 				sdr_list_delete(sdr, elt, NULL, NULL);
 			}
@@ -815,6 +847,8 @@ static LtpVdb		*_ltpvdb(char **name)
 		vdb->clockPid = ERROR;		/*	None yet.	*/
 		vdb->delivPid = ERROR;		/*	None yet.	*/
 		vdb->deliverySemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		vdb->clockSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		sm_SemTake(vdb->clockSemaphore);		/*	Lock.	*/
 		if ((vdb->spans = sm_list_create(wm)) == 0
 		|| psm_catlg(wm, *name, vdbAddress) < 0)
 		{
@@ -863,6 +897,7 @@ int	ltpInit(int estMaxExportSessions)
 	IonDB	iondb;
 	LtpDB	ltpdbBuf;
 	int	i;
+	Object	slot;
 	char	*ltpvdbName = _ltpvdbName();
 
 	if (ionAttach() < 0)
@@ -927,7 +962,22 @@ int	ltpInit(int estMaxExportSessions)
 #endif
 		ltpdbBuf.deadExports = sdr_list_create(sdr);
 		ltpdbBuf.spans = sdr_list_create(sdr);
-		ltpdbBuf.timeline = sdr_list_create(sdr);
+		ltpdbBuf.timeline = sdr_malloc(sdr,
+				LTP_TIMELINE_SLOTS * sizeof(Object));
+		if (ltpdbBuf.timeline)
+		{
+			for (i = 0; i < LTP_TIMELINE_SLOTS; i++)
+			{
+				slot = sdr_list_create(sdr);
+				sdr_write(sdr, ltpdbBuf.timeline
+						+ (i * sizeof(Object)),
+						(char *) &slot, sizeof(Object));
+			}
+		}
+
+		ltpdbBuf.timelineIndex = sdr_hash_create(sdr,
+				LTP_EVENT_KEY_LEN, estMaxExportSessions,
+				LTP_MEAN_SEARCH_LENGTH);
 		ltpdbBuf.maxAcqInHeap = 560;
 		sdr_write(sdr, ltpdbObject, (char *) &ltpdbBuf,
 				sizeof(LtpDB));
@@ -991,6 +1041,13 @@ static void	dropVdb(PsmPartition wm, PsmAddress vdbAddress)
 		microsnooze(50000);
 		sm_SemDelete(vdb->deliverySemaphore);
 	}
+
+	if (vdb->clockSemaphore != SM_SEM_NONE)
+	{
+		sm_SemEnd(vdb->clockSemaphore);
+		microsnooze(50000);
+		sm_SemDelete(vdb->clockSemaphore);
+	}
 }
 
 void	ltpDropVdb()
@@ -1128,6 +1185,7 @@ void	ltpStop()		/*	Reverses ltpStart.		*/
 
 	CHKVOID(sdr_begin_xn(sdr));	/*	Just to lock memory.	*/
 	sm_SemEnd(ltpvdb->deliverySemaphore);
+	sm_SemEnd(ltpvdb->clockSemaphore);
 	for (i = 0, client = ltpvdb->clients; i < LTP_MAX_NBR_OF_CLIENTS;
 			i++, client++)
 	{
@@ -1195,6 +1253,9 @@ void	ltpStop()		/*	Reverses ltpStart.		*/
 	ltpvdb->lsiPid = ERROR;
 	ltpvdb->clockPid = ERROR;
 	ltpvdb->delivPid = ERROR;
+	sm_SemUnend(ltpvdb->clockSemaphore);
+	sm_SemGive(ltpvdb->clockSemaphore);
+	sm_SemTake(ltpvdb->clockSemaphore);		/*	Lock.	*/
 	for (i = 0, client = ltpvdb->clients; i < LTP_MAX_NBR_OF_CLIENTS;
 			i++, client++)
 	{
@@ -1807,12 +1868,57 @@ int	startExportSession(Sdr sdr, Object spanObj, LtpVspan *vspan)
 
 /*	*	*	LTP event mgt and access functions	*	*/
 
+static int	eventIsIndexed(LtpEventType type)
+{
+	switch (type)
+	{
+	case LtpResendCheckpoint:
+	case LtpResendXmitCancel:
+	case LtpResendReport:
+	case LtpResendRecvCancel:
+		return 1;
+
+	default:	/*	Forget events are never canceled.	*/
+		return 0;
+	}
+}
+
+static void	getEventKey(char *key, LtpEventType type, uvast refNbr1,
+			unsigned int refNbr2, unsigned int refNbr3)
+{
+	unsigned int	typeNbr = type;
+
+	memcpy(key, (char *) &refNbr1, sizeof(uvast));
+	key += sizeof(uvast);
+	memcpy(key, (char *) &refNbr2, sizeof(unsigned int));
+	key += sizeof(unsigned int);
+	memcpy(key, (char *) &refNbr3, sizeof(unsigned int));
+	key += sizeof(unsigned int);
+	memcpy(key, (char *) &typeNbr, sizeof(unsigned int));
+}
+
+Object	ltpTimelineSlot(vast time)
+{
+	Sdr	sdr = getIonsdr();
+	Object	slot;
+
+	sdr_read(sdr, (char *) &slot, (_ltpConstants())->timeline
+			+ ((((uvast) time / LTP_TIMELINE_TICK)
+			% LTP_TIMELINE_SLOTS) * sizeof(Object)),
+			sizeof(Object));
+	return slot;
+}
+
 static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 {
 	Sdr	sdr = getIonsdr();
 	LtpDB	*ltpConstants = _ltpConstants();
+	LtpVdb	*ltpvdb = _ltpvdb(NULL);
+	vast	currentTime = getCtimeMsec();
 	Object	eventObj;
+	Object	slot;
 	Object	elt;
+	char	key[LTP_EVENT_KEY_LEN];
 		OBJ_POINTER(LtpEvent, event);
 
 	CHKZERO(ionLocked());
@@ -1823,46 +1929,118 @@ static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 		return 0;
 	}
 
-	/*	Search list from newest to oldest, insert after last
+	/*	An event that is already overdue goes into the slot
+	 *	for the current tick, which ltpclock has not yet
+	 *	passed, so that it is dispatched at once rather than
+	 *	on the next revolution of the wheel.			*/
+
+	if (newEvent->scheduledTime < currentTime)
+	{
+		slot = ltpTimelineSlot(currentTime);
+	}
+	else
+	{
+		slot = ltpTimelineSlot(newEvent->scheduledTime);
+	}
+
+	/*	Search slot from newest to oldest, insert after last
 		event with scheduled time less than or equal to that
 		of the new event.					*/
 
 	sdr_write(sdr, eventObj, (char *) newEvent, sizeof(LtpEvent));
-	for (elt = sdr_list_last(sdr, ltpConstants->timeline); elt;
-			elt = sdr_list_prev(sdr, elt))
+	for (elt = sdr_list_last(sdr, slot); elt; elt = sdr_list_prev(sdr, elt))
 	{
 		GET_OBJ_POINTER(sdr, LtpEvent, event, sdr_list_data(sdr,
 				elt));
 		if (event->scheduledTime <= newEvent->scheduledTime)
 		{
-			return sdr_list_insert_after(sdr, elt, eventObj);
+			break;
+		}
+	}
+
+	if (elt)
+	{
+		elt = sdr_list_insert_after(sdr, elt, eventObj);
+	}
+	else
+	{
+		elt = sdr_list_insert_first(sdr, slot, eventObj);
+	}
+
+	if (elt == 0)
+	{
+		putErrmsg("Can't insert timeline event.", NULL);
+		return 0;
+	}
+
+	/*	Should a retransmission event be scheduled while an
+	 *	identical one is pending, only the first is indexed
+	 *	and can be canceled; the other is simply dispatched
+	 *	when due.						*/
+
+	if (eventIsIndexed(newEvent->type))
+	{
+		getEventKey(key, newEvent->type, newEvent->refNbr1,
+				newEvent->refNbr2, newEvent->refNbr3);
+		if (sdr_hash_insert(sdr, ltpConstants->timelineIndex, key,
+				elt, NULL) < 0)
+		{
+			putErrmsg("Can't index timeline event.", NULL);
+			return 0;
 		}
 	}
 
-	return sdr_list_insert_first(sdr, ltpConstants->timeline, eventObj);
+	/*	Wake ltpclock early if the new event is due before
+	 *	the time at which it had planned to wake up.		*/
+
+	if (ltpvdb && newEvent->scheduledTime < ltpvdb->clockWakeTime)
+	{
+		ltpvdb->clockWakeTime = newEvent->scheduledTime;
+		sm_SemGive(ltpvdb->clockSemaphore);
+	}
+
+	return elt;
 }
 
-static void	cancelEvent(LtpEventType type, uvast refNbr1,
-			unsigned int refNbr2, unsigned int refNbr3)
+void	ltpRemoveTimelineEvent(Object elt)
 {
 	Sdr	sdr = getIonsdr();
-	Object	elt;
 	Object	eventObj;
+	char	key[LTP_EVENT_KEY_LEN];
+	Address	value;
+	Object	entry;
 		OBJ_POINTER(LtpEvent, event);
 
-	for (elt = sdr_list_first(sdr, (_ltpConstants())->timeline); elt;
-			elt = sdr_list_next(sdr, elt))
+	eventObj = sdr_list_data(sdr, elt);
+	GET_OBJ_POINTER(sdr, LtpEvent, event, eventObj);
+	if (eventIsIndexed(event->type))
 	{
-		eventObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, LtpEvent, event, eventObj);
-		if (event->type == type && event->refNbr1 == refNbr1
-		&& event->refNbr2 == refNbr2 && event->refNbr3 == refNbr3)
+		getEventKey(key, event->type, event->refNbr1, event->refNbr2,
+				event->refNbr3);
+		if (sdr_hash_retrieve(sdr, (_ltpConstants())->timelineIndex,
+				key, &value, &entry) == 1 && value == elt)
 		{
-			sdr_free(sdr, eventObj);
-			sdr_list_delete(sdr, elt, NULL, NULL);
-			return;
+			sdr_hash_delete_entry(sdr, entry);
 		}
 	}
+
+	sdr_free(sdr, eventObj);
+	sdr_list_delete(sdr, elt, NULL, NULL);
+}
+
+static void	cancelEvent(LtpEventType type, uvast refNbr1,
+			unsigned int refNbr2, unsigned int refNbr3)
+{
+	Sdr	sdr = getIonsdr();
+	char	key[LTP_EVENT_KEY_LEN];
+	Address	elt;
+
+	getEventKey(key, type, refNbr1, refNbr2, refNbr3);
+	if (sdr_hash_retrieve(sdr, (_ltpConstants())->timelineIndex, key,
+			&elt, NULL) == 1)
+	{
+		ltpRemoveTimelineEvent(elt);
+	}
 }
 
 /*	*	*	LTP client mgt and access functions	*	*/
@@ -2608,6 +2786,7 @@ void	clearImportSession(ImportSession *session)
 
 	if (session->blockFileRef)
 	{
+		forgetBlockFile(session->blockFileRef);
 		zco_destroy_file_ref(sdr, session->blockFileRef);
 		session->blockFileRef = 0;
 	}
@@ -2661,7 +2840,7 @@ static void	noteClosedImport(Sdr sdr, LtpSpan *span, ImportSession *session)
 	unsigned int	closedSessionNbr;
 	Object		elt2;
 	LtpEvent	event;
-	time_t		currentTime;
+	vast		currentTime;
 	LtpVspan	*vspan;
 	PsmAddress	vspanElt;
 
@@ -2711,11 +2890,11 @@ static void	noteClosedImport(Sdr sdr, LtpSpan *span, ImportSession *session)
 
 	memset((char *) &event, 0, sizeof(LtpEvent));
 	event.parm = elt2;
-	currentTime = getCtime();
+	currentTime = getCtimeMsec();
 	findSpan(span->engineId, &vspan, &vspanElt);
-	event.scheduledTime = currentTime + 10 +
+	event.scheduledTime = currentTime + 1000 * (10 +
 			(2 * (vspan->maxTimeouts / SIGNAL_REDUNDANCY)
-			* (vspan->owltOutbound + vspan->owltInbound));
+			* (vspan->owltOutbound + vspan->owltInbound)));
 	event.type = LtpForgetImportSession;
 	oK(insertLtpTimelineEvent(&event));
 }
@@ -3074,14 +3253,14 @@ static void	serializeCancelAckSegment(LtpXmitSeg *segment, char *buf)
 	/*	No content for cancel acknowledgment, just header.	*/
 }
 
-static int	setTimer(LtpTimer *timer, Address timerAddr, time_t currentSec,
+static int	setTimer(LtpTimer *timer, Address timerAddr, vast currentMsec,
 			LtpVspan *vspan, int segmentLength, LtpEvent *event)
 {
 	Sdr	sdr = getIonsdr();
 	LtpDB	ltpdb;
-	time_t	segArrivalTimeOffset = 0;
-	time_t	ackDeadlineOffset = 0;
-	int	radTime;
+	vast	segArrivalTimeOffset = 0;
+	vast	ackDeadlineOffset = 0;
+	vast	radTime;
 		OBJ_POINTER(LtpSpan, span);
 
 	if (timer->expirationCount == -1)	/*	(burst)		*/
@@ -3097,7 +3276,8 @@ static int	setTimer(LtpTimer *timer, Address timerAddr, time_t currentSec,
 	}
 	else
 	{
-		radTime = (segmentLength + EST_LINK_OHD) / vspan->localXmitRate;
+		radTime = (((vast) (segmentLength + EST_LINK_OHD)) * 1000)
+				/ vspan->localXmitRate;
 	}
 
 	/*	Segment should arrive at the remote node following
@@ -3106,10 +3286,13 @@ static int	setTimer(LtpTimer *timer, Address timerAddr, time_t currentSec,
 	 *	simply radiating all the bytes of the segment
 	 *	(including estimated link-layer overhead) at the
 	 *	current transmission rate over this span, plus
-	 *	the current outbound signal propagation time (owlt).	*/
+	 *	the current outbound signal propagation time (owlt).
+	 *	All intervals are computed in milliseconds, but half
+	 *	of ownQtime is taken in whole seconds, like ownQtime
+	 *	itself: the default one-second ownQtime adds nothing.	*/
 
-	segArrivalTimeOffset = radTime + vspan->owltOutbound
-			+ ((ltpdb.ownQtime >> 1) & 0x7fffffff);
+	segArrivalTimeOffset = radTime + (vspan->owltOutbound * 1000)
+			+ (((vast) (ltpdb.ownQtime >> 1)) * 1000);
 	GET_OBJ_POINTER(sdr, LtpSpan, span, sdr_list_data(sdr, vspan->spanElt));
 
 	/*	Following arrival of the segment, the response from
@@ -3130,17 +3313,22 @@ static int	setTimer(LtpTimer *timer, Address timerAddr, time_t currentSec,
 	 *	the remote fire rate might change, etc.).		*/
 
 	ackDeadlineOffset = segArrivalTimeOffset
-			+ span->remoteQtime + vspan->owltInbound
-			+ ((ltpdb.ownQtime >> 1) & 0x7fffffff);
-	timer->segArrivalTime = currentSec
+			+ (span->remoteQtime * 1000) + (vspan->owltInbound * 1000)
+			+ (((vast) (ltpdb.ownQtime >> 1)) * 1000);
+	timer->segArrivalTime = currentMsec
 			+ CEIL(segArrivalTimeOffset / SIGNAL_REDUNDANCY);
-	timer->ackDeadline = currentSec
-			+ CEIL(ackDeadlineOffset / SIGNAL_REDUNDANCY);
+	ackDeadlineOffset = CEIL(ackDeadlineOffset / SIGNAL_REDUNDANCY);
+	if (ackDeadlineOffset < LTP_MIN_ACK_DEADLINE)
+	{
+		ackDeadlineOffset = LTP_MIN_ACK_DEADLINE;
+	}
+
+	timer->ackDeadline = currentMsec + ackDeadlineOffset;
 #if CLOSED_EXPORTS_ENABLED
 	if (event->type == LtpForgetExportSession)
 	{
-		timer->ackDeadline = currentSec + (ackDeadlineOffset
-				* vspan->maxTimeouts / SIGNAL_REDUNDANCY);
+		timer->ackDeadline = currentMsec + (ackDeadlineOffset
+				* vspan->maxTimeouts);
 	}
 #endif
 	if (vspan->remoteXmitRate > 0)
@@ -3267,15 +3455,18 @@ static int	serializeTrailer(LtpXmitSeg *segment, char *segmentBuffer)
 	return 0;
 }
 
-int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+/*	popOutboundSegment removes the segment cited by elt from the
+ *	span's queue of outbound segments and serializes it into buf,
+ *	within the current transaction.  Returns segment length, or
+ *	zero if the segment need not be sent after all, or -1 on any
+ *	error (in which case the caller must cancel the transaction).	*/
+
+static int	popOutboundSegment(LtpVspan *vspan, Object spanObj,
+			LtpSpan *spanBuf, Object elt, char *buf)
 {
 	Sdr		sdr = getIonsdr();
 	LtpVdb		*ltpvdb = _ltpvdb(NULL);
 	LtpDB		*ltpConstants = _ltpConstants();
-	Object		spanObj;
-	LtpSpan		spanBuf;
-	Object		elt;
-	char		memo[64];
 	Object		segRefAddr;
 	XmitSegRef	segRef;
 	Object		sessionObj;
@@ -3284,46 +3475,11 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 	Object		sessionElt;
 			OBJ_POINTER(LtpReceptionClaim, claim);
 	ExportSession	xsessionBuf;
-	time_t		currentTime;
+	vast		currentTime;
 	LtpEvent	event;
 	LtpTimer	*timer;
 	ImportSession	rsessionBuf;
 
-	CHKERR(vspan);
-	CHKERR(buf);
-	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
-	CHKERR(sdr_begin_xn(sdr));
-	spanObj = sdr_list_data(sdr, vspan->spanElt);
-	sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-	elt = sdr_list_first(sdr, spanBuf.segments);
-	while (elt == 0 || vspan->localXmitRate == 0)
-	{
-		sdr_exit_xn(sdr);
-
-		/*	Wait until ltpmeter has announced an outbound
-		 *	segment by giving span's segSemaphore.		*/
-
-		if (sm_SemTake(vspan->segSemaphore) < 0)
-		{
-			putErrmsg("LSO can't take segment semaphore.",
-					itoa(vspan->engineId));
-			return -1;
-		}
-
-		if (sm_SemEnded(vspan->segSemaphore))
-		{
-			isprintf(memo, sizeof memo,
-			"[i] LSO to engine " UVAST_FIELDSPEC " is stopped.",
-					vspan->engineId);
-			writeMemo(memo);
-			return 0;
-		}
-
-		CHKERR(sdr_begin_xn(sdr));
-		sdr_stage(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-		elt = sdr_list_first(sdr, spanBuf.segments);
-	}
-
 	/*	Got next outbound segment reference.  Remove it from
 	 *	the queue for this span and delete it.			*/
 
@@ -3382,12 +3538,11 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		/*	Load client service data at the end of the
 		 *	segment first, before filling in the header.	*/
 
-		if (readFromExportBlock((*buf) + segment.pdu.headerLength
+		if (readFromExportBlock(buf + segment.pdu.headerLength
 				+ segment.pdu.ohdLength, segment.pdu.block,
 				segment.pdu.offset, segment.pdu.length) < 0)
 		{
 			putErrmsg("Can't read data from export block.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 	}
@@ -3424,7 +3579,7 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 
 	/*	Post timeout event as necessary.			*/
 
-	currentTime = getCtime();
+	currentTime = getCtimeMsec();
 	event.parm = 0;
 	switch (segment.pdu.segTypeCode)
 	{
@@ -3441,7 +3596,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 			currentTime, vspan, segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -3467,7 +3621,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 			currentTime, vspan, segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -3513,7 +3666,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -3550,7 +3702,6 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				segmentLength, &event) < 0)
 		{
 			putErrmsg("Can't schedule event.", NULL);
-			sdr_cancel_xn(sdr);
 			return -1;
 		}
 
@@ -3580,11 +3731,10 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 			{
 				putErrmsg("Can't post XmitComplete notice.",
 						NULL);
-				sdr_cancel_xn(sdr);
 				return -1;
 			}
 
-			sdr_write(sdr, spanObj, (char *) &spanBuf,
+			sdr_write(sdr, spanObj, (char *) spanBuf,
 					sizeof(LtpSpan));
 		}
 
@@ -3633,28 +3783,28 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 	if (segment.pdu.segTypeCode < 8)
 	{
 		ltpSpanTally(vspan, OUT_SEG_POPPED, segment.pdu.length);
-		serializeDataSegment(&segment, *buf);
+		serializeDataSegment(&segment, buf);
 	}
 	else
 	{
 		switch (segment.pdu.segTypeCode)
 		{
 			case 8:		/*	Report.			*/
-				serializeReportSegment(&segment, *buf);
+				serializeReportSegment(&segment, buf);
 				break;
 
 			case 9:		/*	Report acknowledgment.	*/
-				serializeReportAckSegment(&segment, *buf);
+				serializeReportAckSegment(&segment, buf);
 				break;
 
 			case 12:	/*	Cancel by sender.	*/
 			case 14:	/*	Cancel by receiver.	*/
-				serializeCancelSegment(&segment, *buf);
+				serializeCancelSegment(&segment, buf);
 				break;
 
 			case 13:	/*	Cancel acknowledgment.	*/
 			case 15:	/*	Cancel acknowledgment.	*/
-				serializeCancelAckSegment(&segment, *buf);
+				serializeCancelAckSegment(&segment, buf);
 				break;
 
 			default:
@@ -3662,9 +3812,87 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		}
 	}
 
-	if (serializeTrailer(&segment, *buf) < 0)
+	if (serializeTrailer(&segment, buf) < 0)
 	{
 		putErrmsg("Can't serialize segment trailer.", NULL);
+		return -1;
+	}
+
+	return segmentLength;
+}
+
+/*	waitForOutboundSegment blocks until the span's queue of
+ *	outbound segments is non-empty and the span is not blocked.
+ *	Returns 1, with a transaction open and the first queued
+ *	segment's list element in *elt, or 0 if the LSO is stopped,
+ *	or -1 on any error.						*/
+
+static int	waitForOutboundSegment(LtpVspan *vspan, Object spanObj,
+			LtpSpan *spanBuf, Object *elt)
+{
+	Sdr	sdr = getIonsdr();
+	char	memo[64];
+
+	CHKERR(sdr_begin_xn(sdr));
+	sdr_stage(sdr, (char *) spanBuf, spanObj, sizeof(LtpSpan));
+	*elt = sdr_list_first(sdr, spanBuf->segments);
+	while (*elt == 0 || vspan->localXmitRate == 0)
+	{
+		sdr_exit_xn(sdr);
+
+		/*	Wait until ltpmeter has announced an outbound
+		 *	segment by giving span's segSemaphore.		*/
+
+		if (sm_SemTake(vspan->segSemaphore) < 0)
+		{
+			putErrmsg("LSO can't take segment semaphore.",
+					itoa(vspan->engineId));
+			return -1;
+		}
+
+		if (sm_SemEnded(vspan->segSemaphore))
+		{
+			isprintf(memo, sizeof memo,
+			"[i] LSO to engine " UVAST_FIELDSPEC " is stopped.",
+					vspan->engineId);
+			writeMemo(memo);
+			return 0;
+		}
+
+		CHKERR(sdr_begin_xn(sdr));
+		sdr_stage(sdr, (char *) spanBuf, spanObj, sizeof(LtpSpan));
+		*elt = sdr_list_first(sdr, spanBuf->segments);
+	}
+
+	return 1;
+}
+
+int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+{
+	Sdr		sdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	Object		spanObj;
+	LtpSpan		spanBuf;
+	Object		elt;
+	int		segmentLength;
+
+	CHKERR(vspan);
+	CHKERR(buf);
+	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
+	spanObj = sdr_list_data(getIonsdr(), vspan->spanElt);
+	switch (waitForOutboundSegment(vspan, spanObj, &spanBuf, &elt))
+	{
+	case -1:
+		return -1;
+
+	case 0:
+		return 0;
+	}
+
+	segmentLength = popOutboundSegment(vspan, spanObj, &spanBuf, elt,
+			*buf);
+	if (segmentLength < 0)
+	{
 		sdr_cancel_xn(sdr);
 		return -1;
 	}
@@ -3675,7 +3903,7 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		return -1;
 	}
 
-	if (ltpvdb->watching & WATCH_g)
+	if (segmentLength > 0 && (ltpvdb->watching & WATCH_g))
 	{
 		iwatch('g');
 	}
@@ -3683,6 +3911,79 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 	return segmentLength;
 }
 
+int	ltpDequeueOutboundSegments(LtpVspan *vspan, char **bufs, int *lengths,
+		int maxCount)
+{
+	Sdr		sdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	Object		spanObj;
+	LtpSpan		spanBuf;
+	Object		elt;
+	int		segmentLength;
+	int		count = 0;
+	int		i;
+
+	/*	Dequeues as many as maxCount of the segments that are
+	 *	ready for transmission on this span, blocking only
+	 *	until the first is ready, in the scope of a single
+	 *	SDR transaction.  Each buffer in bufs must be large
+	 *	enough to hold a segment of the span's maximum size.	*/
+
+	CHKERR(vspan);
+	CHKERR(bufs);
+	CHKERR(lengths);
+	CHKERR(maxCount > 0);
+	spanObj = sdr_list_data(getIonsdr(), vspan->spanElt);
+	switch (waitForOutboundSegment(vspan, spanObj, &spanBuf, &elt))
+	{
+	case -1:
+		return -1;
+
+	case 0:
+		return 0;
+	}
+
+	while (elt && count < maxCount)
+	{
+		segmentLength = popOutboundSegment(vspan, spanObj, &spanBuf,
+				elt, bufs[count]);
+		if (segmentLength < 0)
+		{
+			sdr_cancel_xn(sdr);
+			return -1;
+		}
+
+		if (segmentLength > 0)
+		{
+			lengths[count] = segmentLength;
+			count++;
+		}
+
+		if (vspan->localXmitRate == 0)
+		{
+			break;		/*	Span is now blocked.	*/
+		}
+
+		elt = sdr_list_first(sdr, spanBuf.segments);
+	}
+
+	if (sdr_end_xn(sdr))
+	{
+		putErrmsg("Can't get outbound segments for span.", NULL);
+		return -1;
+	}
+
+	if (ltpvdb->watching & WATCH_g)
+	{
+		for (i = 0; i < count; i++)
+		{
+			iwatch('g');
+		}
+	}
+
+	return count;
+}
+
 /*	*	Control segment construction functions		*	*/
 
 static void	signalLso(unsigned int engineId)
@@ -4706,22 +5007,219 @@ putErrmsg("Opened import session.", utoa(sessionNbr));
 	return 1;	/*	Import session creation okay.		*/
 }
 
+/*	*	*	Block file writing	*	*	*/
+
+typedef struct
+{
+	Object		blockFileRef;	/*	0 if entry is vacant.	*/
+	uvast		engineId;
+	unsigned int	sessionNbr;
+	int		fd;
+	uvast		allocated;	/*	Bytes preallocated.	*/
+	unsigned int	lastUse;	/*	For LRU replacement.	*/
+} LtpBlockFdCacheEntry;
+
+/*	Each process that receives red-part data in excess of the
+ *	import session's heap buffer keeps the descriptors of the
+ *	block files it is writing open in a small LRU cache, so that
+ *	each data segment costs a single positioned write rather
+ *	than an open, a seek, a write, and a close.  Entries are
+ *	keyed by block file reference, remote engine ID, and session
+ *	number.  The cache is accessed only within SDR transactions,
+ *	so it needs no lock of its own.  A block file's entry is
+ *	dropped when its red part is complete or its session is
+ *	canceled by this process; entries for files that have been
+ *	unlinked by some other process are swept whenever a new
+ *	block file is created.						*/
+
+static LtpBlockFdCacheEntry	blockFdCache[LTP_BLOCK_FD_CACHE_SIZE];
+static unsigned int		blockFdCacheUseCount = 0;
+
+static void	vacateBlockFdCacheEntry(LtpBlockFdCacheEntry *entry)
+{
+	close(entry->fd);
+	entry->blockFileRef = 0;
+	entry->fd = -1;
+}
+
+static void	forgetBlockFile(Object blockFileRef)
+{
+	int			i;
+	LtpBlockFdCacheEntry	*entry;
+
+	for (i = 0, entry = blockFdCache; i < LTP_BLOCK_FD_CACHE_SIZE;
+			i++, entry++)
+	{
+		if (entry->blockFileRef == blockFileRef)
+		{
+			vacateBlockFdCacheEntry(entry);
+		}
+	}
+}
+
+static void	sweepBlockFdCache()
+{
+	int			i;
+	LtpBlockFdCacheEntry	*entry;
+	struct stat		statbuf;
+
+	for (i = 0, entry = blockFdCache; i < LTP_BLOCK_FD_CACHE_SIZE;
+			i++, entry++)
+	{
+		if (entry->blockFileRef == 0)
+		{
+			continue;
+		}
+
+		if (fstat(entry->fd, &statbuf) < 0 || statbuf.st_nlink == 0)
+		{
+			vacateBlockFdCacheEntry(entry);
+		}
+	}
+}
+
+/*	getBlockFile returns the cache entry for the open block file
+ *	of the indicated import session, opening the file if it is
+ *	not already open in this process.  If fd is non-negative,
+ *	it is the descriptor of the newly created block file and is
+ *	adopted.  Returns NULL on failure.				*/
+
+static LtpBlockFdCacheEntry	*getBlockFile(LtpSpan *span,
+					ImportSession *session, int fd)
+{
+	int			i;
+	LtpBlockFdCacheEntry	*entry;
+	LtpBlockFdCacheEntry	*victim = NULL;
+
+	blockFdCacheUseCount++;
+	for (i = 0, entry = blockFdCache; i < LTP_BLOCK_FD_CACHE_SIZE;
+			i++, entry++)
+	{
+		if (entry->blockFileRef == session->blockFileRef
+		&& entry->engineId == span->engineId
+		&& entry->sessionNbr == session->sessionNbr)
+		{
+			if (fd < 0)
+			{
+				entry->lastUse = blockFdCacheUseCount;
+				return entry;
+			}
+
+			vacateBlockFdCacheEntry(entry);	/*	Stale.	*/
+		}
+
+		if (victim == NULL || entry->blockFileRef == 0
+		|| (victim->blockFileRef != 0
+			&& entry->lastUse < victim->lastUse))
+		{
+			victim = entry;
+		}
+	}
+
+	if (fd < 0)
+	{
+		fd = iopen(session->fileBufferPath, O_WRONLY, 0666);
+		if (fd < 0)
+		{
+			putSysErrmsg("Can't open block file",
+					session->fileBufferPath);
+			return NULL;
+		}
+	}
+
+	if (victim->blockFileRef)
+	{
+		vacateBlockFdCacheEntry(victim);
+	}
+
+	victim->blockFileRef = session->blockFileRef;
+	victim->engineId = span->engineId;
+	victim->sessionNbr = session->sessionNbr;
+	victim->fd = fd;
+	victim->allocated = 0;
+	victim->lastUse = blockFdCacheUseCount;
+	return victim;
+}
+
+/*	Reserving the file's space ahead of the data keeps the file
+ *	from being fragmented by the arrival of segments out of
+ *	order.  FALLOC_FL_KEEP_SIZE leaves the apparent length of the
+ *	file unchanged, so the block file size noted in the session
+ *	is still the extent of the data actually received.  Failure
+ *	(e.g., on a file system that doesn't support preallocation)
+ *	is harmless.							*/
+
+static void	preallocateBlockFile(LtpBlockFdCacheEntry *entry,
+			ImportSession *session, uvast endOfIncrement)
+{
+#if defined(linux) && defined(FALLOC_FL_KEEP_SIZE)
+	uvast	target;
+
+	if (session->redPartLength > session->heapBufferSize)
+	{
+		target = session->redPartLength - session->heapBufferSize;
+	}
+	else
+	{
+		target = endOfIncrement + LTP_BLOCK_FILE_EXTENT;
+	}
+
+	if (endOfIncrement <= entry->allocated || target <= entry->allocated)
+	{
+		return;
+	}
+
+	if (fallocate(entry->fd, FALLOC_FL_KEEP_SIZE, entry->allocated,
+			target - entry->allocated) == 0)
+	{
+		entry->allocated = target;
+	}
+	else
+	{
+		entry->allocated = (uvast) -1;	/*	Don't retry.	*/
+	}
+#endif
+}
+
+static int	writeBlockFile(int fd, char *buffer, uvast offset,
+			uvast length)
+{
+#if LTP_CAN_PWRITE
+	return pwrite(fd, buffer, length, offset);
+#else
+	if (lseek(fd, offset, SEEK_SET) < 0)
+	{
+		return -1;
+	}
+
+	return write(fd, buffer, length);
+#endif
+}
+
+/*	Block files are created in the directory named by
+ *	LTP_BLOCK_FILE_DIR, if defined at compile time (e.g., a spool
+ *	directory on a volume separate from the SDR), else in the
+ *	current working directory.					*/
+
 static int	createBlockFile(LtpSpan *span, Object sessionObj,
 			ImportSession *session)
 {
 	Sdr	sdr = getIonsdr();
-	char	cwd[200];
+	char	dir[200];
 	char	name[256];
 	int	fd;
 
-	if (igetcwd(cwd, sizeof cwd) == NULL)
+#ifdef LTP_BLOCK_FILE_DIR
+	istrcpy(dir, LTP_BLOCK_FILE_DIR, sizeof dir);
+#else
+	if (igetcwd(dir, sizeof dir) == NULL)
 	{
 		putErrmsg("Can't get CWD for block file name.", NULL);
 		return -1;
 	}
-
+#endif
 	isprintf(name, sizeof name, "%s%cltpblock." UVAST_FIELDSPEC ".%u",
-			cwd, ION_PATH_DELIMITER, span->engineId,
+			dir, ION_PATH_DELIMITER, span->engineId,
 			session->sessionNbr);
 	fd = iopen(name, O_WRONLY | O_CREAT, 0666);
 	if (fd < 0)
@@ -4730,17 +5228,24 @@ static int	createBlockFile(LtpSpan *span, Object sessionObj,
 		return -1;
 	}
 
-	close(fd);
 	session->blockFileRef = zco_create_file_ref(sdr, name, "",
 			ZcoInbound);
 	if (session->blockFileRef == 0)
 	{
+		close(fd);
 		putErrmsg("Can't create block file reference.", NULL);
 		return -1;
 	}
 
 	istrcpy(session->fileBufferPath, name, sizeof session->fileBufferPath);
 	sdr_write(sdr, sessionObj, (char *) session, sizeof(ImportSession));
+	sweepBlockFdCache();
+	if (getBlockFile(span, session, fd) == NULL)
+	{
+		close(fd);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -5078,7 +5583,7 @@ static int	acceptRedContent(LtpDB *ltpdb, Object *sessionObj,
 	Object		segmentObj = 0;
 	uvast		offsetInFile;
 	uvast		endOfIncrement;
-	int		fd;
+	LtpBlockFdCacheEntry	*fdEntry;
 
 	*segUpperBound = 0;	/*	Default: discard segment.	*/
 	bytesForHeap = pdu->offset < ltpdb->maxAcqInHeap ?
@@ -5207,37 +5712,29 @@ putErrmsg("Discarded data segment: can't start new session.", itoa(sessionNbr));
 
 		/*	Now write to the reception buffer file.		*/
 
-		fd = iopen(sessionBuf->fileBufferPath, O_WRONLY, 0666);
-		if (fd < 0)
+		fdEntry = getBlockFile(span, sessionBuf, -1);
+		if (fdEntry == NULL)
 		{
-			putSysErrmsg("Can't open block file",
-					sessionBuf->fileBufferPath);
+			putErrmsg("Can't open block file.", NULL);
 			return -1;
 		}
 
-		/*	(If offsetInFile is after end of file, lseek()
-		 *	will succeed and write() will cause the file
-		 *	to be lengthened as necessary, with zeroes
-		 *	written between the old EOF and the offset
-		 *	at which we are writing.)			*/
-
-		if (lseek(fd, offsetInFile, SEEK_SET) < 0)
-		{
-			putSysErrmsg("Can't seek to offset within block file",
-					sessionBuf->fileBufferPath);
-			close(fd);
-			return -1;
-		}
+		/*	(If offsetInFile is after end of file, the
+		 *	write will cause the file to be lengthened as
+		 *	necessary, with zeroes written between the old
+		 *	EOF and the offset at which we are writing.)	*/
 
-		if (write(fd, *cursor, bytesForFile) < bytesForFile)
+		preallocateBlockFile(fdEntry, sessionBuf,
+				offsetInFile + bytesForFile);
+		if (writeBlockFile(fdEntry->fd, *cursor, offsetInFile,
+				bytesForFile) < bytesForFile)
 		{
 			putSysErrmsg("Can't write to block file",
 					sessionBuf->fileBufferPath);
-			close(fd);
+			vacateBlockFdCacheEntry(fdEntry);
 			return -1;
 		}
 
-		close(fd);
 		endOfIncrement = offsetInFile + bytesForFile;
 		if (endOfIncrement > sessionBuf->blockFileSize)
 		{
@@ -5628,7 +6125,13 @@ putErrmsg("Discarded data segment.", itoa(sessionNbr));
 			/*	The entire red part of the block has
 			 *	been received, and has not yet been
 			 *	delivered, so deliver it to the client
-			 *	service.				*/
+			 *	service.  No more of it will be written
+			 *	to the block file, if any.		*/
+
+			if (sessionBuf.blockFileRef)
+			{
+				forgetBlockFile(sessionBuf.blockFileRef);
+			}
 
 			if (queueForDelivery(pdu->clientSvcId, sourceEngineId,
 					sessionNbr) < 0)
@@ -7539,6 +8042,47 @@ int	ltpHandleInboundSegment(char *buf, int length)
 	return result;		/*	Ignore the segment.		*/
 }
 
+int	ltpHandleInboundSegments(char **bufs, int *lengths, int count)
+{
+	Sdr	sdr = getIonsdr();
+	int	i;
+
+	/*	Handles a batch of inbound segments, such as the
+	 *	datagrams acquired by a single recvmmsg() call, in
+	 *	the scope of a single SDR transaction.  Each segment
+	 *	handler's own transaction is nested within this one,
+	 *	so the cost of committing the transaction is incurred
+	 *	only once per batch rather than once per segment.	*/
+
+	CHKERR(bufs);
+	CHKERR(lengths);
+	CHKERR(count >= 0);
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	CHKERR(sdr_begin_xn(sdr));
+	for (i = 0; i < count; i++)
+	{
+		if (ltpHandleInboundSegment(bufs[i], lengths[i]) < 0)
+		{
+			putErrmsg("Can't handle segment in batch.", itoa(i));
+			sdr_cancel_xn(sdr);
+			return -1;
+		}
+	}
+
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("Can't handle batch of inbound segments.",
+				itoa(count));
+		return -1;
+	}
+
+	return 0;
+}
+
 /*	*	*	Functions that respond to events	*	*/
 
 void	ltpStartXmit(LtpVspan *vspan)
@@ -7605,16 +8149,16 @@ void	ltpStopXmit(LtpVspan *vspan)
 	}
 }
 
-static void	suspendTimer(time_t suspendTime, LtpTimer *timer,
+static void	suspendTimer(vast suspendTime, LtpTimer *timer,
 			Address timerAddr, unsigned int qTime,
 			unsigned int remoteXmitRate, LtpEventType eventType,
 			uvast eventRefNbr1, unsigned int eventRefNbr2,
 			unsigned int eventRefNbr3)
 {
-	time_t	latestAckXmitStartTime;
+	vast	latestAckXmitStartTime;
 
 	CHKVOID(ionLocked());
-	latestAckXmitStartTime = timer->segArrivalTime + qTime;
+	latestAckXmitStartTime = timer->segArrivalTime + (qTime * 1000);
 	if (latestAckXmitStartTime < suspendTime)
 	{
 		/*	Transmission of ack should have begun before
@@ -7635,7 +8179,7 @@ static void	suspendTimer(time_t suspendTime, LtpTimer *timer,
 }
 
 int	ltpSuspendTimers(LtpVspan *vspan, PsmAddress vspanElt,
-		time_t suspendTime, unsigned int priorXmitRate)
+		vast suspendTime, unsigned int priorXmitRate)
 {
 	Sdr		sdr = getIonsdr();
 	Object		spanObj;
@@ -7772,18 +8316,18 @@ int	ltpSuspendTimers(LtpVspan *vspan, PsmAddress vspanElt,
 	return 0;
 }
 
-static int	resumeTimer(time_t resumeTime, LtpTimer *timer,
+static int	resumeTimer(vast resumeTime, LtpTimer *timer,
 			Address timerAddr, unsigned int qTime,
 			unsigned int remoteXmitRate, LtpEventType eventType,
 			uvast refNbr1, unsigned int refNbr2,
 			unsigned int refNbr3)
 {
-	time_t		earliestAckXmitStartTime;
-	int		additionalDelay;
+	vast		earliestAckXmitStartTime;
+	vast		additionalDelay;
 	LtpEvent	event;
 
 	CHKERR(ionLocked());
-	earliestAckXmitStartTime = timer->segArrivalTime + qTime;
+	earliestAckXmitStartTime = timer->segArrivalTime + (qTime * 1000);
 	additionalDelay = resumeTime - earliestAckXmitStartTime;
 	if (additionalDelay > 0)
 	{
@@ -7814,7 +8358,8 @@ static int	resumeTimer(time_t resumeTime, LtpTimer *timer,
 	return 0;
 }
 
-int	ltpResumeTimers(LtpVspan *vspan, PsmAddress vspanElt, time_t resumeTime,		unsigned int remoteXmitRate)
+int	ltpResumeTimers(LtpVspan *vspan, PsmAddress vspanElt, vast resumeTime,
+		unsigned int remoteXmitRate)
 {
 	Sdr		sdr = getIonsdr();
 	Object		spanObj;
@@ -100,6 +100,35 @@ extern "C" {
 #define MAX_CLAIMS_PER_RS	20
 #endif
 
+/*	Number of slots in the LTP timeline's timing wheel, and the
+ *	span of time (in milliseconds) covered by each slot.  Events
+ *	scheduled further than one revolution of the wheel in the
+ *	future wait in their slot for later revolutions.		*/
+
+#ifndef LTP_TIMELINE_SLOTS
+#define	LTP_TIMELINE_SLOTS	(1024)
+#endif
+
+#ifndef LTP_TIMELINE_TICK
+#define	LTP_TIMELINE_TICK	(10)
+#endif
+
+/*	Minimum interval (in milliseconds) between transmission of a
+ *	checkpoint or report and its retransmission, so that timers
+ *	on spans with zero OWLT and queuing times don't expire before
+ *	any response could possibly arrive.				*/
+
+#ifndef LTP_MIN_ACK_DEADLINE
+#define	LTP_MIN_ACK_DEADLINE	(100)
+#endif
+
+/*	Maximum number of timeline events ltpclock dispatches within
+ *	a single transaction.						*/
+
+#ifndef LTP_EVENT_BATCH
+#define	LTP_EVENT_BATCH		(64)
+#endif
+
 /*	LTP segment structure definitions.				*/
 
 typedef struct
@@ -137,8 +166,8 @@ typedef enum
 
 typedef struct
 {
-	time_t			segArrivalTime;
-	time_t			ackDeadline;
+	vast			segArrivalTime;	/*	Msec.	*/
+	vast			ackDeadline;	/*	Msec.	*/
 	int			expirationCount;
 	LtpTimerState		state;
 } LtpTimer;
@@ -410,10 +439,23 @@ typedef struct
 	unsigned int	refNbr2;	/*	Session number.		*/
 	unsigned int	refNbr3;	/*	Serial number.		*/
 	Object		parm;		/*	Non-specific use.	*/
-	time_t		scheduledTime;	/*	Seconds since Jan 1970.	*/
+	vast		scheduledTime;	/*	Msec since Jan 1970.	*/
 	LtpEventType	type;
 } LtpEvent;
 
+/*	The LTP timeline is a timing wheel: an array of
+ *	LTP_TIMELINE_SLOTS lists of LtpEvents, each event residing in
+ *	the list for the slot selected by its scheduled time (in
+ *	LTP_TIMELINE_TICK units) modulo the number of slots, in
+ *	ascending scheduled time order.  So inserting an event
+ *	entails only a short search from the end of one slot's list,
+ *	and the events that are due at any time are at the starts of
+ *	the lists of the slots for the ticks that have elapsed since
+ *	the last dispatch.  Retransmission
+ *	events are additionally indexed by type and reference
+ *	numbers in timelineIndex, so that they can be canceled
+ *	without searching.						*/
+
 typedef struct
 {
 	Object		segAddr;
@@ -646,7 +688,8 @@ typedef struct
 #endif
 	Object		deadExports;	/*	SDR list: ExportSession	*/
 	Object		spans;		/*	SDR list: LtpSpan	*/
-	Object		timeline;	/*	SDR list: LtpEvent	*/
+	Object		timeline;	/*	Array of SDR lists.	*/
+	Object		timelineIndex;	/*	SDR hash: list elts	*/
 	unsigned int	maxAcqInHeap;
 	unsigned long	heapBytesReserved;
 	unsigned long	heapBytesOccupied;
@@ -683,6 +726,8 @@ typedef struct
 	sm_SemId	deliverySemaphore;
 	PsmAddress	spans;		/*	SM list: LtpVspan*	*/
 	LtpVclient	clients[LTP_MAX_NBR_OF_CLIENTS];
+	vast		clockWakeTime;	/*	Msec; for ltpclock.	*/
+	sm_SemId	clockSemaphore;	/*	Wakes ltpclock early.	*/
 } LtpVdb;
 
 extern int		ltpInit(int estMaxExportSessions);
@@ -754,14 +799,18 @@ extern int		getMaxReports(int redPartLength,
 				int asReceiver);
 
 extern int		ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf);
+extern int		ltpDequeueOutboundSegments(LtpVspan *vspan, char **bufs,
+				int *lengths, int maxCount);
 extern int		ltpHandleInboundSegment(char *buf, int length);
+extern int		ltpHandleInboundSegments(char **bufs, int *lengths,
+				int count);
 
 extern void		ltpStartXmit(LtpVspan *vspan);
 extern void		ltpStopXmit(LtpVspan *vspan);
 extern int		ltpSuspendTimers(LtpVspan *vspan, PsmAddress vspanElt,
-				time_t suspendTime, unsigned int xmitRate);
+				vast suspendTime, unsigned int xmitRate);
 extern int		ltpResumeTimers(LtpVspan *vspan, PsmAddress vspanElt,
-				time_t resumeTime, unsigned int xmitRate);
+				vast resumeTime, unsigned int xmitRate);
 
 extern int		ltpResendCheckpoint(unsigned int sessionNbr,
 				unsigned int checkpoint_serial_number);
@@ -772,6 +821,9 @@ extern int		ltpResendReport(uvast engineId,
 extern int		ltpResendRecvCancel(uvast engineId,
 				unsigned int sessionNbr);
 
+extern Object		ltpTimelineSlot(vast time);
+extern void		ltpRemoveTimelineEvent(Object elt);
+
 extern void		ltpSpanTally(LtpVspan *vspan, unsigned int idx,
 				unsigned int size);
 #if CLOSED_EXPORTS_ENABLED
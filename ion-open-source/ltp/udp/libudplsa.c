@@ -24,6 +24,9 @@ void	*udplsa_handle_datagrams(void *parm)
 	char			*buffers;
 	struct iovec		*iovecs;
 	struct mmsghdr		*msgs;
+	char			**segments;
+	int			*segmentLengths;
+	int			segmentCount;
 	unsigned int		batchLength;
 	int			i;
 
@@ -58,6 +61,29 @@ void	*udplsa_handle_datagrams(void *parm)
 		return NULL;
 	}
 
+	segments = MTAKE(sizeof(char *) * MULTIRECV_BUFFER_COUNT);
+	if (segments == NULL)
+	{
+		MRELEASE(msgs);
+		MRELEASE(iovecs);
+		MRELEASE(buffers);
+		putErrmsg("No space for segment pointer array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
+	segmentLengths = MTAKE(sizeof(int) * MULTIRECV_BUFFER_COUNT);
+	if (segmentLengths == NULL)
+	{
+		MRELEASE(segments);
+		MRELEASE(msgs);
+		MRELEASE(iovecs);
+		MRELEASE(buffers);
+		putErrmsg("No space for segment length array.", NULL);
+		ionKillMainThread(procName);
+		return NULL;
+	}
+
 	memset(msgs, 0, sizeof(struct mmsghdr) * MULTIRECV_BUFFER_COUNT);
 	for (i = 0; i < MULTIRECV_BUFFER_COUNT; i++)
 	{
@@ -87,7 +113,12 @@ void	*udplsa_handle_datagrams(void *parm)
 			continue;
 		}
 
+		/*	Collect the segments in this batch, so that
+		 *	they can all be handled in a single SDR
+		 *	transaction.					*/
+
 		buffer = buffers;
+		segmentCount = 0;
 		for (i = 0; i < batchLength; i++)
 		{
 			segmentLength = msgs[i].msg_len;
@@ -99,23 +130,27 @@ void	*udplsa_handle_datagrams(void *parm)
 				break;
 			}
 
-			if (ltpHandleInboundSegment(buffer, segmentLength) < 0)
-			{
-				putErrmsg("Can't handle inbound segment.",
-						NULL);
-				ionKillMainThread(procName);
-				rtp->running = 0;
-				break;
-			}
-
+			segments[segmentCount] = buffer;
+			segmentLengths[segmentCount] = segmentLength;
+			segmentCount++;
 			buffer += (UDPLSA_BUFSZ + 1);
 		}
 
+		if (ltpHandleInboundSegments(segments, segmentLengths,
+				segmentCount) < 0)
+		{
+			putErrmsg("Can't handle inbound segments.", NULL);
+			ionKillMainThread(procName);
+			rtp->running = 0;
+		}
+
 		/*	Make sure other tasks have a chance to run.	*/
 
 		sm_TaskYield();
 	}
 
+	MRELEASE(segmentLengths);
+	MRELEASE(segments);
 	MRELEASE(msgs);
 	MRELEASE(iovecs);
 	MRELEASE(buffers);
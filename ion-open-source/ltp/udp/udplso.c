@@ -53,26 +53,147 @@ static void	shutDownLso()	/*	Commands LSO termination.	*/
 /*	*	*	Main thread functions	*	*	*	*/
 
 #ifdef UDP_MULTISEND
-static int	sendBatch(int linkSocket, struct mmsghdr *msgs,
-			unsigned int batchLength)
+
+/*	When the kernel supports UDP generic segmentation offload,
+ *	each run of consecutive segments of equal length (the last
+ *	of which may be shorter) in a batch is passed to the kernel
+ *	as a single message, to be split into datagrams of that
+ *	length in the network stack or the NIC.				*/
+
+#ifdef UDP_SEGMENT
+#define	UDP_CAN_GSO		1
+#else
+#define	UDP_CAN_GSO		0
+#endif
+
+#ifndef UDP_GSO_MAX_SEGMENTS
+#define	UDP_GSO_MAX_SEGMENTS	(64)
+#endif
+
+#define	UDP_GSO_MAX_BYTES	(65535 - IPHDR_SIZE)
+
+#ifndef UIO_MAXIOV
+#define	UIO_MAXIOV		(1024)	/*	Linux sendmmsg limit.	*/
+#endif
+
+typedef struct
 {
-	int	totalBytesSent = 0;
-	int	bytesSent;
-	int	i;
+	int		linkSocket;
+	struct sockaddr	*peerSockName;
+	struct iovec	*iovecs;
+	struct mmsghdr	*msgs;
+	char		*controls;	/*	One cmsg per message.	*/
+	int		useGso;		/*	Boolean.		*/
+} BatchState;
+
+#if UDP_CAN_GSO
+#define	GSO_CONTROL_SIZE	(CMSG_SPACE(sizeof(uint16_t)))
+#else
+#define	GSO_CONTROL_SIZE	(0)
+#endif
+
+/*	Sends the count segments whose iovecs start at iovecs[first].
+ *	Returns total bytes transmitted, including IP and UDP header
+ *	overhead, or -1 on any error.					*/
+
+static int	sendBatch(BatchState *batch, int first, int count)
+{
+	struct iovec	*iovecs = batch->iovecs + first;
+	int		msgCount = 0;
+	struct mmsghdr	*msg;
+	int		i = 0;
+	int		run;
+	int		runBytes;
+	int		msgsSent = 0;
+	int		result;
+	int		totalBytesSent = 0;
+#if UDP_CAN_GSO
+	struct cmsghdr	*cmsg;
+#endif
 
-	if (sendmmsg(linkSocket, msgs, batchLength, 0) < 0)
+	while (i < count)
 	{
-		putSysErrmsg("Failed in sendmmsg", itoa(batchLength));
-		return -1;
+		msg = batch->msgs + msgCount;
+		memset((char *) msg, 0, sizeof(struct mmsghdr));
+		msg->msg_hdr.msg_name = batch->peerSockName;
+		msg->msg_hdr.msg_namelen = sizeof(struct sockaddr);
+		msg->msg_hdr.msg_iov = iovecs + i;
+		run = 1;
+		runBytes = iovecs[i].iov_len;
+		while (batch->useGso && i + run < count
+		&& run < UDP_GSO_MAX_SEGMENTS
+		&& iovecs[i + run].iov_len <= iovecs[i].iov_len
+		&& runBytes + iovecs[i + run].iov_len <= UDP_GSO_MAX_BYTES)
+		{
+			runBytes += iovecs[i + run].iov_len;
+			run++;
+			if (iovecs[i + run - 1].iov_len < iovecs[i].iov_len)
+			{
+				break;	/*	Short one must be last.	*/
+			}
+		}
+
+		msg->msg_hdr.msg_iovlen = run;
+#if UDP_CAN_GSO
+		if (run > 1)
+		{
+			msg->msg_hdr.msg_control = batch->controls
+					+ (msgCount * GSO_CONTROL_SIZE);
+			msg->msg_hdr.msg_controllen = GSO_CONTROL_SIZE;
+			cmsg = CMSG_FIRSTHDR(&(msg->msg_hdr));
+			cmsg->cmsg_level = SOL_UDP;
+			cmsg->cmsg_type = UDP_SEGMENT;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+			*((uint16_t *) CMSG_DATA(cmsg)) = iovecs[i].iov_len;
+		}
+#endif
+		totalBytesSent += runBytes + (run * IPHDR_SIZE);
+		i += run;
+		msgCount++;
 	}
 
-	for (i = 0; i < batchLength; i++)
+	while (msgsSent < msgCount)
 	{
-		bytesSent = msgs[i].msg_len;
-		if (bytesSent > 0)
+		result = sendmmsg(batch->linkSocket, batch->msgs + msgsSent,
+				msgCount - msgsSent, 0);
+		if (result >= 0)
+		{
+			msgsSent += result;
+			continue;
+		}
+
+		if (errno == EINTR)	/*	Interrupted.		*/
+		{
+			continue;	/*	Retry.			*/
+		}
+
+		if (errno == ENETUNREACH)
 		{
-			totalBytesSent += (IPHDR_SIZE + bytesSent);
+			break;		/*	Just data loss.		*/
 		}
+
+		if (batch->useGso && (errno == EIO || errno == EINVAL
+				|| errno == ENOPROTOOPT))
+		{
+			/*	Segmentation offload isn't available
+			 *	after all.  Send the rest of the batch
+			 *	one datagram per segment from now on.	*/
+
+			writeMemo("[i] udplso: UDP GSO is unavailable, \
+sending one datagram per segment.");
+			batch->useGso = 0;
+			i = batch->msgs[msgsSent].msg_hdr.msg_iov - batch->iovecs;
+			result = sendBatch(batch, i, (first + count) - i);
+			if (result < 0)
+			{
+				return -1;
+			}
+
+			break;
+		}
+
+		putSysErrmsg("Failed in sendmmsg", itoa(msgCount - msgsSent));
+		return -1;
 	}
 
 	return totalBytesSent;
@@ -116,6 +237,7 @@ nbytes=%d, rv=%d, errno=%d", (char *) inet_ntoa(saddr->sin_addr),
 		return bytesWritten;
 	}
 }
+#endif
 
 static unsigned long	getUsecTimestamp()
 {
@@ -200,7 +322,6 @@ static void	applyRateControl(RateControlState *rc, int bytesSent)
 	microsnooze(balanceDue);
 	rc->prevPaid = balanceDue;
 }
-#endif
 
 #if defined (ION_LWT)
 int	udplso(saddr a1, saddr a2, saddr a3, saddr a4, saddr a5,
@@ -229,24 +350,23 @@ int	main(int argc, char *argv[])
 	socklen_t		nameLength;
 	ReceiverThreadParms	rtp;
 	pthread_t		receiverThread;
-	int			segmentLength;
-	char			*segment;
 	int			bytesSent;
 	int			fd;
 	char			quit = '\0';
+	RateControlState	rc;
 #ifdef UDP_MULTISEND
 	Object			spanObj;
 	LtpSpan			spanBuf;
-	unsigned int		batchLimit;
+	int			batchLimit;
 	char			*buffers;
-	char			*buffer;
-	struct iovec		*iovecs;
-	struct iovec		*iovec;
-	struct mmsghdr		*msgs;
-	struct mmsghdr		*msg;
-	unsigned int		batchLength;
+	char			**bufs;
+	int			*lengths;
+	BatchState		batch;
+	int			batchLength;
+	int			i;
 #else
-	RateControlState	rc;
+	int			segmentLength;
+	char			*segment;
 #endif
 	if (txbps != 0 && remoteEngineId == 0)	/*	Now nominal.	*/
 	{
@@ -387,6 +507,10 @@ compatibility, but it is ignored.");
 		writeMemo(memoBuf);
 	}
 
+	rc.startTimestamp = getUsecTimestamp();
+	rc.prevPaid = 0;
+	rc.remoteEngineId = remoteEngineId;
+	rc.neighbor = NULL;
 #ifdef UDP_MULTISEND
 	spanObj = sdr_list_data(sdr, vspan->spanElt);
 	sdr_read(sdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
@@ -399,135 +523,95 @@ compatibility, but it is ignored.");
 #else
 	batchLimit = spanBuf.aggrSizeLimit / spanBuf.maxSegmentSize;
 #endif
-	buffers = MTAKE(spanBuf.maxSegmentSize * batchLimit);
-	if (buffers == NULL)
+	if (batchLimit < 1)
 	{
-		closesocket(rtp.linkSocket);
-		putErrmsg("No space for segment buffer array.", NULL);
-		return 1;
+		batchLimit = 1;
 	}
 
-	iovecs = MTAKE(sizeof(struct iovec) * batchLimit);
-	if (iovecs == NULL)
+	if (batchLimit > UIO_MAXIOV)
 	{
-		MRELEASE(buffers);
-		closesocket(rtp.linkSocket);
-		putErrmsg("No space for iovec array.", NULL);
-		return 1;
+		batchLimit = UIO_MAXIOV;
 	}
 
-	msgs = MTAKE(sizeof(struct mmsghdr) * batchLimit);
-	if (msgs == NULL)
+	buffers = MTAKE(spanBuf.maxSegmentSize * batchLimit);
+	bufs = MTAKE(sizeof(char *) * batchLimit);
+	lengths = MTAKE(sizeof(int) * batchLimit);
+	batch.iovecs = MTAKE(sizeof(struct iovec) * batchLimit);
+	batch.msgs = MTAKE(sizeof(struct mmsghdr) * batchLimit);
+	batch.controls = MTAKE(GSO_CONTROL_SIZE * batchLimit + 1);
+	if (buffers == NULL || bufs == NULL || lengths == NULL
+	|| batch.iovecs == NULL || batch.msgs == NULL
+	|| batch.controls == NULL)
 	{
-		MRELEASE(iovecs);
-		MRELEASE(buffers);
+		if (buffers) MRELEASE(buffers);
+		if (bufs) MRELEASE(bufs);
+		if (lengths) MRELEASE(lengths);
+		if (batch.iovecs) MRELEASE(batch.iovecs);
+		if (batch.msgs) MRELEASE(batch.msgs);
+		if (batch.controls) MRELEASE(batch.controls);
 		closesocket(rtp.linkSocket);
-		putErrmsg("No space for mmsghdr array.", NULL);
+		putErrmsg("No space for segment batch.", NULL);
 		return 1;
 	}
 
-	memset(msgs, 0, sizeof(struct mmsghdr) * batchLimit);
-	batchLength = 0;
-	buffer = buffers;
-	while (rtp.running && !(sm_SemEnded(vspan->segSemaphore)))
+	memset(batch.controls, 0, GSO_CONTROL_SIZE * batchLimit + 1);
+	for (i = 0; i < batchLimit; i++)
 	{
-		if (sdr_list_length(sdr, spanBuf.segments) == 0)
-		{
-			/*	No segments ready to append to batch.	*/
-
-			microsnooze(100000);	/*	Wait .1 sec.	*/
-			if (sdr_list_length(sdr, spanBuf.segments) == 0)
-			{
-				/*	Still nothing read to add to
-				 *	batch.  Send partial batch,
-				 *	if any.				*/
-
-				if (batchLength > 0)
-				{
-					bytesSent = sendBatch(rtp.linkSocket,
-							msgs, batchLength);
-					if (bytesSent < 0)
-					{
-						putErrmsg("Failed sending \
-segment batch.", NULL);
-						rtp.running = 0;
-						continue;
-					}
-
-					batchLength = 0;
-					buffer = buffers;
-
-					/*	Let other tasks run.	*/
-
-					sm_TaskYield();
-				}
-				else
-				{
-					snooze(1);
-				}
-			}
-
-			/*	Now see if a segment is waiting.	*/
-
-			continue;
-		}
+		bufs[i] = buffers + (i * spanBuf.maxSegmentSize);
+	}
 
-		/*	A segment is waiting to be appended to batch.	*/
+	batch.linkSocket = rtp.linkSocket;
+	batch.peerSockName = &peerSockName;
+	batch.useGso = UDP_CAN_GSO;
+	while (rtp.running && !(sm_SemEnded(vspan->segSemaphore)))
+	{
+		/*	Dequeue all segments that are ready for
+		 *	transmission, up to the batch limit, in a
+		 *	single transaction.				*/
 
-		segmentLength = ltpDequeueOutboundSegment(vspan, &segment);
-		if (segmentLength < 0)
+		batchLength = ltpDequeueOutboundSegments(vspan, bufs, lengths,
+				batchLimit);
+		if (batchLength < 0)
 		{
 			rtp.running = 0;	/*	Terminate LSO.	*/
 			continue;
 		}
 
-		if (segmentLength == 0)		/*	Interrupted.	*/
+		if (batchLength == 0)		/*	Interrupted.	*/
 		{
 			continue;
 		}
 
-		/*	Append this segment to current batch.		*/
+		for (i = 0; i < batchLength; i++)
+		{
+			batch.iovecs[i].iov_base = bufs[i];
+			batch.iovecs[i].iov_len = lengths[i];
+		}
 
-		memcpy(buffer, segment, segmentLength);
-		iovec = iovecs + batchLength;
-		iovec->iov_base = buffer;
-		iovec->iov_len = segmentLength;
-		msg = msgs + batchLength;
-		msg->msg_hdr.msg_name = (struct sockaddr *) peerInetName;
-		msg->msg_hdr.msg_namelen = sizeof(struct sockaddr);
-		msg->msg_hdr.msg_iov = iovec;
-		msg->msg_hdr.msg_iovlen = 1;
-		batchLength++;
-		buffer += spanBuf.maxSegmentSize;
-		if (batchLength >= batchLimit)
+		bytesSent = sendBatch(&batch, 0, batchLength);
+		if (bytesSent < 0)
 		{
-			bytesSent = sendBatch(rtp.linkSocket, msgs,
-					batchLength);
-			if (bytesSent < 0)
-			{
-				putErrmsg("Failed sending segment batch.",
-						NULL);
-				rtp.running = 0;
-				continue;
-			}
+			putErrmsg("Failed sending segment batch.", NULL);
+			rtp.running = 0;	/*	Terminate LSO.	*/
+			continue;
+		}
+
+		/*	Pay for the whole batch at once.		*/
 
-			batchLength = 0;
-			buffer = buffers;
+		applyRateControl(&rc, bytesSent);
 
-			/*	Let other tasks run.			*/
+		/*	Let other tasks run.				*/
 
-			sm_TaskYield();
-		}
+		sm_TaskYield();
 	}
 
-	MRELEASE(msgs);
-	MRELEASE(iovecs);
+	MRELEASE(batch.controls);
+	MRELEASE(batch.msgs);
+	MRELEASE(batch.iovecs);
+	MRELEASE(lengths);
+	MRELEASE(bufs);
 	MRELEASE(buffers);
 #else
-	rc.startTimestamp = getUsecTimestamp();
-	rc.prevPaid = 0;
-	rc.remoteEngineId = remoteEngineId;
-	rc.neighbor = NULL;
 	while (rtp.running && !(sm_SemEnded(vspan->segSemaphore)))
 	{
 		segmentLength = ltpDequeueOutboundSegment(vspan, &segment);
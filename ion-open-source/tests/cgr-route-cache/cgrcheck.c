@@ -0,0 +1,155 @@
+/*
+
+	cgr-route-cache/cgrcheck.c:	Checks that forwarding decisions
+					cached by CGR are reused while
+					the contact plan is unchanged and
+					are discarded when contacts are
+					revised in place, as by contact
+					discovery.
+
+									*/
+
+#include "bpP.h"
+#include "cgr.h"
+#include "check.h"
+
+static uvast	firstHop(IonNode *terminus, Bundle *bundle)
+{
+	Sdr		sdr = getIonsdr();
+	Lyst		bestRoutes;
+	Lyst		excludedNodes;
+	CgrRoute	*route;
+	uvast		hop = 0;
+
+	bestRoutes = lyst_create_using(getIonMemoryMgr());
+	excludedNodes = lyst_create_using(getIonMemoryMgr());
+	fail_unless(bestRoutes != NULL && excludedNodes != NULL);
+	fail_unless(sdr_begin_xn(sdr));
+	fail_unless(cgr_identify_best_routes(terminus, bundle, excludedNodes,
+			getCtime(), NULL, NULL, bestRoutes) >= 0);
+	if (lyst_length(bestRoutes) > 0)
+	{
+		route = (CgrRoute *) lyst_data(lyst_first(bestRoutes));
+		hop = route->toNodeNbr;
+	}
+
+	fail_unless(sdr_end_xn(sdr) >= 0);
+	lyst_destroy(excludedNodes);
+	lyst_destroy(bestRoutes);
+	return hop;
+}
+
+static CgrDecision	*onlyDecision(IonNode *terminus)
+{
+	PsmPartition	ionwm = getIonwm();
+	CgrRtgObject	*routingObj;
+
+	routingObj = (CgrRtgObject *) psp(ionwm, terminus->routingObject);
+	fail_unless(routingObj->decisions != 0);
+	fail_unless(sm_list_length(ionwm, routingObj->decisions) == 1);
+	return (CgrDecision *) psp(ionwm, sm_list_data(ionwm,
+			sm_list_first(ionwm, routingObj->decisions)));
+}
+
+static void	reviseContactRate(uvast fromNode, uvast toNode,
+			unsigned int xmitRate)
+{
+	Sdr		sdr = getIonsdr();
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
+	IonCXref	arg;
+	PsmAddress	elt;
+	IonCXref	*cxref;
+	Object		contactObj;
+	IonContact	contact;
+
+	/*	Revise the contact in place, the way contact
+	 *	discovery does, rather than through rfx.		*/
+
+	memset((char *) &arg, 0, sizeof(IonCXref));
+	arg.fromNode = fromNode;
+	arg.toNode = toNode;
+	fail_unless(sdr_begin_xn(sdr));
+	oK(sm_rbt_search(ionwm, ionvdb->contactIndex, rfx_order_contacts,
+			&arg, &elt));
+	fail_unless(elt != 0);
+	cxref = (IonCXref *) psp(ionwm, sm_rbt_data(ionwm, elt));
+	fail_unless(cxref->fromNode == fromNode && cxref->toNode == toNode);
+	contactObj = sdr_list_data(sdr, cxref->contactElt);
+	sdr_stage(sdr, (char *) &contact, contactObj, sizeof(IonContact));
+	contact.xmitRate = xmitRate;
+	sdr_write(sdr, contactObj, (char *) &contact, sizeof(IonContact));
+	cxref->xmitRate = xmitRate;
+	rfx_contacts_revised();
+	fail_unless(sdr_end_xn(sdr) >= 0);
+}
+
+int	main(int argc, char **argv)
+{
+	Sdr		sdr;
+	IonVdb		*ionvdb;
+	IonNode		*terminus;
+	PsmAddress	nextNode;
+	Bundle		bundle;
+	CgrDecision	*decision;
+	unsigned int	planVersion;
+	PsmAddress	routeAddr;
+
+	fail_unless(bp_attach() >= 0);
+	sdr = getIonsdr();
+	ionvdb = getIonVdb();
+	cgr_start();
+	fail_unless(sdr_begin_xn(sdr));
+	terminus = findNode(ionvdb, 3, &nextNode);
+	fail_unless(terminus != NULL);
+	if (terminus->routingObject == 0)
+	{
+		fail_unless(cgr_create_routing_object(terminus) == 0);
+	}
+
+	sdr_exit_xn(sdr);
+
+	/*	A 1000-byte bundle to node 3 that must arrive within
+	 *	60 seconds.  The route through node 2 arrives about
+	 *	2 seconds after transmission, the route through node
+	 *	4 about 11 seconds after transmission.			*/
+
+	memset((char *) &bundle, 0, sizeof(Bundle));
+	bundle.payload.length = 1000;
+	bundle.priority = BP_STD_PRIORITY;
+	bundle.expirationTime = (getCtime() - EPOCH_2000_SEC) + 60;
+
+	/*	First decision is made by full route selection and
+	 *	is cached.						*/
+
+	fail_unless(firstHop(terminus, &bundle) == 2);
+	decision = onlyDecision(terminus);
+	planVersion = ionvdb->planVersion;
+	fail_unless(decision->planVersion == planVersion);
+	routeAddr = decision->routeAddr;
+
+	/*	Contact plan is unchanged, so the cached decision is
+	 *	reused as is.						*/
+
+	fail_unless(firstHop(terminus, &bundle) == 2);
+	decision = onlyDecision(terminus);
+	fail_unless(decision->planVersion == planVersion);
+	fail_unless(decision->routeAddr == routeAddr);
+
+	/*	Slow the contact from node 1 to node 2 so much that
+	 *	the bundle can no longer arrive in time via node 2.
+	 *	The in-place revision must change the contact plan
+	 *	version, and the new decision must be recorded
+	 *	against the new version.				*/
+
+	reviseContactRate(1, 2, 10);
+	fail_unless(ionvdb->planVersion != planVersion);
+	fail_unless(firstHop(terminus, &bundle) == 4);
+	decision = onlyDecision(terminus);
+	fail_unless(decision->planVersion == ionvdb->planVersion);
+	fail_unless(decision->routeAddr != routeAddr);
+
+	writeErrmsgMemos();
+	bp_detach();
+	CHECK_FINISH;
+}
@@ -0,0 +1,119 @@
+/*
+
+	cgr-spur-routes/routecheck.c:	Checks that CGR finds every route
+					to a node, and that the toTime and
+					arrivalConfidence of each route
+					found as a spur of another route
+					characterize the trunk of the
+					route as well as the spur.
+
+									*/
+
+#include "bpP.h"
+#include "cgr.h"
+#include "check.h"
+
+#define	ROUTES_TEXT_LEN	(4096)
+
+/*	Every route from node 1 to node 5, in the order in which the
+ *	routes are computed: the end of each route's transmission
+ *	window and its best-case arrival time, relative to the start
+ *	of the contacts and to the current time respectively, then
+ *	the route's delivery confidence and its hops.			*/
+
+static char	*expectedRoutes =
+	"3000 2 0.900: 1>2 2>5\n"
+	"2900 2 0.600: 1>3 3>5\n"
+	"2900 3 0.432: 1>2 2>3 3>5\n"
+	"3000 3 1.000: 1>3 3>2 2>5\n"
+	"2800 3 0.630: 1>2 2>4 4>5\n"
+	"2800 3 1.000: 1>3 3>4 4>5\n"
+	"3000 4 0.720: 1>2 2>3 3>2 2>5\n"
+	"2900 4 0.480: 1>3 3>2 2>3 3>5\n"
+	"2800 4 0.720: 1>2 2>3 3>4 4>5\n"
+	"2800 4 0.700: 1>3 3>2 2>4 4>5\n"
+	"2800 5 0.504: 1>2 2>3 3>2 2>4 4>5\n"
+	"2800 5 0.800: 1>3 3>2 2>3 3>4 4>5\n";
+
+static void	printRoutes(PsmPartition ionwm, PsmAddress routes,
+			time_t currentTime, char *text, int bufSize)
+{
+	PsmAddress	elt;
+	CgrRoute	*route;
+	PsmAddress	elt2;
+	IonCXref	*contact;
+	int		len;
+
+	for (elt = sm_list_first(ionwm, routes); elt;
+			elt = sm_list_next(ionwm, elt))
+	{
+		route = (CgrRoute *) psp(ionwm, sm_list_data(ionwm, elt));
+		len = strlen(text);
+		isprintf(text + len, bufSize - len, "%ld %ld %.3f:",
+				(long) (route->toTime - route->fromTime),
+				(long) (route->arrivalTime - currentTime),
+				route->arrivalConfidence);
+		for (elt2 = sm_list_first(ionwm, route->hops); elt2;
+				elt2 = sm_list_next(ionwm, elt2))
+		{
+			contact = (IonCXref *) psp(ionwm,
+					sm_list_data(ionwm, elt2));
+			len = strlen(text);
+			isprintf(text + len, bufSize - len, " " UVAST_FIELDSPEC
+					">" UVAST_FIELDSPEC, contact->fromNode,
+					contact->toNode);
+		}
+
+		len = strlen(text);
+		istrcpy(text + len, "\n", bufSize - len);
+	}
+}
+
+int	main(int argc, char **argv)
+{
+	Sdr		sdr;
+	PsmPartition	ionwm;
+	time_t		currentTime;
+	Bundle		bundle;
+	IonNode		*terminus;
+	PsmAddress	nextNode;
+	CgrRtgObject	*routingObj;
+	char		routes[ROUTES_TEXT_LEN];
+
+	fail_unless(bp_attach() >= 0);
+	cgr_start();
+	sdr = getIonsdr();
+	ionwm = getIonwm();
+	currentTime = getCtime();
+	memset((char *) &bundle, 0, sizeof(Bundle));
+	bundle.payload.length = 1000;
+	bundle.priority = BP_STD_PRIORITY;
+	bundle.expirationTime = currentTime - EPOCH_2000_SEC;
+
+	/*	Since the bundle's deadline is already past, every
+	 *	route is rejected and route computation continues
+	 *	until no more routes are found.				*/
+
+	fail_unless(sdr_begin_xn(sdr));
+	fail_unless(cgr_preview_forward(5, &bundle, currentTime, NULL, NULL)
+			== 0);
+	terminus = findNode(getIonVdb(), 5, &nextNode);
+	fail_unless(terminus != NULL);
+	routingObj = (CgrRtgObject *) psp(ionwm, terminus->routingObject);
+	fail_unless(routingObj != NULL);
+	routes[0] = '\0';
+	printRoutes(ionwm, routingObj->selectedRoutes, currentTime, routes,
+			sizeof routes);
+	printRoutes(ionwm, routingObj->knownRoutes, currentTime, routes,
+			sizeof routes);
+	fail_unless(sdr_end_xn(sdr) >= 0);
+	if (strcmp(routes, expectedRoutes) != 0)
+	{
+		printf("Routes computed:\n%s", routes);
+	}
+
+	fail_unless(strcmp(routes, expectedRoutes) == 0);
+	writeErrmsgMemos();
+	bp_detach();
+	CHECK_FINISH;
+}
@@ -0,0 +1,157 @@
+/*
+
+	cgr-spur-workers/spurcheck.c:	Checks that the routes computed
+					by CGR built with CGR_SPUR_WORKERS
+					nonzero, with spur routes searched
+					by worker threads, are the same as
+					the routes computed with all spur
+					routes searched serially.
+
+									*/
+
+#include "bpP.h"
+#include "cgr.h"
+#include "check.h"
+
+#define	ROUTE_COUNT	(12)
+#define	ROUTES_TEXT_LEN	(4096)
+
+static void	ignoreTracepoint(void *data, unsigned int lineNbr,
+			CgrTraceType traceType, ...)
+{
+	return;
+}
+
+static void	checkRoute(PsmPartition ionwm, CgrRoute *route)
+{
+	PsmAddress	elt;
+	IonCXref	*contact;
+	time_t		toTime = MAX_TIME;
+	float		confidence = 1.0;
+
+	/*	A route's toTime and arrivalConfidence characterize
+	 *	all hops of the route, including any hops grafted
+	 *	from the trunk of the route it branched from.		*/
+
+	for (elt = sm_list_first(ionwm, route->hops); elt;
+			elt = sm_list_next(ionwm, elt))
+	{
+		contact = (IonCXref *) psp(ionwm, sm_list_data(ionwm, elt));
+		fail_unless(contact != NULL);
+		if (contact->toTime < toTime)
+		{
+			toTime = contact->toTime;
+		}
+
+		confidence *= contact->confidence;
+	}
+
+	fail_unless(route->toTime == toTime);
+	fail_unless(route->arrivalConfidence > confidence - 0.001
+			&& route->arrivalConfidence < confidence + 0.001);
+}
+
+static int	printRoutes(PsmPartition ionwm, PsmAddress routes, char *text,
+			int bufSize)
+{
+	int		count = 0;
+	PsmAddress	elt;
+	CgrRoute	*route;
+	PsmAddress	elt2;
+	IonCXref	*contact;
+	int		len;
+
+	for (elt = sm_list_first(ionwm, routes); elt;
+			elt = sm_list_next(ionwm, elt))
+	{
+		route = (CgrRoute *) psp(ionwm, sm_list_data(ionwm, elt));
+		checkRoute(ionwm, route);
+		len = strlen(text);
+		isprintf(text + len, bufSize - len, "%lu %lu %lu %.3f:",
+				(unsigned long) route->fromTime,
+				(unsigned long) route->toTime,
+				(unsigned long) route->arrivalTime,
+				route->arrivalConfidence);
+		for (elt2 = sm_list_first(ionwm, route->hops); elt2;
+				elt2 = sm_list_next(ionwm, elt2))
+		{
+			contact = (IonCXref *) psp(ionwm,
+					sm_list_data(ionwm, elt2));
+			len = strlen(text);
+			isprintf(text + len, bufSize - len, " " UVAST_FIELDSPEC
+					">" UVAST_FIELDSPEC, contact->fromNode,
+					contact->toNode);
+		}
+
+		len = strlen(text);
+		istrcpy(text + len, "\n", bufSize - len);
+		count++;
+	}
+
+	return count;
+}
+
+static int	computeRoutes(Bundle *bundle, time_t currentTime,
+			CgrTrace *trace, char *text, int bufSize)
+{
+	Sdr		sdr = getIonsdr();
+	PsmPartition	ionwm = getIonwm();
+	IonNode		*terminus;
+	PsmAddress	nextNode;
+	CgrRtgObject	*routingObj;
+	int		count;
+
+	/*	Discard all routes previously computed, then compute
+	 *	every route to node 5: since the bundle's deadline
+	 *	is already past, every route is rejected and route
+	 *	computation continues until no more routes are found.	*/
+
+	*text = '\0';
+	fail_unless(sdr_begin_xn(sdr));
+	cgr_clear_vdb(cgr_get_vdb());
+	fail_unless(cgr_preview_forward(5, bundle, currentTime, NULL, trace)
+			== 0);
+	terminus = findNode(getIonVdb(), 5, &nextNode);
+	fail_unless(terminus != NULL);
+	routingObj = (CgrRtgObject *) psp(ionwm, terminus->routingObject);
+	fail_unless(routingObj != NULL);
+	count = printRoutes(ionwm, routingObj->selectedRoutes, text, bufSize);
+	count += printRoutes(ionwm, routingObj->knownRoutes, text, bufSize);
+	fail_unless(sdr_end_xn(sdr) >= 0);
+	return count;
+}
+
+int	main(int argc, char **argv)
+{
+	time_t		currentTime;
+	Bundle		bundle;
+	CgrTrace	trace;
+	char		serialRoutes[ROUTES_TEXT_LEN];
+	char		parallelRoutes[ROUTES_TEXT_LEN];
+
+	fail_unless(bp_attach() >= 0);
+	cgr_start();
+	currentTime = getCtime();
+	memset((char *) &bundle, 0, sizeof(Bundle));
+	bundle.payload.length = 1000;
+	bundle.priority = BP_STD_PRIORITY;
+	bundle.expirationTime = currentTime - EPOCH_2000_SEC;
+
+	/*	Spur routes are always computed serially when route
+	 *	computation is traced.					*/
+
+	trace.fn = ignoreTracepoint;
+	trace.data = NULL;
+	fail_unless(computeRoutes(&bundle, currentTime, &trace, serialRoutes,
+			sizeof serialRoutes) == ROUTE_COUNT);
+
+	/*	Otherwise they are computed by the worker threads.	*/
+
+	fail_unless(computeRoutes(&bundle, currentTime, NULL, parallelRoutes,
+			sizeof parallelRoutes) == ROUTE_COUNT);
+	fail_unless(strcmp(serialRoutes, parallelRoutes) == 0);
+
+	writeErrmsgMemos();
+	bp_detach();
+	CHECK_FINISH;
+}
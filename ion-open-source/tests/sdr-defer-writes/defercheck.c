@@ -0,0 +1,137 @@
+/*
+
+	sdr-defer-writes/defercheck.c:	Checks that an SDR configured with
+					SDR_DEFER_WRITES updates its
+					dataspace file only when each
+					transaction ends, that the file is
+					then identical to the DRAM copy of
+					the dataspace, and that a canceled
+					transaction leaves both copies
+					unchanged.
+
+									*/
+
+#include "sdr.h"
+#include "check.h"
+
+#define	SDR_NAME	"defercheck"
+#define	SDR_FLAGS	(SDR_IN_DRAM | SDR_IN_FILE | SDR_REVERSIBLE \
+				| SDR_DEFER_WRITES)
+#define	DS_FILE_NAME	"./defercheck.sdr"
+#define	HEAP_WORDS	(100000)
+#define	WM_SIZE		(1000000)
+#define	OBJ_SIZE	(1024)
+#define	GAP_SIZE	(8192)
+
+static Sdr	sdr;
+
+static void	readFile(char *buffer, Address from, size_t length)
+{
+	int	fd;
+
+	fd = iopen(DS_FILE_NAME, O_RDONLY, 0);
+	fail_unless(fd >= 0);
+	fail_unless(lseek(fd, from, SEEK_SET) == from);
+	fail_unless(read(fd, buffer, length) == length);
+	close(fd);
+}
+
+static int	fileHolds(Address obj, char fill)
+{
+	char	buffer[OBJ_SIZE];
+	char	expected[OBJ_SIZE];
+
+	readFile(buffer, obj, OBJ_SIZE);
+	memset(expected, fill, OBJ_SIZE);
+	return (memcmp(buffer, expected, OBJ_SIZE) == 0);
+}
+
+static int	dramHolds(Address obj, char fill)
+{
+	char	buffer[OBJ_SIZE];
+	char	expected[OBJ_SIZE];
+
+	sdr_read(sdr, buffer, obj, OBJ_SIZE);
+	memset(expected, fill, OBJ_SIZE);
+	return (memcmp(buffer, expected, OBJ_SIZE) == 0);
+}
+
+static int	fileMatchesDram()
+{
+	struct stat	statbuf;
+	char		*fileImage;
+	char		*dramImage;
+	int		result;
+
+	fail_unless(stat(DS_FILE_NAME, &statbuf) == 0);
+	fileImage = malloc(statbuf.st_size);
+	dramImage = malloc(statbuf.st_size);
+	fail_unless(fileImage != NULL && dramImage != NULL);
+	readFile(fileImage, 0, statbuf.st_size);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_read(sdr, dramImage, 0, statbuf.st_size);
+	sdr_exit_xn(sdr);
+	result = (memcmp(fileImage, dramImage, statbuf.st_size) == 0);
+	free(fileImage);
+	free(dramImage);
+	return result;
+}
+
+int	main(int argc, char **argv)
+{
+	Object	obj1;
+	Object	obj2;
+	char	data[OBJ_SIZE];
+
+	fail_unless(sdr_initialize(WM_SIZE, NULL, SM_NO_KEY, NULL) == 0);
+	fail_unless(sdr_load_profile(SDR_NAME, SDR_FLAGS, HEAP_WORDS,
+			SM_NO_KEY, 0, SM_NO_KEY, ".", NULL) == 0);
+	sdr = sdr_start_using(SDR_NAME);
+	fail_unless(sdr != NULL);
+
+	/*	Two objects far enough apart that their updates are
+	 *	written to the file separately.				*/
+
+	fail_unless(sdr_begin_xn(sdr));
+	obj1 = sdr_malloc(sdr, OBJ_SIZE);
+	fail_unless(sdr_malloc(sdr, GAP_SIZE) != 0);
+	obj2 = sdr_malloc(sdr, OBJ_SIZE);
+	fail_unless(obj1 != 0 && obj2 != 0);
+	memset(data, 0, OBJ_SIZE);
+	sdr_write(sdr, obj1, data, OBJ_SIZE);
+	sdr_write(sdr, obj2, data, OBJ_SIZE);
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(fileMatchesDram());
+
+	/*	Within the transaction only the DRAM copy changes;
+	 *	the file is written when the transaction ends.		*/
+
+	memset(data, 'A', OBJ_SIZE);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_write(sdr, obj1, data, OBJ_SIZE);
+	sdr_write(sdr, obj2, data, OBJ_SIZE);
+	fail_unless(dramHolds(obj1, 'A') && dramHolds(obj2, 'A'));
+	fail_unless(fileHolds(obj1, 0) && fileHolds(obj2, 0));
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(fileHolds(obj1, 'A') && fileHolds(obj2, 'A'));
+	fail_unless(fileMatchesDram());
+
+	/*	A canceled transaction never reaches the file, and
+	 *	its changes to the DRAM copy are reversed.		*/
+
+	memset(data, 'B', OBJ_SIZE);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_write(sdr, obj1, data, OBJ_SIZE);
+	fail_unless(fileHolds(obj1, 'A'));
+	sdr_cancel_xn(sdr);
+	fail_unless(sdr_begin_xn(sdr));
+	fail_unless(dramHolds(obj1, 'A'));
+	sdr_exit_xn(sdr);
+	fail_unless(fileHolds(obj1, 'A'));
+	fail_unless(fileMatchesDram());
+
+	writeErrmsgMemos();
+	sdr_destroy(sdr);
+	sdr_shutdown();
+	CHECK_FINISH;
+}
@@ -0,0 +1,137 @@
+/*
+
+	sdr-map-file/mapcheck.c:	Checks that an SDR configured with
+					SDR_MAP_FILE keeps a single copy of
+					its dataspace, in the mapped file:
+					data written by sdr_write is in the
+					file before the transaction ends,
+					data written to the file is read
+					back by sdr_read, a canceled
+					transaction is reversed in the
+					file, and the data survive a
+					re-load of the SDR's profile.
+
+									*/
+
+#include "sdr.h"
+#include "check.h"
+
+#define	SDR_NAME	"mapcheck"
+#define	SDR_FLAGS	(SDR_IN_DRAM | SDR_IN_FILE | SDR_REVERSIBLE \
+				| SDR_MAP_FILE)
+#define	DS_FILE_NAME	"./mapcheck.sdr"
+#define	HEAP_WORDS	(100000)
+#define	WM_SIZE		(1000000)
+#define	OBJ_SIZE	(1024)
+
+static Sdr	sdr;
+
+static int	fileHolds(Address obj, char fill)
+{
+	int	fd;
+	char	buffer[OBJ_SIZE];
+	char	expected[OBJ_SIZE];
+
+	fd = iopen(DS_FILE_NAME, O_RDONLY, 0);
+	fail_unless(fd >= 0);
+	fail_unless(lseek(fd, obj, SEEK_SET) == obj);
+	fail_unless(read(fd, buffer, OBJ_SIZE) == OBJ_SIZE);
+	close(fd);
+	memset(expected, fill, OBJ_SIZE);
+	return (memcmp(buffer, expected, OBJ_SIZE) == 0);
+}
+
+static void	fillFile(Address obj, char fill)
+{
+	int	fd;
+	char	buffer[OBJ_SIZE];
+
+	fd = iopen(DS_FILE_NAME, O_WRONLY, 0);
+	fail_unless(fd >= 0);
+	memset(buffer, fill, OBJ_SIZE);
+	fail_unless(lseek(fd, obj, SEEK_SET) == obj);
+	fail_unless(write(fd, buffer, OBJ_SIZE) == OBJ_SIZE);
+	close(fd);
+}
+
+static int	sdrHolds(Address obj, char fill)
+{
+	char	buffer[OBJ_SIZE];
+	char	expected[OBJ_SIZE];
+
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_read(sdr, buffer, obj, OBJ_SIZE);
+	sdr_exit_xn(sdr);
+	memset(expected, fill, OBJ_SIZE);
+	return (memcmp(buffer, expected, OBJ_SIZE) == 0);
+}
+
+static int	loadProfile(int reload)
+{
+	if (reload)
+	{
+		return sdr_reload_profile(SDR_NAME, SDR_FLAGS, HEAP_WORDS,
+				SM_NO_KEY, 0, SM_NO_KEY, ".", NULL);
+	}
+
+	return sdr_load_profile(SDR_NAME, SDR_FLAGS, HEAP_WORDS, SM_NO_KEY,
+			0, SM_NO_KEY, ".", NULL);
+}
+
+int	main(int argc, char **argv)
+{
+	Object	obj1;
+	Object	obj2;
+	char	data[OBJ_SIZE];
+
+	fail_unless(sdr_initialize(WM_SIZE, NULL, SM_NO_KEY, NULL) == 0);
+	fail_unless(loadProfile(0) == 0);
+	sdr = sdr_start_using(SDR_NAME);
+	fail_unless(sdr != NULL);
+	fail_unless(sdr_begin_xn(sdr));
+	obj1 = sdr_malloc(sdr, OBJ_SIZE);
+	obj2 = sdr_malloc(sdr, OBJ_SIZE);
+	fail_unless(obj1 != 0 && obj2 != 0);
+	fail_unless(sdr_end_xn(sdr) == 0);
+
+	/*	sdr_write modifies the file itself, before the
+	 *	transaction ends.					*/
+
+	memset(data, 'A', OBJ_SIZE);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_write(sdr, obj1, data, OBJ_SIZE);
+	fail_unless(fileHolds(obj1, 'A'));
+	fail_unless(sdr_end_xn(sdr) == 0);
+	fail_unless(fileHolds(obj1, 'A'));
+
+	/*	There is no other copy of the data: what is written
+	 *	to the file is what sdr_read returns.			*/
+
+	fillFile(obj2, 'C');
+	fail_unless(sdrHolds(obj2, 'C'));
+
+	/*	Reversal of a canceled transaction restores the file.	*/
+
+	memset(data, 'B', OBJ_SIZE);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_write(sdr, obj1, data, OBJ_SIZE);
+	fail_unless(fileHolds(obj1, 'B'));
+	sdr_cancel_xn(sdr);
+	fail_unless(fileHolds(obj1, 'A'));
+	fail_unless(sdrHolds(obj1, 'A'));
+
+	/*	The data are still in place after the profile is
+	 *	re-loaded, as on restart.				*/
+
+	sdr_stop_using(sdr);
+	fail_unless(loadProfile(1) == 0);
+	sdr = sdr_start_using(SDR_NAME);
+	fail_unless(sdr != NULL);
+	fail_unless(sdrHolds(obj1, 'A'));
+	fail_unless(sdrHolds(obj2, 'C'));
+
+	writeErrmsgMemos();
+	sdr_destroy(sdr);
+	sdr_shutdown();
+	CHECK_FINISH;
+}
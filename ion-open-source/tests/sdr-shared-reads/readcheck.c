@@ -0,0 +1,193 @@
+/*
+
+	sdr-shared-reads/readcheck.c:	Checks that read-only transactions
+					on an SDR configured with
+					SDR_SHARED_READS run concurrently
+					with one another but not with
+					update transactions, that a waiting
+					update keeps new readers out, and
+					that re-loading the SDR's profile
+					recovers from a reader that was
+					killed in mid-transaction.
+
+									*/
+
+#include "sdr.h"
+#include "check.h"
+#include <sys/wait.h>
+
+#define	SDR_NAME	"readcheck"
+#define	SDR_FLAGS	(SDR_IN_DRAM | SDR_SHARED_READS)
+#define	HEAP_WORDS	(100000)
+#define	WM_SIZE		(1000000)
+
+typedef struct
+{
+	int		update;		/*	Boolean.		*/
+	volatile int	began;		/*	Boolean.		*/
+	volatile int	release;	/*	Boolean.		*/
+	pthread_t	thread;
+} XnTask;
+
+static Sdr	sdr;
+
+static void	*xnMain(void *parm)
+{
+	XnTask	*task = (XnTask *) parm;
+	int	result;
+
+	if (task->update)
+	{
+		result = sdr_begin_xn(sdr);
+	}
+	else
+	{
+		result = sdr_begin_read_xn(sdr);
+	}
+
+	if (result == 0)
+	{
+		return NULL;
+	}
+
+	task->began = 1;
+	while (!task->release)
+	{
+		microsnooze(10000);
+	}
+
+	sdr_exit_xn(sdr);
+	return NULL;
+}
+
+static void	startXn(XnTask *task, int update)
+{
+	memset((char *) task, 0, sizeof(XnTask));
+	task->update = update;
+	fail_unless(pthread_begin(&task->thread, NULL, xnMain, task,
+			"readcheck") == 0);
+}
+
+static int	began(XnTask *task, int seconds)
+{
+	int	polls = seconds * 100;
+
+	while (!task->began && polls > 0)
+	{
+		microsnooze(10000);
+		polls--;
+	}
+
+	return task->began;
+}
+
+static void	endXn(XnTask *task)
+{
+	task->release = 1;
+	pthread_join(task->thread, NULL);
+}
+
+static int	loadProfile()
+{
+	return sdr_load_profile(SDR_NAME, SDR_FLAGS, HEAP_WORDS, SM_NO_KEY,
+			0, SM_NO_KEY, ".", NULL);
+}
+
+static int	killedReader()
+{
+	/*	Begins a read-only transaction and is killed before
+	 *	the transaction ends.					*/
+
+	if (sdr_initialize(WM_SIZE, NULL, SM_NO_KEY, NULL) < 0
+	|| (sdr = sdr_start_using(SDR_NAME)) == NULL
+	|| sdr_begin_read_xn(sdr) == 0)
+	{
+		return 1;
+	}
+
+	oK(kill(getpid(), SIGKILL));
+	return 1;
+}
+
+int	main(int argc, char **argv)
+{
+	XnTask	reader1;
+	XnTask	reader2;
+	XnTask	reader3;
+	XnTask	updater;
+	pid_t	pid;
+	int	status;
+
+	if (argc > 1 && strcmp(argv[1], "-k") == 0)
+	{
+		return killedReader();
+	}
+
+	fail_unless(sdr_initialize(WM_SIZE, NULL, SM_NO_KEY, NULL) == 0);
+	fail_unless(loadProfile() == 0);
+	sdr = sdr_start_using(SDR_NAME);
+	fail_unless(sdr != NULL);
+
+	/*	Read-only transactions nest, and an update can't be
+	 *	started within one.					*/
+
+	fail_unless(sdr_begin_read_xn(sdr));
+	fail_unless(sdr_begin_read_xn(sdr));
+	fail_unless(sdr_begin_xn(sdr) == 0);
+	sdr_exit_xn(sdr);
+	sdr_exit_xn(sdr);
+	fail_unless(sdr_begin_xn(sdr));
+	sdr_exit_xn(sdr);
+
+	/*	A second reader begins while the first is reading.	*/
+
+	startXn(&reader1, 0);
+	fail_unless(began(&reader1, 5));
+	startXn(&reader2, 0);
+	fail_unless(began(&reader2, 5));
+
+	/*	An update waits for the readers to finish, and a new
+	 *	reader waits behind the update.				*/
+
+	startXn(&updater, 1);
+	fail_unless(!began(&updater, 1));
+	startXn(&reader3, 0);
+	fail_unless(!began(&reader3, 1));
+	endXn(&reader1);
+	fail_unless(!began(&updater, 1));
+	endXn(&reader2);
+	fail_unless(began(&updater, 5));
+	fail_unless(!began(&reader3, 1));
+	endXn(&updater);
+	fail_unless(began(&reader3, 5));
+	endXn(&reader3);
+
+	/*	A reader that is killed in mid-transaction leaves the
+	 *	SDR locked on behalf of readers.  Once the profile is
+	 *	re-loaded, as in crash recovery, updates can proceed
+	 *	and again exclude new readers.				*/
+
+	pid = fork();
+	fail_unless(pid >= 0);
+	if (pid == 0)
+	{
+		execl(argv[0], argv[0], "-k", NULL);
+		_exit(1);
+	}
+
+	fail_unless(waitpid(pid, &status, 0) == pid);
+	fail_unless(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+	fail_unless(loadProfile() == 0);
+	startXn(&updater, 1);
+	fail_unless(began(&updater, 5));
+	startXn(&reader1, 0);
+	fail_unless(!began(&reader1, 1));
+	endXn(&updater);
+	fail_unless(began(&reader1, 5));
+	endXn(&reader1);
+
+	writeErrmsgMemos();
+	sdr_destroy(sdr);
+	sdr_shutdown();
+	CHECK_FINISH;
+}